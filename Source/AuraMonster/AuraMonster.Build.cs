@@ -40,6 +40,8 @@ public class AuraMonster : ModuleRules
 			new string[]
 			{
 				// ... add private dependencies that you statically link with here ...	
+				"Json",
+				"Projects"
 			}
 		);
 		
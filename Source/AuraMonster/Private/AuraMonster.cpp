@@ -1,9 +1,38 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "AuraMonster.h"
+#include "AuraMonsterStats.h"
 
 #define LOCTEXT_NAMESPACE "FAuraMonsterModule"
 
+DEFINE_STAT(STAT_AuraMonster_BlueprintHookDispatches);
+DEFINE_STAT(STAT_AuraMonster_IdleBehavior);
+DEFINE_STAT(STAT_AuraMonster_PatrolStandingBehavior);
+DEFINE_STAT(STAT_AuraMonster_PatrolCrawlingBehavior);
+DEFINE_STAT(STAT_AuraMonster_ApplyIntents);
+DEFINE_STAT(STAT_AuraMonster_UpdateSurfaceTracking);
+DEFINE_STAT(STAT_AuraMonster_DetectSurface);
+DEFINE_STAT(STAT_AuraMonster_GetRandomSurfaceLocation);
+DEFINE_STAT(STAT_AuraMonster_MoveTowardsSurfaceLocation);
+DEFINE_STAT(STAT_AuraMonster_AlignToSurface);
+DEFINE_STAT(STAT_AuraMonster_PhysCrawl);
+DEFINE_STAT(STAT_AuraMonster_TickMonsters);
+DEFINE_STAT(STAT_AuraMonster_DecideInParallel);
+DEFINE_STAT(STAT_AuraMonster_ApplyUpdateBudget);
+DEFINE_STAT(STAT_AuraMonster_TickTimers);
+DEFINE_STAT(STAT_AuraMonster_UpdateLOD);
+DEFINE_STAT(STAT_AuraMonster_TickHorde);
+DEFINE_STAT(STAT_AuraMonster_SurfaceQueryBatch);
+DEFINE_STAT(STAT_AuraMonster_FindRandomPatrolPoint);
+DEFINE_STAT(STAT_AuraMonster_TracesDetectSurface);
+DEFINE_STAT(STAT_AuraMonster_TracesRandomSurfaceLocation);
+DEFINE_STAT(STAT_AuraMonster_TracesForward);
+DEFINE_STAT(STAT_AuraMonster_TracesCrawlSweeps);
+DEFINE_STAT(STAT_AuraMonster_TracesSurfacePath);
+DEFINE_STAT(STAT_AuraMonster_MonstersIdle);
+DEFINE_STAT(STAT_AuraMonster_MonstersPatrolStanding);
+DEFINE_STAT(STAT_AuraMonster_MonstersPatrolCrawling);
+
 void FAuraMonsterModule::StartupModule()
 {
 	// This code will execute after your module is loaded into memory; the exact timing is specified in the .uplugin file per-module
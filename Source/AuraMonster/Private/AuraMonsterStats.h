@@ -0,0 +1,63 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "Runtime/Launch/Resources/Version.h"
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 25
+#include "ProfilingDebugging/CpuProfilerTrace.h"
+#endif
+
+DECLARE_STATS_GROUP(TEXT("AuraMonster"), STATGROUP_AuraMonster, STATCAT_Advanced);
+
+/**
+ * Cycle counter in `stat AuraMonster`. From 4.25 the time also shows up in Unreal Insights captures: cycle
+ * counters emit their own trace events when stats are compiled in, and builds without stats (e.g. servers run
+ * with -trace=cpu) get a CPU profiler scope of the same name instead.
+ */
+#if STATS || !(ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 25)
+#define AURAMONSTER_SCOPE_CYCLE_COUNTER(Stat) SCOPE_CYCLE_COUNTER(Stat)
+#else
+#define AURAMONSTER_SCOPE_CYCLE_COUNTER(Stat) TRACE_CPUPROFILER_EVENT_SCOPE(Stat)
+#endif
+
+/** Monster AI hooks that still went through a Blueprint override this frame */
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Blueprint Hook Dispatches"), STAT_AuraMonster_BlueprintHookDispatches, STATGROUP_AuraMonster, );
+
+// Behaviors
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Idle Behavior"), STAT_AuraMonster_IdleBehavior, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Patrol Standing Behavior"), STAT_AuraMonster_PatrolStandingBehavior, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Patrol Crawling Behavior"), STAT_AuraMonster_PatrolCrawlingBehavior, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Apply Intents"), STAT_AuraMonster_ApplyIntents, STATGROUP_AuraMonster, );
+
+// Surface pathfinding
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Update Surface Tracking"), STAT_AuraMonster_UpdateSurfaceTracking, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Detect Surface"), STAT_AuraMonster_DetectSurface, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Get Random Surface Location"), STAT_AuraMonster_GetRandomSurfaceLocation, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Move Towards Surface Location"), STAT_AuraMonster_MoveTowardsSurfaceLocation, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Align To Surface"), STAT_AuraMonster_AlignToSurface, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Phys Crawl"), STAT_AuraMonster_PhysCrawl, STATGROUP_AuraMonster, );
+
+// Subsystems
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick Manager"), STAT_AuraMonster_TickMonsters, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick Manager Decisions"), STAT_AuraMonster_DecideInParallel, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Tick Manager Budget"), STAT_AuraMonster_ApplyUpdateBudget, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Timers"), STAT_AuraMonster_TickTimers, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("LOD"), STAT_AuraMonster_UpdateLOD, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Horde"), STAT_AuraMonster_TickHorde, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Surface Query Batch"), STAT_AuraMonster_SurfaceQueryBatch, STATGROUP_AuraMonster, );
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Find Random Patrol Point"), STAT_AuraMonster_FindRandomPatrolPoint, STATGROUP_AuraMonster, );
+
+// Traces issued this frame, by call site
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces: Detect Surface"), STAT_AuraMonster_TracesDetectSurface, STATGROUP_AuraMonster, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces: Random Surface Location"), STAT_AuraMonster_TracesRandomSurfaceLocation, STATGROUP_AuraMonster, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces: Forward"), STAT_AuraMonster_TracesForward, STATGROUP_AuraMonster, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces: Crawl Surface Sweeps"), STAT_AuraMonster_TracesCrawlSweeps, STATGROUP_AuraMonster, );
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Traces: Surface Path Sweeps"), STAT_AuraMonster_TracesSurfacePath, STATGROUP_AuraMonster, );
+
+// Monsters in each behavior state
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Monsters Idle"), STAT_AuraMonster_MonstersIdle, STATGROUP_AuraMonster, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Monsters Patrol Standing"), STAT_AuraMonster_MonstersPatrolStanding, STATGROUP_AuraMonster, );
+DECLARE_DWORD_ACCUMULATOR_STAT_EXTERN(TEXT("Monsters Patrol Crawling"), STAT_AuraMonster_MonstersPatrolCrawling, STATGROUP_AuraMonster, );
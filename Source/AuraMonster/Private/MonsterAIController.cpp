@@ -3,6 +3,12 @@
 #include "MonsterAIController.h"
 #include "MonsterCharacter.h"
 #include "SurfacePathfindingComponent.h"
+#include "MonsterTickManager.h"
+#include "MonsterTimerSubsystem.h"
+#include "MonsterPatrolPointSubsystem.h"
+#include "MonsterBudgetSubsystem.h"
+#include "MonsterAnimInstance.h"
+#include "AuraMonsterStats.h"
 #include "Navigation/PathFollowingComponent.h"
 #include "NavigationSystem.h"
 
@@ -25,185 +31,806 @@ AMonsterAIController::AMonsterAIController()
 	MinStopDuration = 2.0f;
 	MaxStopDuration = 5.0f;
 	PatrolAcceptanceRadius = 100.0f;
+	CrawlSearchRetryDelay = 0.25f;
+	MaxCrawlSearchRetryDelay = 4.0f;
+	CrawlSearchRetryJitter = 0.5f;
+	MaxCrawlSearchFailures = 6;
 
-	// Initialize timing variables
-	CurrentIdleTime = 0.0f;
-	TargetIdleDuration = FMath::RandRange(MinIdleDuration, MaxIdleDuration);
-	TimeSinceLastSubtleMovement = 0.0f;
-	NextSubtleMovementTime = 0.0f;
-	BreathingCycleTime = 0.0f;
-	
-	// Initialize patrol variables
-	CurrentStopTime = 0.0f;
-	TargetStopDuration = 0.0f;
-	bIsStoppedAtDestination = false;
-	
-	// Initialize crawling variables
-	CrawlingTargetLocation = FVector::ZeroVector;
-	bHasCrawlingTarget = false;
-	PreviousCrawlingLocation = FVector::ZeroVector;
-	StuckTime = 0.0f;
+	bUseMonsterTickManager = false;
+	bUseScheduledTimers = false;
+
+	// Initialize timing variables (the rest of the runtime state starts zeroed); drawn from the monster's stream on entering Idle
+	RuntimeState.TargetIdleDuration = MaxIdleDuration;
+	TickManager = nullptr;
+	TickManagerSlot = INDEX_NONE;
+	bIsTickManaged = false;
+	bIdleBehaviorInScript = true;
+	bPatrolStandingBehaviorInScript = true;
+	bPatrolCrawlingBehaviorInScript = true;
+	bOnEnterStateInScript = true;
+	bOnExitStateInScript = true;
+	bScheduledTimersInEffect = false;
+	bPatrolStandingEventDriven = false;
+	bWaitingWhileMoving = false;
+	TimerSubsystem = nullptr;
+	ScheduledTimersSyncTime = 0.0f;
+	PublishedBreathingCycleDuration = 0.0f;
+	PatrolPathQueryId = 0;
+	PrefetchedPatrolDestination = FVector::ZeroVector;
 	
 	// Initialize cached references
 	CachedNavSystem = nullptr;
+	PatrolPointSubsystem = nullptr;
+	BudgetSubsystem = nullptr;
+	DeferredBehaviorTime = 0.0f;
 	CachedPathFollowingComp = nullptr;
 }
 
-void AMonsterAIController::BeginPlay()
+void AMonsterAIController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	CacheScriptOverriddenHooks();
+
+	// Cache reference to the controlled monster
+	ControlledMonster = Cast<AMonsterCharacter>(GetPawn());
+	
+	// Cache navigation system reference
+	CachedNavSystem = UNavigationSystemV1::GetNavigationSystem(GetWorld());
+
+	// Cache the shared pool of patrol destinations
+	PatrolPointSubsystem = GetWorld()->GetSubsystem<UMonsterPatrolPointSubsystem>();
+	BudgetSubsystem = GetWorld()->GetSubsystem<UMonsterBudgetSubsystem>();
+	
+	// Cache path following component reference
+	CachedPathFollowingComp = GetPathFollowingComponent();
+	
+	// Initialize NextSubtleMovementTime to prevent immediate trigger on first frame
+	RuntimeState.NextSubtleMovementTime = GetValidatedRandomRange(MinSubtleMovementInterval, MaxSubtleMovementInterval);
+	RuntimeState.BehaviorState = CurrentState;
+	
+	// Initialize with current state (respects pre-configured state from editor)
+	if (ControlledMonster)
+	{
+		InitializeControlledMonster();
+	}
+}
+
+void AMonsterAIController::OnPossess(APawn* InPawn)
+{
+	Super::OnPossess(InPawn);
+
+	// Pawns spawned at runtime are possessed after our BeginPlay, so set them up here
+	if (HasActorBegunPlay() && !ControlledMonster)
+	{
+		ControlledMonster = Cast<AMonsterCharacter>(InPawn);
+		if (ControlledMonster)
+		{
+			InitializeControlledMonster();
+		}
+	}
+}
+
+void AMonsterAIController::InitializeControlledMonster()
+{
+	// Use internal method to set character state without triggering AI Controller sync
+	// This avoids unnecessary circular logic during initialization
+	ControlledMonster->SetBehaviorStateInternal(CurrentState);
+	
+	// Initialize state-specific variables by calling OnEnterState
+	CallOnEnterState(CurrentState);
+	PublishBreathingCycle();
+
+	// Hand ticking over to the tick manager once the monster is fully set up
+	if (bUseMonsterTickManager)
+	{
+		if (UMonsterTickManager* Manager = GetWorld()->GetSubsystem<UMonsterTickManager>())
+		{
+			bIsTickManaged = Manager->RegisterMonster(this);
+		}
+	}
+
+	// Overridden behaviors may use the timers differently, so only the native ones can sleep between them
+	bScheduledTimersInEffect = bUseScheduledTimers && CanBatchBehaviorTimers();
+	bPatrolStandingEventDriven = CanDrivePatrolStandingByEvents();
+	if (bScheduledTimersInEffect || bPatrolStandingEventDriven)
+	{
+		TimerSubsystem = GetWorld()->GetSubsystem<UMonsterTimerSubsystem>();
+		UpdateScheduledWait();
+	}
+}
+
+void AMonsterAIController::RestoreRuntimeState(EMonsterBehaviorState State, const FMonsterAIRuntimeState& InRuntimeState)
+{
+	TransitionToState(State);
+	StopScheduledWait();
+
+	// Keep how the timers are driven, take everything else
+	FMonsterAIRuntimeState& RuntimeStateRef = GetRuntimeState();
+	const bool bAdvanceTimersInBatch = RuntimeStateRef.bAdvanceTimersInBatch;
+	RuntimeStateRef = InRuntimeState;
+	RuntimeStateRef.BehaviorState = State;
+	RuntimeStateRef.bAdvanceTimersInBatch = bAdvanceTimersInBatch;
+	RuntimeStateRef.bWaitingForScheduledWake = false;
+
+	PublishBreathingCycle();
+	UpdateScheduledWait();
+}
+
+void AMonsterAIController::PublishBreathingCycle()
+{
+	UMonsterAnimInstance* AnimInstance = ControlledMonster ? ControlledMonster->GetMonsterAnimInstance() : nullptr;
+	if (AnimInstance)
+	{
+		AnimInstance->SetBreathingCycle(GetRuntimeState().BreathingCycleTime, BreathingCycleDuration, CurrentState == EMonsterBehaviorState::Idle);
+		PublishedBreathingCycleDuration = BreathingCycleDuration;
+	}
+}
+
+void AMonsterAIController::SetBehaviorTickInterval(float TickInterval)
+{
+	SetActorTickInterval(TickInterval);
+
+	if (TickManager)
+	{
+		TickManager->SetMonsterTickInterval(this, TickInterval);
+	}
+}
+
+void AMonsterAIController::SetPatrolTransitionChance(float Chance)
+{
+	PatrolTransitionChance = FMath::Clamp(Chance, 0.0f, 1.0f);
+}
+
+void AMonsterAIController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	CancelPatrolPathPrefetch();
+
+	if (TimerSubsystem)
+	{
+		TimerSubsystem->CancelWake(ScheduledWakeHandle);
+	}
+
+	if (TickManager)
+	{
+		TickManager->UnregisterMonster(this);
+	}
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AMonsterAIController::Tick(float DeltaTime)
+{
+	// Faces the focus, e.g. the path being followed
+	Super::Tick(DeltaTime);
+
+	// Walking a standing patrol move asleep: the move and path events wake the behavior
+	if (bWaitingWhileMoving)
+	{
+		return;
+	}
+
+	if (!BudgetSubsystem)
+	{
+		TickBehavior(DeltaTime);
+		UpdateScheduledWait();
+		return;
+	}
+
+	// Over the frame's AI budget, monsters that are far away and not in trouble catch up on a later frame
+	const float BehaviorDeltaTime = DeltaTime + DeferredBehaviorTime;
+	if (BudgetSubsystem->IsTimeBudgetSpent())
+	{
+		const FVector Location = ControlledMonster ? ControlledMonster->GetActorLocation() : FVector::ZeroVector;
+		if (BudgetSubsystem->ShouldDeferUpdate(BudgetSubsystem->GetUpdatePriority(Location, DeferredBehaviorTime, GetRuntimeState().StuckTime > 0.0f)))
+		{
+			DeferredBehaviorTime = BehaviorDeltaTime;
+			return;
+		}
+	}
+	DeferredBehaviorTime = 0.0f;
+
+	const double StartTime = FPlatformTime::Seconds();
+	TickBehavior(BehaviorDeltaTime);
+	UpdateScheduledWait();
+	BudgetSubsystem->ReportTime(FPlatformTime::Seconds() - StartTime);
+}
+
+void AMonsterAIController::OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result)
+{
+	Super::OnMoveCompleted(RequestID, Result);
+
+	// Only the event-driven standing patrol sleeps through its moves; a move replaced by the next one is no news
+	if (!IsPatrolStandingEventDriven() || !GetRuntimeState().bWaitingForScheduledWake || Result.HasFlag(FPathFollowingResultFlags::NewRequest))
+	{
+		return;
+	}
+
+	if (Result.IsSuccess())
+	{
+		// Reached the destination, which the polling patrol noticed through DidMoveReachGoal
+		StopScheduledWait();
+
+		FMonsterAIIntentQueue Intents;
+		DecidePatrolStop(GetRuntimeState(), Intents);
+		ApplyIntents(Intents.GetData(), Intents.Num(), CurrentState, 0.0f);
+		UpdateScheduledWait();
+	}
+	else
+	{
+		// Blocked, off the path or aborted: path following is idle again, so the behavior picks a new destination
+		WakeBehavior();
+	}
+}
+
+FMonsterAIRuntimeState& AMonsterAIController::GetRuntimeState()
+{
+	return (TickManager && TickManagerSlot != INDEX_NONE) ? TickManager->GetRuntimeState(TickManagerSlot) : RuntimeState;
+}
+
+void AMonsterAIController::TickManaged(float DeltaTime)
+{
+	// What AAIController::Tick would do: face the focus (e.g. the path being followed)
+	UpdateControlRotation(DeltaTime);
+
+	// Overridden behaviors advance their own timers
+	FMonsterAIRuntimeState& State = GetRuntimeState();
+	if (!State.bAdvanceTimersInBatch)
+	{
+		TickBehavior(DeltaTime);
+		UpdateScheduledWait();
+		return;
+	}
+
+	// The manager already advanced the timers; a monster waiting out a patrol stop has nothing else to do
+	if (!State.NeedsBehaviorUpdate())
+	{
+		UpdateScheduledWait();
+		return;
+	}
+
+	switch (CurrentState)
+	{
+		case EMonsterBehaviorState::Idle:
+		{
+			AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_IdleBehavior);
+			UpdateIdleBehavior(DeltaTime);
+			break;
+		}
+
+		case EMonsterBehaviorState::PatrolStanding:
+		{
+			AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_PatrolStandingBehavior);
+			UpdatePatrolStandingBehavior(DeltaTime);
+			break;
+		}
+
+		case EMonsterBehaviorState::PatrolCrawling:
+		{
+			AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_PatrolCrawlingBehavior);
+			UpdatePatrolCrawlingBehavior(DeltaTime);
+			break;
+		}
+	}
+
+	UpdateScheduledWait();
+}
+
+void AMonsterAIController::TickManagedWaiting(float DeltaTime)
+{
+	if (bWaitingWhileMoving)
+	{
+		UpdateControlRotation(DeltaTime);
+	}
+}
+
+void AMonsterAIController::TickManagedDecided(const FMonsterAIIntent* Intents, int32 NumIntents, EMonsterBehaviorState DecidedState, float DeltaTime)
+{
+	UpdateControlRotation(DeltaTime);
+	ApplyIntents(Intents, NumIntents, DecidedState, DeltaTime);
+	UpdateScheduledWait();
+}
+
+bool AMonsterAIController::CanBatchBehaviorTimers() const
+{
+	// C++ subclasses may override the behaviors
+	const UClass* NativeClass = GetClass();
+	while (NativeClass && !NativeClass->HasAnyClassFlags(CLASS_Native))
+	{
+		NativeClass = NativeClass->GetSuperClass();
+	}
+	if (NativeClass != AMonsterAIController::StaticClass())
+	{
+		return false;
+	}
+
+	// And so may Blueprint subclasses (looked up in BeginPlay)
+	return !bIdleBehaviorInScript && !bPatrolStandingBehaviorInScript && !bPatrolCrawlingBehaviorInScript;
+}
+
+bool AMonsterAIController::CanDrivePatrolStandingByEvents() const
+{
+	const UClass* NativeClass = GetClass();
+	while (NativeClass && !NativeClass->HasAnyClassFlags(CLASS_Native))
+	{
+		NativeClass = NativeClass->GetSuperClass();
+	}
+	if (NativeClass != AMonsterAIController::StaticClass() || bPatrolStandingBehaviorInScript)
+	{
+		return false;
+	}
+
+	// Sleeping turns our tick off
+	static const FName ReceiveTickName(TEXT("ReceiveTick"));
+	return bIsTickManaged || !GetClass()->IsFunctionImplementedInScript(ReceiveTickName);
+}
+
+void AMonsterAIController::TickBehavior(float DeltaTime)
+{
+	// Execute behavior based on current state
+	switch (CurrentState)
+	{
+		case EMonsterBehaviorState::Idle:
+		{
+			AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_IdleBehavior);
+			if (bIdleBehaviorInScript)
+			{
+				INC_DWORD_STAT(STAT_AuraMonster_BlueprintHookDispatches);
+				ExecuteIdleBehavior(DeltaTime);
+			}
+			else
+			{
+				ExecuteIdleBehavior_Implementation(DeltaTime);
+			}
+			break;
+		}
+
+		case EMonsterBehaviorState::PatrolStanding:
+		{
+			AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_PatrolStandingBehavior);
+			if (bPatrolStandingBehaviorInScript)
+			{
+				INC_DWORD_STAT(STAT_AuraMonster_BlueprintHookDispatches);
+				ExecutePatrolStandingBehavior(DeltaTime);
+			}
+			else
+			{
+				ExecutePatrolStandingBehavior_Implementation(DeltaTime);
+			}
+			break;
+		}
+
+		case EMonsterBehaviorState::PatrolCrawling:
+		{
+			AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_PatrolCrawlingBehavior);
+			if (bPatrolCrawlingBehaviorInScript)
+			{
+				INC_DWORD_STAT(STAT_AuraMonster_BlueprintHookDispatches);
+				ExecutePatrolCrawlingBehavior(DeltaTime);
+			}
+			else
+			{
+				ExecutePatrolCrawlingBehavior_Implementation(DeltaTime);
+			}
+			break;
+		}
+	}
+}
+
+void AMonsterAIController::CacheScriptOverriddenHooks()
+{
+	const UClass* Class = GetClass();
+	bIdleBehaviorInScript = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AMonsterAIController, ExecuteIdleBehavior));
+	bPatrolStandingBehaviorInScript = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AMonsterAIController, ExecutePatrolStandingBehavior));
+	bPatrolCrawlingBehaviorInScript = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AMonsterAIController, ExecutePatrolCrawlingBehavior));
+	bOnEnterStateInScript = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AMonsterAIController, OnEnterState));
+	bOnExitStateInScript = Class->IsFunctionImplementedInScript(GET_FUNCTION_NAME_CHECKED(AMonsterAIController, OnExitState));
+}
+
+void AMonsterAIController::CallOnEnterState(EMonsterBehaviorState NewState)
+{
+	if (bOnEnterStateInScript)
+	{
+		INC_DWORD_STAT(STAT_AuraMonster_BlueprintHookDispatches);
+		OnEnterState(NewState);
+	}
+	else
+	{
+		OnEnterState_Implementation(NewState);
+	}
+}
+
+void AMonsterAIController::CallOnExitState(EMonsterBehaviorState OldState)
+{
+	if (bOnExitStateInScript)
+	{
+		INC_DWORD_STAT(STAT_AuraMonster_BlueprintHookDispatches);
+		OnExitState(OldState);
+	}
+	else
+	{
+		OnExitState_Implementation(OldState);
+	}
+}
+
+void AMonsterAIController::TransitionToState(EMonsterBehaviorState NewState)
+{
+	if (CurrentState != NewState)
+	{
+		// Wake up if asleep; the new state decides whether to sleep again
+		StopScheduledWait();
+
+		// A prefetched patrol path is only any use while patrolling on foot
+		CancelPatrolPathPrefetch();
+
+		// Exit old state
+		CallOnExitState(CurrentState);
+
+		EMonsterBehaviorState OldState = CurrentState;
+		CurrentState = NewState;
+		GetRuntimeState().BehaviorState = NewState;
+
+		// Update monster character's state using internal method to avoid circular synchronization
+		if (ControlledMonster)
+		{
+			ControlledMonster->SetBehaviorStateInternal(NewState);
+		}
+
+		// Enter new state
+		CallOnEnterState(NewState);
+		PublishBreathingCycle();
+		UpdateScheduledWait();
+	}
+}
+
+void AMonsterAIController::UpdateScheduledWait()
+{
+	if (!TimerSubsystem)
+	{
+		return;
+	}
+
+	// Reschedule from up-to-date timers
+	StopScheduledWait();
+
+	const bool bPatrolStandingEvents = IsPatrolStandingEventDriven();
+	if (!bScheduledTimersInEffect && !bPatrolStandingEvents)
+	{
+		return;
+	}
+
+	// Idling and patrol stops are pure waiting, and so is walking a standing patrol when its events wake it;
+	// crawling needs per-frame updates
+	FMonsterAIRuntimeState& State = GetRuntimeState();
+	float Delay = -1.0f;
+	bool bIsMoving = false;
+	if (CurrentState == EMonsterBehaviorState::Idle)
+	{
+		Delay = FMath::Min(State.TargetIdleDuration - State.CurrentIdleTime, State.NextSubtleMovementTime - State.TimeSinceLastSubtleMovement);
+	}
+	else if (State.bIsStoppedAtDestination)
+	{
+		Delay = State.TargetStopDuration - State.CurrentStopTime;
+	}
+	else if (bPatrolStandingEvents)
+	{
+		// OnMoveCompleted ends a move (also a paused or waiting one) and OnPatrolPathFound a path query.
+		// With neither under way, e.g. no destination was found, look again on the next wheel tick
+		bIsMoving = CachedPathFollowingComp && CachedPathFollowingComp->GetStatus() != EPathFollowingStatus::Idle;
+		if (!bIsMoving && PatrolPathQueryId == 0)
+		{
+			Delay = 0.0f;
+		}
+	}
+	else
+	{
+		return;
+	}
+
+	if (Delay >= 0.0f)
+	{
+		ScheduledWakeHandle = TimerSubsystem->ScheduleWake(this, Delay);
+	}
+	ScheduledTimersSyncTime = GetWorld()->GetTimeSeconds();
+	State.bWaitingForScheduledWake = true;
+
+	// Sleep fully only while standing still; a walking pawn still has to turn towards its path
+	bWaitingWhileMoving = bIsMoving;
+	if (!bIsTickManaged && !bWaitingWhileMoving)
+	{
+		SetActorTickEnabled(false);
+	}
+}
+
+void AMonsterAIController::StopScheduledWait()
+{
+	FMonsterAIRuntimeState& State = GetRuntimeState();
+	if (!State.bWaitingForScheduledWake)
+	{
+		return;
+	}
+
+	SyncScheduledTimers();
+	State.bWaitingForScheduledWake = false;
+	bWaitingWhileMoving = false;
+
+	if (TimerSubsystem)
+	{
+		TimerSubsystem->CancelWake(ScheduledWakeHandle);
+	}
+
+	if (!bIsTickManaged)
+	{
+		SetActorTickEnabled(true);
+	}
+}
+
+void AMonsterAIController::SyncScheduledTimers()
+{
+	FMonsterAIRuntimeState& State = GetRuntimeState();
+	if (!State.bWaitingForScheduledWake)
+	{
+		return;
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	const float Elapsed = Now - ScheduledTimersSyncTime;
+	ScheduledTimersSyncTime = Now;
+
+	State.AdvanceTimers(Elapsed);
+	if (CurrentState == EMonsterBehaviorState::Idle && BreathingCycleDuration > 0.0f)
+	{
+		State.BreathingCycleTime = FMath::Fmod(State.BreathingCycleTime + Elapsed, BreathingCycleDuration);
+	}
+}
+
+void AMonsterAIController::OnScheduledWake(const FMonsterTimerHandle& Handle)
+{
+	// A wake cancelled after it was already collected for firing
+	if (Handle != ScheduledWakeHandle)
+	{
+		return;
+	}
+
+	ScheduledWakeHandle.Invalidate();
+	WakeBehavior();
+}
+
+void AMonsterAIController::WakeBehavior()
+{
+	StopScheduledWait();
+
+	// The timers are up to date, so the behavior only has to act on whichever ran out, or on the event that woke it
+	TickBehavior(0.0f);
+	UpdateScheduledWait();
+}
+
+float AMonsterAIController::GetBreathingIntensity()
+{
+	if (BreathingCycleDuration <= 0.0f)
+	{
+		return 0.0f;
+	}
+
+	if (UMonsterAnimInstance* AnimInstance = ControlledMonster ? ControlledMonster->GetMonsterAnimInstance() : nullptr)
+	{
+		return AnimInstance->GetBreathingIntensity();
+	}
+
+	// While asleep the breathing cycle is only advanced on waking, so add the time asleep so far
+	const FMonsterAIRuntimeState& State = GetRuntimeState();
+	float CycleTime = State.BreathingCycleTime;
+	if (State.bWaitingForScheduledWake)
+	{
+		CycleTime += GetWorld()->GetTimeSeconds() - ScheduledTimersSyncTime;
+	}
+
+	const float NormalizedTime = FMath::Fmod(CycleTime, BreathingCycleDuration) / BreathingCycleDuration;
+	return (FMath::Sin(NormalizedTime * 2.0f * PI) + 1.0f) * 0.5f;
+}
+
+void AMonsterAIController::ExecuteIdleBehavior_Implementation(float DeltaTime)
+{
+	if (!ControlledMonster)
+	{
+		return;
+	}
+
+	// Update idle time and subtle movement timer
+	GetRuntimeState().AdvanceIdleTimers(DeltaTime);
+
+	UpdateIdleBehavior(DeltaTime);
+}
+
+void AMonsterAIController::UpdateIdleBehavior(float DeltaTime)
+{
+	if (!ControlledMonster)
+	{
+		return;
+	}
+
+	FMonsterAIDecisionInput Input;
+	GatherDecisionInput(Input);
+
+	FMonsterAIIntentQueue Intents;
+	DecideIdleBehavior(Input, DeltaTime, GetRuntimeState(), Intents);
+	ApplyIntents(Intents.GetData(), Intents.Num(), CurrentState, DeltaTime);
+}
+
+void AMonsterAIController::ExecutePatrolStandingBehavior_Implementation(float DeltaTime)
+{
+	if (!ControlledMonster)
+	{
+		return;
+	}
+
+	GetRuntimeState().AdvanceStopTimer(DeltaTime);
+
+	UpdatePatrolStandingBehavior(DeltaTime);
+}
+
+void AMonsterAIController::UpdatePatrolStandingBehavior(float DeltaTime)
 {
-	Super::BeginPlay();
+	if (!ControlledMonster)
+	{
+		return;
+	}
 
-	// Cache reference to the controlled monster
-	ControlledMonster = Cast<AMonsterCharacter>(GetPawn());
-	
-	// Cache navigation system reference
-	CachedNavSystem = UNavigationSystemV1::GetNavigationSystem(GetWorld());
-	
-	// Cache path following component reference
-	CachedPathFollowingComp = GetPathFollowingComponent();
-	
-	// Initialize NextSubtleMovementTime to prevent immediate trigger on first frame
-	NextSubtleMovementTime = GetValidatedRandomRange(MinSubtleMovementInterval, MaxSubtleMovementInterval);
-	
-	// Initialize with current state (respects pre-configured state from editor)
-	if (ControlledMonster)
+	FMonsterAIDecisionInput Input;
+	GatherDecisionInput(Input);
+
+	FMonsterAIIntentQueue Intents;
+	DecidePatrolStandingBehavior(Input, DeltaTime, GetRuntimeState(), Intents);
+	ApplyIntents(Intents.GetData(), Intents.Num(), CurrentState, DeltaTime);
+}
+
+void AMonsterAIController::ExecutePatrolCrawlingBehavior_Implementation(float DeltaTime)
+{
+	if (!ControlledMonster)
 	{
-		// Use internal method to set character state without triggering AI Controller sync
-		// This avoids unnecessary circular logic during initialization
-		ControlledMonster->SetBehaviorStateInternal(CurrentState);
-		
-		// Initialize state-specific variables by calling OnEnterState
-		OnEnterState(CurrentState);
+		return;
 	}
+
+	GetRuntimeState().AdvanceStopTimer(DeltaTime);
+
+	UpdatePatrolCrawlingBehavior(DeltaTime);
 }
 
-void AMonsterAIController::Tick(float DeltaTime)
+void AMonsterAIController::UpdatePatrolCrawlingBehavior(float DeltaTime)
 {
-	Super::Tick(DeltaTime);
+	if (!ControlledMonster)
+	{
+		return;
+	}
 
-	// Execute behavior based on current state
+	FMonsterAIDecisionInput Input;
+	GatherDecisionInput(Input);
+
+	FMonsterAIIntentQueue Intents;
+	DecidePatrolCrawlingBehavior(Input, DeltaTime, GetRuntimeState(), Intents);
+	ApplyIntents(Intents.GetData(), Intents.Num(), CurrentState, DeltaTime);
+}
+
+void AMonsterAIController::GatherDecisionInput(FMonsterAIDecisionInput& OutInput) const
+{
+	if (!ControlledMonster)
+	{
+		return;
+	}
+
+	// Only read what the current state's decision needs
 	switch (CurrentState)
 	{
 		case EMonsterBehaviorState::Idle:
-			ExecuteIdleBehavior(DeltaTime);
+			OutInput.bHasAnimInstance = ControlledMonster->GetMonsterAnimInstance() != nullptr;
 			break;
 
 		case EMonsterBehaviorState::PatrolStanding:
-			ExecutePatrolStandingBehavior(DeltaTime);
+			OutInput.bHasPathFollowing = CachedPathFollowingComp != nullptr;
+			if (CachedPathFollowingComp)
+			{
+				OutInput.PathFollowingStatus = CachedPathFollowingComp->GetStatus();
+
+				// Only check DidMoveReachGoal if currently moving
+				OutInput.bDidMoveReachGoal = OutInput.PathFollowingStatus == EPathFollowingStatus::Moving && CachedPathFollowingComp->DidMoveReachGoal();
+			}
 			break;
 
 		case EMonsterBehaviorState::PatrolCrawling:
-			ExecutePatrolCrawlingBehavior(DeltaTime);
+			OutInput.Location = ControlledMonster->GetActorLocation();
+			OutInput.bHasSurfacePathfinding = ControlledMonster->GetSurfacePathfinding() != nullptr;
 			break;
 	}
 }
 
-void AMonsterAIController::TransitionToState(EMonsterBehaviorState NewState)
+void AMonsterAIController::DecideBehavior(const FMonsterAIDecisionInput& Input, float DeltaTime, FMonsterAIRuntimeState& State, FMonsterAIIntentQueue& OutIntents)
 {
-	if (CurrentState != NewState)
+	switch (CurrentState)
 	{
-		// Exit old state
-		OnExitState(CurrentState);
-
-		EMonsterBehaviorState OldState = CurrentState;
-		CurrentState = NewState;
+		case EMonsterBehaviorState::Idle:
+			DecideIdleBehavior(Input, DeltaTime, State, OutIntents);
+			break;
 
-		// Update monster character's state using internal method to avoid circular synchronization
-		if (ControlledMonster)
-		{
-			ControlledMonster->SetBehaviorStateInternal(NewState);
-		}
+		case EMonsterBehaviorState::PatrolStanding:
+			DecidePatrolStandingBehavior(Input, DeltaTime, State, OutIntents);
+			break;
 
-		// Enter new state
-		OnEnterState(NewState);
+		case EMonsterBehaviorState::PatrolCrawling:
+			DecidePatrolCrawlingBehavior(Input, DeltaTime, State, OutIntents);
+			break;
 	}
 }
 
-void AMonsterAIController::ExecuteIdleBehavior_Implementation(float DeltaTime)
+void AMonsterAIController::DecideIdleBehavior(const FMonsterAIDecisionInput& Input, float DeltaTime, FMonsterAIRuntimeState& State, FMonsterAIIntentQueue& OutIntents)
 {
-	if (!ControlledMonster)
-	{
-		return;
-	}
-
-	// Update idle time
-	CurrentIdleTime += DeltaTime;
-
 	// Update breathing cycle - only if BreathingCycleDuration is valid
 	if (BreathingCycleDuration > 0.0f)
 	{
-		BreathingCycleTime += DeltaTime;
-		BreathingCycleTime = FMath::Fmod(BreathingCycleTime, BreathingCycleDuration);
-
-		// Calculate breathing intensity (sine wave for smooth breathing)
-		// Multiply by 2*PI to convert normalized time (0-1) to radians for full sine wave cycle
-		const float NormalizedTime = BreathingCycleTime / BreathingCycleDuration;
-		float BreathingIntensity = (FMath::Sin(NormalizedTime * 2.0f * PI) + 1.0f) * 0.5f;
-		ControlledMonster->OnBreathingUpdate(BreathingIntensity);
-	}
+		State.BreathingCycleTime += DeltaTime;
+		State.BreathingCycleTime = FMath::Fmod(State.BreathingCycleTime, BreathingCycleDuration);
 
-	// Handle subtle random movements
-	TimeSinceLastSubtleMovement += DeltaTime;
-	if (TimeSinceLastSubtleMovement >= NextSubtleMovementTime)
-	{
-		// Trigger a random subtle movement
-		float RandomValue = FMath::FRand();
-		if (RandomValue < 0.5f)
+		// A UMonsterAnimInstance evaluates breathing on the animation thread; it only needs to hear about a new period
+		if (Input.bHasAnimInstance)
 		{
-			// Neck twitch
-			ControlledMonster->OnNeckTwitch();
+			if (BreathingCycleDuration != PublishedBreathingCycleDuration)
+			{
+				OutIntents.Emplace(EMonsterAIIntentType::PublishBreathingCycle);
+			}
 		}
 		else
 		{
-			// Finger shift
-			ControlledMonster->OnFingerShift();
+			// Calculate breathing intensity (sine wave for smooth breathing)
+			// Multiply by 2*PI to convert normalized time (0-1) to radians for full sine wave cycle
+			const float NormalizedTime = State.BreathingCycleTime / BreathingCycleDuration;
+			float BreathingIntensity = (FMath::Sin(NormalizedTime * 2.0f * PI) + 1.0f) * 0.5f;
+			OutIntents.Emplace(EMonsterAIIntentType::BreathingUpdate, EMonsterBehaviorState::Idle, BreathingIntensity);
 		}
+	}
+
+	// Handle subtle random movements
+	if (State.TimeSinceLastSubtleMovement >= State.NextSubtleMovementTime)
+	{
+		// Trigger a random subtle movement: neck twitch or finger shift
+		OutIntents.Emplace(GetRandomStream().FRand() < 0.5f ? EMonsterAIIntentType::NeckTwitch : EMonsterAIIntentType::FingerShift);
 
 		// Reset timer and set next movement time
-		TimeSinceLastSubtleMovement = 0.0f;
-		NextSubtleMovementTime = GetValidatedRandomRange(MinSubtleMovementInterval, MaxSubtleMovementInterval);
+		State.TimeSinceLastSubtleMovement = 0.0f;
+		State.NextSubtleMovementTime = GetValidatedRandomRange(MinSubtleMovementInterval, MaxSubtleMovementInterval);
 	}
 
 	// Check if should transition to patrol
-	if (CurrentIdleTime >= TargetIdleDuration)
+	if (State.CurrentIdleTime >= State.TargetIdleDuration)
 	{
 		// Decide whether to patrol or stay idle
-		float RandomValue = FMath::FRand();
+		float RandomValue = GetRandomStream().FRand();
 		if (RandomValue < PatrolTransitionChance)
 		{
 			// Randomly choose between standing and crawling patrol
-			EMonsterBehaviorState NewState = (FMath::FRand() < 0.5f) 
-				? EMonsterBehaviorState::PatrolStanding 
+			EMonsterBehaviorState NewState = (GetRandomStream().FRand() < 0.5f)
+				? EMonsterBehaviorState::PatrolStanding
 				: EMonsterBehaviorState::PatrolCrawling;
-			TransitionToState(NewState);
+			OutIntents.Emplace(EMonsterAIIntentType::TransitionToState, NewState);
 		}
 		else
 		{
 			// Stay idle but reset the idle duration
-			CurrentIdleTime = 0.0f;
-			TargetIdleDuration = GetValidatedRandomRange(MinIdleDuration, MaxIdleDuration);
+			State.CurrentIdleTime = 0.0f;
+			State.TargetIdleDuration = GetValidatedRandomRange(MinIdleDuration, MaxIdleDuration);
 		}
 	}
 }
 
-void AMonsterAIController::ExecutePatrolStandingBehavior_Implementation(float DeltaTime)
+void AMonsterAIController::DecidePatrolStandingBehavior(const FMonsterAIDecisionInput& Input, float DeltaTime, FMonsterAIRuntimeState& State, FMonsterAIIntentQueue& OutIntents)
 {
-	if (!ControlledMonster)
-	{
-		return;
-	}
-
 	// Check if we're currently stopped at a destination to listen/look around
-	if (bIsStoppedAtDestination)
+	if (State.bIsStoppedAtDestination)
 	{
-		CurrentStopTime += DeltaTime;
-		
 		// Check if we've waited long enough
-		if (CurrentStopTime >= TargetStopDuration)
+		if (State.CurrentStopTime >= State.TargetStopDuration)
 		{
 			// Done stopping, ready to move to next destination
-			bIsStoppedAtDestination = false;
-			CurrentStopTime = 0.0f;
+			State.bIsStoppedAtDestination = false;
+			State.CurrentStopTime = 0.0f;
 			// Fall through to select new destination
 		}
 		else
@@ -213,101 +840,64 @@ void AMonsterAIController::ExecutePatrolStandingBehavior_Implementation(float De
 		}
 	}
 
-	// Check if we're currently moving to a destination using cached component
-	if (CachedPathFollowingComp)
+	// Check if we're currently moving to a destination
+	if (Input.bHasPathFollowing)
 	{
-		// Check current path following status
-		EPathFollowingStatus::Type Status = CachedPathFollowingComp->GetStatus();
-
-		// Only check DidMoveReachGoal if currently moving
-		if (Status == EPathFollowingStatus::Moving)
+		if (Input.PathFollowingStatus == EPathFollowingStatus::Moving)
 		{
 			// Check if we've reached the current destination
-			if (CachedPathFollowingComp->DidMoveReachGoal())
+			if (Input.bDidMoveReachGoal)
 			{
-				// We've reached destination, now stop to listen/look around
-				bIsStoppedAtDestination = true;
-				CurrentStopTime = 0.0f;
-				TargetStopDuration = GetValidatedRandomRange(MinStopDuration, MaxStopDuration);
-				
-				// Stop movement
-				StopMovement();
-				return;
+				DecidePatrolStop(State, OutIntents);
 			}
 
 			// Still moving to current destination, continue
 			return;
 		}
-		
+
 		// If the status is not Idle, do not select a new destination
 		// This prevents rapid destination changes during transient states
-		if (Status != EPathFollowingStatus::Idle)
+		if (Input.PathFollowingStatus != EPathFollowingStatus::Idle)
 		{
 			// For Paused, Waiting, Aborting, etc. - wait for status to settle
 			return;
 		}
 	}
 
-	// Need to select a new random patrol destination using cached navigation system
-	if (!CachedNavSystem)
-	{
-		return;
-	}
-
-	// Get current location
-	FVector CurrentLocation = ControlledMonster->GetActorLocation();
-	
-	// Try to find a random reachable point within patrol range
-	FNavLocation ResultLocation;
-	bool bFoundLocation = CachedNavSystem->GetRandomReachablePointInRadius(CurrentLocation, PatrolRange, ResultLocation);
-	
-	if (bFoundLocation)
-	{
-		// Move to the new patrol destination with deliberate, heavy pace
-		// The movement speed is configured via PatrolStandingSpeed property in AMonsterCharacter
-		MoveToLocation(ResultLocation.Location, PatrolAcceptanceRadius);
-	}
-	else
-	{
-		// Failed to find a reachable location, try again with a smaller radius
-		FNavLocation CloserResultLocation;
-		bool bFoundCloserLocation = CachedNavSystem->GetRandomReachablePointInRadius(CurrentLocation, PatrolRange * 0.5f, CloserResultLocation);
-		if (bFoundCloserLocation)
-		{
-			MoveToLocation(CloserResultLocation.Location, PatrolAcceptanceRadius);
-		}
-		// If still can't find a location, the monster will try again on the next tick
-		// This prevents getting stuck while allowing for environmental constraints
-	}
+	// Need to select a new random patrol destination
+	OutIntents.Emplace(EMonsterAIIntentType::MoveToPatrolPoint);
 }
 
-void AMonsterAIController::ExecutePatrolCrawlingBehavior_Implementation(float DeltaTime)
+void AMonsterAIController::DecidePatrolStop(FMonsterAIRuntimeState& State, FMonsterAIIntentQueue& OutIntents)
 {
-	if (!ControlledMonster)
-	{
-		return;
-	}
+	// We've reached destination, now stop to listen/look around
+	State.bIsStoppedAtDestination = true;
+	State.CurrentStopTime = 0.0f;
+	State.TargetStopDuration = GetValidatedRandomRange(MinStopDuration, MaxStopDuration);
 
-	// Get the surface pathfinding component
-	USurfacePathfindingComponent* SurfacePathfinding = ControlledMonster->GetSurfacePathfinding();
-	if (!SurfacePathfinding)
+	// Stop movement, and find the way to the next destination while listening
+	OutIntents.Emplace(EMonsterAIIntentType::StopMovement);
+	OutIntents.Emplace(EMonsterAIIntentType::PrefetchPatrolPath);
+}
+
+void AMonsterAIController::DecidePatrolCrawlingBehavior(const FMonsterAIDecisionInput& Input, float DeltaTime, FMonsterAIRuntimeState& State, FMonsterAIIntentQueue& OutIntents)
+{
+	if (!Input.bHasSurfacePathfinding)
 	{
 		return;
 	}
 
 	// Check if we're currently stopped at a destination to listen/look around
-	if (bIsStoppedAtDestination)
+	if (State.bIsStoppedAtDestination)
 	{
-		CurrentStopTime += DeltaTime;
-		
 		// Check if we've waited long enough
-		if (CurrentStopTime >= TargetStopDuration)
+		if (State.CurrentStopTime >= State.TargetStopDuration)
 		{
 			// Done stopping, ready to move to next destination
-			bIsStoppedAtDestination = false;
-			CurrentStopTime = 0.0f;
-			bHasCrawlingTarget = false; // Reset target so we pick a new one
-			StuckTime = 0.0f; // Reset stuck detection
+			State.bIsStoppedAtDestination = false;
+			State.CurrentStopTime = 0.0f;
+			State.bHasCrawlingTarget = false; // Reset target so we pick a new one
+			State.StuckTime = 0.0f; // Reset stuck detection
 		}
 		else
 		{
@@ -316,72 +906,312 @@ void AMonsterAIController::ExecutePatrolCrawlingBehavior_Implementation(float De
 		}
 	}
 
-	// Check if we need to select a new target location
-	if (!bHasCrawlingTarget)
+	// Backing off after a failed crawl target search
+	if (!State.bHasCrawlingTarget && State.CrawlSearchBackoff > 0.0f)
+	{
+		State.CrawlSearchBackoff -= DeltaTime;
+		return;
+	}
+
+	// Detect if the monster is stuck (not making progress toward target); a new target is picked when crawling starts
+	if (State.bHasCrawlingTarget)
 	{
-		FVector CurrentLocation = ControlledMonster->GetActorLocation();
-		FVector TargetNormal;
+		float MovementDistance = (Input.Location - State.PreviousCrawlingLocation).Size();
 
-		// Use surface pathfinding to get a random surface location (floor, wall, or ceiling)
-		if (SurfacePathfinding->GetRandomSurfaceLocation(CurrentLocation, PatrolRange, CrawlingTargetLocation, TargetNormal))
+		// If moving very little over time, consider it stuck
+		const float MinMovementThreshold = 10.0f; // Units per second
+		if (MovementDistance < MinMovementThreshold * DeltaTime)
 		{
-			bHasCrawlingTarget = true;
-			PreviousCrawlingLocation = CurrentLocation;
-			StuckTime = 0.0f;
+			State.StuckTime += DeltaTime;
+
+			// If stuck for more than 2 seconds, abandon current target and pick a new one
+			if (State.StuckTime > 2.0f)
+			{
+				State.bHasCrawlingTarget = false;
+				State.StuckTime = 0.0f;
+				return; // Will pick new target on next tick
+			}
 		}
 		else
 		{
-			// Failed to find a target, try again next tick
+			// Making progress, reset stuck timer
+			State.StuckTime = 0.0f;
+			State.PreviousCrawlingLocation = Input.Location;
+		}
+	}
+
+	OutIntents.Emplace(EMonsterAIIntentType::CrawlTowardsTarget);
+}
+
+void AMonsterAIController::ApplyIntents(const FMonsterAIIntent* Intents, int32 NumIntents, EMonsterBehaviorState DecidedState, float DeltaTime)
+{
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_ApplyIntents);
+
+	for (int32 Index = 0; Index < NumIntents; ++Index)
+	{
+		// An earlier side effect (e.g. a Blueprint OnEnterState) may have lost the monster, or moved it to a state the
+		// rest of the decision wasn't made for; its next update decides again from the new state
+		if (!ControlledMonster || CurrentState != DecidedState)
+		{
 			return;
 		}
+
+		const FMonsterAIIntent& Intent = Intents[Index];
+		switch (Intent.Type)
+		{
+			case EMonsterAIIntentType::TransitionToState:
+				TransitionToState(Intent.State);
+				DecidedState = Intent.State;
+				break;
+
+			case EMonsterAIIntentType::MoveToPatrolPoint:
+				MoveToPatrolPoint();
+				break;
+
+			case EMonsterAIIntentType::StopMovement:
+				StopMovement();
+				break;
+
+			case EMonsterAIIntentType::PrefetchPatrolPath:
+				PrefetchPatrolPath();
+				break;
+
+			case EMonsterAIIntentType::CrawlTowardsTarget:
+				CrawlTowardsTarget(DeltaTime);
+				break;
+
+			case EMonsterAIIntentType::NeckTwitch:
+				ControlledMonster->OnNeckTwitch();
+				break;
+
+			case EMonsterAIIntentType::FingerShift:
+				ControlledMonster->OnFingerShift();
+				break;
+
+			case EMonsterAIIntentType::BreathingUpdate:
+				ControlledMonster->OnBreathingUpdate(Intent.Value);
+				break;
+
+			case EMonsterAIIntentType::PublishBreathingCycle:
+				PublishBreathingCycle();
+				break;
+		}
+	}
+}
+
+void AMonsterAIController::MoveToPatrolPoint()
+{
+	// Follow the path found during the stop, unless the navmesh changed under it since
+	if (PrefetchedPatrolPath.IsValid())
+	{
+		FNavPathSharedPtr Path = PrefetchedPatrolPath;
+		PrefetchedPatrolPath.Reset();
+
+		if (Path->IsValid() && Path->IsUpToDate())
+		{
+			// Move to the new patrol destination with deliberate, heavy pace
+			// The movement speed is configured via PatrolStandingSpeed property in AMonsterCharacter
+			Path->EnableRecalculationOnInvalidation(true);
+			if (RequestMove(MakePatrolMoveRequest(PrefetchedPatrolDestination), Path).IsValid())
+			{
+				return;
+			}
+		}
+	}
+
+	// No path yet (e.g. the first destination after entering the state): look for one and leave once it is found,
+	// rather than pathfinding on this frame
+	if (PatrolPathQueryId == 0)
+	{
+		PrefetchPatrolPath();
+	}
+}
+
+void AMonsterAIController::PrefetchPatrolPath()
+{
+	if (!CachedNavSystem || !ControlledMonster || PatrolPathQueryId != 0)
+	{
+		return;
 	}
 
-	// Detect if the monster is stuck (not making progress toward target)
+	PrefetchedPatrolPath.Reset();
+
+	// Get current location
 	FVector CurrentLocation = ControlledMonster->GetActorLocation();
-	float MovementDistance = (CurrentLocation - PreviousCrawlingLocation).Size();
-	
-	// If moving very little over time, consider it stuck
-	const float MinMovementThreshold = 10.0f; // Units per second
-	if (MovementDistance < MinMovementThreshold * DeltaTime)
+
+	// Draw a destination from the shared pool, and until it is built (or if it has nothing nearby)
+	// search for a random reachable point within patrol range, and failing that with a smaller radius
+	FNavLocation ResultLocation;
+	if (!PatrolPointSubsystem || !PatrolPointSubsystem->FindRandomPatrolPoint(CurrentLocation, PatrolRange, GetRandomStream(), ResultLocation.Location))
 	{
-		StuckTime += DeltaTime;
-		
-		// If stuck for more than 2 seconds, abandon current target and pick a new one
-		if (StuckTime > 2.0f)
+		if (!CachedNavSystem->GetRandomReachablePointInRadius(CurrentLocation, PatrolRange, ResultLocation)
+			&& !CachedNavSystem->GetRandomReachablePointInRadius(CurrentLocation, PatrolRange * 0.5f, ResultLocation))
 		{
-			bHasCrawlingTarget = false;
-			StuckTime = 0.0f;
-			return; // Will pick new target on next tick
+			// If still can't find a location, the monster will try again on the next tick
+			// This prevents getting stuck while allowing for environmental constraints
+			return;
 		}
 	}
-	else
+
+	FPathFindingQuery Query;
+	if (!BuildPathfindingQuery(MakePatrolMoveRequest(ResultLocation.Location), Query))
+	{
+		return;
+	}
+
+	// The path is found on the navigation system's worker thread and handed back on the game thread
+	PrefetchedPatrolDestination = ResultLocation.Location;
+	PatrolPathQueryId = CachedNavSystem->FindPathAsync(ControlledMonster->GetNavAgentPropertiesRef(), Query,
+		FNavPathQueryDelegate::CreateUObject(this, &AMonsterAIController::OnPatrolPathFound));
+}
+
+void AMonsterAIController::CancelPatrolPathPrefetch()
+{
+	if (PatrolPathQueryId != 0 && CachedNavSystem)
+	{
+		CachedNavSystem->AbortAsyncFindPathRequest(PatrolPathQueryId);
+	}
+
+	PatrolPathQueryId = 0;
+	PrefetchedPatrolPath.Reset();
+}
+
+void AMonsterAIController::OnPatrolPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path)
+{
+	// A query aborted after it already finished
+	if (QueryId != PatrolPathQueryId)
+	{
+		return;
+	}
+
+	PatrolPathQueryId = 0;
+
+	// On failure the next MoveToPatrolPoint picks another destination
+	if (Result == ENavigationQueryResult::Success && Path.IsValid())
+	{
+		PrefetchedPatrolPath = Path;
+	}
+
+	// The event-driven standing patrol waiting for this path walks off now; one stopped at a destination waits for its timer
+	if (IsPatrolStandingEventDriven() && GetRuntimeState().bWaitingForScheduledWake && !GetRuntimeState().bIsStoppedAtDestination)
+	{
+		WakeBehavior();
+	}
+}
+
+FAIMoveRequest AMonsterAIController::MakePatrolMoveRequest(const FVector& Destination) const
+{
+	// Same as MoveToLocation(Destination, PatrolAcceptanceRadius)
+	FAIMoveRequest MoveRequest(Destination);
+	MoveRequest.SetAcceptanceRadius(PatrolAcceptanceRadius);
+	MoveRequest.SetUsePathfinding(true);
+	MoveRequest.SetAllowPartialPath(true);
+	MoveRequest.SetProjectGoalLocation(false);
+	MoveRequest.SetCanStrafe(true);
+	MoveRequest.SetReachTestIncludesAgentRadius(true);
+	MoveRequest.SetNavigationFilter(DefaultNavigationFilterClass);
+	return MoveRequest;
+}
+
+void AMonsterAIController::CrawlTowardsTarget(float DeltaTime)
+{
+	// Get the surface pathfinding component
+	USurfacePathfindingComponent* SurfacePathfinding = ControlledMonster->GetSurfacePathfinding();
+	if (!SurfacePathfinding)
+	{
+		return;
+	}
+
+	FMonsterAIRuntimeState& State = GetRuntimeState();
+
+	// Check if we need to select a new target location
+	if (!State.bHasCrawlingTarget && !FindCrawlingTarget(SurfacePathfinding, State))
 	{
-		// Making progress, reset stuck timer
-		StuckTime = 0.0f;
-		PreviousCrawlingLocation = CurrentLocation;
+		return;
 	}
 
 	// Move toward the target using surface-based movement
 	// This enables full freedom of movement across any surface
-	if (bHasCrawlingTarget)
+	float CrawlingSpeed = ControlledMonster->GetMovementSpeedForState(EMonsterBehaviorState::PatrolCrawling);
+	bool bStillMoving = SurfacePathfinding->MoveTowardsSurfaceLocation(State.CrawlingTargetLocation, DeltaTime, CrawlingSpeed);
+
+	if (!bStillMoving)
+	{
+		// Reached destination, stop to listen/look around
+		State.bIsStoppedAtDestination = true;
+		State.CurrentStopTime = 0.0f;
+		State.TargetStopDuration = GetValidatedRandomRange(MinStopDuration, MaxStopDuration);
+		State.bHasCrawlingTarget = false;
+		State.StuckTime = 0.0f;
+	}
+}
+
+bool AMonsterAIController::FindCrawlingTarget(USurfacePathfindingComponent* SurfacePathfinding, FMonsterAIRuntimeState& State)
+{
+	const FVector CurrentLocation = ControlledMonster->GetActorLocation();
+	FVector SearchOrigin = CurrentLocation;
+	float SearchRange = PatrolRange;
+
+	// The full search failed before, e.g. in an open area or out of bounds: look closer, and from just above
+	// the last surface the monster touched, so the rays have something to hit
+	if (State.CrawlSearchFailures > 0)
 	{
-		float CrawlingSpeed = ControlledMonster->GetMovementSpeedForState(EMonsterBehaviorState::PatrolCrawling);
-		bool bStillMoving = SurfacePathfinding->MoveTowardsSurfaceLocation(CrawlingTargetLocation, DeltaTime, CrawlingSpeed);
+		SearchRange = FMath::Max(PatrolRange / (1 << FMath::Min(State.CrawlSearchFailures, 3)), SurfacePathfinding->AcceptanceRadius * 2.0f);
 
-		if (!bStillMoving)
+		FVector SurfaceLocation, SurfaceNormal;
+		if (SurfacePathfinding->GetLastKnownSurface(SurfaceLocation, SurfaceNormal))
 		{
-			// Reached destination, stop to listen/look around
-			bIsStoppedAtDestination = true;
-			CurrentStopTime = 0.0f;
-			TargetStopDuration = GetValidatedRandomRange(MinStopDuration, MaxStopDuration);
-			bHasCrawlingTarget = false;
-			StuckTime = 0.0f;
+			SearchOrigin = SurfaceLocation + SurfaceNormal * (SearchRange * 0.25f);
 		}
 	}
+
+	// Use surface pathfinding to get a random surface location (floor, wall, or ceiling)
+	FVector TargetNormal;
+	if (SurfacePathfinding->GetRandomSurfaceLocation(SearchOrigin, SearchRange, State.CrawlingTargetLocation, TargetNormal))
+	{
+		State.bHasCrawlingTarget = true;
+		State.PreviousCrawlingLocation = CurrentLocation;
+		State.StuckTime = 0.0f;
+		State.CrawlSearchFailures = 0;
+		return true;
+	}
+
+	// A batched search answers on the next frame
+	if (!SurfacePathfinding->IsRandomSurfaceLocationPending())
+	{
+		HandleCrawlTargetSearchFailure(State);
+	}
+
+	return false;
+}
+
+void AMonsterAIController::HandleCrawlTargetSearchFailure(FMonsterAIRuntimeState& State)
+{
+	++State.CrawlSearchFailures;
+
+	// Exponential backoff with jitter, so a misplaced monster can't spend its traces every frame
+	const float Delay = FMath::Min(CrawlSearchRetryDelay * (1 << FMath::Min(State.CrawlSearchFailures - 1, 16)), MaxCrawlSearchRetryDelay);
+	const float Jitter = FMath::Clamp(CrawlSearchRetryJitter, 0.0f, 1.0f);
+	State.CrawlSearchBackoff = Delay * GetRandomStream().FRandRange(1.0f - Jitter, 1.0f + Jitter);
+
+	if (MaxCrawlSearchFailures > 0 && State.CrawlSearchFailures >= MaxCrawlSearchFailures)
+	{
+		const int32 ConsecutiveFailures = State.CrawlSearchFailures;
+		State.CrawlSearchFailures = 0;
+		OnCrawlTargetSearchExhausted(ConsecutiveFailures);
+	}
+}
+
+void AMonsterAIController::OnCrawlTargetSearchExhausted_Implementation(int32 ConsecutiveFailures)
+{
+	// Nowhere to crawl from here; idle, and maybe patrol on foot next time
+	TransitionToState(EMonsterBehaviorState::Idle);
 }
 
 void AMonsterAIController::OnEnterState_Implementation(EMonsterBehaviorState NewState)
 {
+	FMonsterAIRuntimeState& State = GetRuntimeState();
+
 	// Initialize state-specific variables when entering a state
 	if (NewState == EMonsterBehaviorState::Idle)
 	{
@@ -392,34 +1222,36 @@ void AMonsterAIController::OnEnterState_Implementation(EMonsterBehaviorState New
 		}
 		
 		// Reset idle timing
-		CurrentIdleTime = 0.0f;
+		State.CurrentIdleTime = 0.0f;
 		
 		// Validate idle duration range
-		TargetIdleDuration = GetValidatedRandomRange(MinIdleDuration, MaxIdleDuration);
+		State.TargetIdleDuration = GetValidatedRandomRange(MinIdleDuration, MaxIdleDuration);
 		
 		// Reset subtle movement timing
-		TimeSinceLastSubtleMovement = 0.0f;
+		State.TimeSinceLastSubtleMovement = 0.0f;
 		
 		// Validate subtle movement interval range
-		NextSubtleMovementTime = GetValidatedRandomRange(MinSubtleMovementInterval, MaxSubtleMovementInterval);
+		State.NextSubtleMovementTime = GetValidatedRandomRange(MinSubtleMovementInterval, MaxSubtleMovementInterval);
 		
 		// Reset breathing cycle
-		BreathingCycleTime = 0.0f;
+		State.BreathingCycleTime = 0.0f;
 	}
 	else if (NewState == EMonsterBehaviorState::PatrolStanding || NewState == EMonsterBehaviorState::PatrolCrawling)
 	{
 		// Reset patrol timing variables
-		CurrentStopTime = 0.0f;
-		TargetStopDuration = 0.0f;
-		bIsStoppedAtDestination = false;
+		State.CurrentStopTime = 0.0f;
+		State.TargetStopDuration = 0.0f;
+		State.bIsStoppedAtDestination = false;
 		
 		// Reset crawling-specific variables
 		if (NewState == EMonsterBehaviorState::PatrolCrawling)
 		{
-			bHasCrawlingTarget = false;
-			CrawlingTargetLocation = FVector::ZeroVector;
-			StuckTime = 0.0f;
-			PreviousCrawlingLocation = FVector::ZeroVector;
+			State.bHasCrawlingTarget = false;
+			State.CrawlingTargetLocation = FVector::ZeroVector;
+			State.StuckTime = 0.0f;
+			State.PreviousCrawlingLocation = FVector::ZeroVector;
+			State.CrawlSearchFailures = 0;
+			State.CrawlSearchBackoff = 0.0f;
 		}
 	}
 }
@@ -430,10 +1262,15 @@ void AMonsterAIController::OnExitState_Implementation(EMonsterBehaviorState OldS
 	// Can be overridden to clean up state-specific logic
 }
 
-float AMonsterAIController::GetValidatedRandomRange(float MinValue, float MaxValue) const
+float AMonsterAIController::GetValidatedRandomRange(float MinValue, float MaxValue)
 {
 	// Ensure MinValue <= MaxValue by using FMath::Min/Max
 	float ValidMin = FMath::Min(MinValue, MaxValue);
 	float ValidMax = FMath::Max(MinValue, MaxValue);
-	return FMath::RandRange(ValidMin, ValidMax);
+	return GetRandomStream().FRandRange(ValidMin, ValidMax);
+}
+
+FRandomStream& AMonsterAIController::GetRandomStream()
+{
+	return ControlledMonster ? ControlledMonster->GetRandomStream() : UnpossessedRandomStream;
 }
@@ -0,0 +1,68 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterAnimInstance.h"
+
+void FMonsterAnimInstanceProxy::PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds)
+{
+	FAnimInstanceProxy::PreUpdate(InAnimInstance, DeltaSeconds);
+
+	UMonsterAnimInstance* MonsterAnimInstance = CastChecked<UMonsterAnimInstance>(InAnimInstance);
+	if (MonsterAnimInstance->bHasPendingBreathingCycle)
+	{
+		BreathingCycleTime = MonsterAnimInstance->PendingBreathingCycleTime;
+		BreathingCycleDuration = MonsterAnimInstance->PendingBreathingCycleDuration;
+		bIsBreathing = MonsterAnimInstance->bPendingIsBreathing;
+		MonsterAnimInstance->bHasPendingBreathingCycle = false;
+	}
+}
+
+void FMonsterAnimInstanceProxy::Update(float DeltaSeconds)
+{
+	FAnimInstanceProxy::Update(DeltaSeconds);
+
+	if (!bIsBreathing || BreathingCycleDuration <= 0.0f)
+	{
+		BreathingIntensity = 0.0f;
+		return;
+	}
+
+	BreathingCycleTime = FMath::Fmod(BreathingCycleTime + DeltaSeconds, BreathingCycleDuration);
+
+	// Sine wave for smooth breathing, over one full period per cycle
+	const float NormalizedTime = BreathingCycleTime / BreathingCycleDuration;
+	BreathingIntensity = (FMath::Sin(NormalizedTime * 2.0f * PI) + 1.0f) * 0.5f;
+}
+
+void FMonsterAnimInstanceProxy::PostUpdate(UAnimInstance* InAnimInstance) const
+{
+	FAnimInstanceProxy::PostUpdate(InAnimInstance);
+
+	CastChecked<UMonsterAnimInstance>(InAnimInstance)->BreathingIntensity = BreathingIntensity;
+}
+
+UMonsterAnimInstance::UMonsterAnimInstance()
+{
+	BreathingIntensity = 0.0f;
+	PendingBreathingCycleTime = 0.0f;
+	PendingBreathingCycleDuration = 0.0f;
+	bPendingIsBreathing = false;
+	bHasPendingBreathingCycle = false;
+}
+
+void UMonsterAnimInstance::SetBreathingCycle(float CycleTime, float CycleDuration, bool bBreathing)
+{
+	PendingBreathingCycleTime = CycleTime;
+	PendingBreathingCycleDuration = CycleDuration;
+	bPendingIsBreathing = bBreathing;
+	bHasPendingBreathingCycle = true;
+}
+
+FAnimInstanceProxy* UMonsterAnimInstance::CreateAnimInstanceProxy()
+{
+	return &Proxy;
+}
+
+void UMonsterAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy)
+{
+	// The proxy is a member, nothing to free
+}
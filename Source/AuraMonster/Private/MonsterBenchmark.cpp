@@ -0,0 +1,497 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterBenchmark.h"
+#include "MonsterCharacter.h"
+#include "MonsterAIController.h"
+#include "MonsterBudgetSubsystem.h"
+#include "Components/BrushComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerStart.h"
+#include "GameFramework/WorldSettings.h"
+#include "NavigationSystem.h"
+#include "NavMesh/NavMeshBoundsVolume.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "PhysicsEngine/BodySetup.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/App.h"
+#include "Async/TaskGraphInterfaces.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+#include "UObject/Package.h"
+#include "UObject/UnrealType.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMonsterBenchmark, Log, All);
+
+FMonsterBenchmarkSettings::FMonsterBenchmarkSettings()
+	: bGenerateLevel(true)
+	, bBuildNavigation(true)
+	, NumMonsters(200)
+	, IdleWeight(1.0f)
+	, PatrolStandingWeight(1.0f)
+	, PatrolCrawlingWeight(2.0f)
+	, PatrolTransitionChance(-1.0f)
+	, WarmupFrames(60)
+	, NumFrames(600)
+	, FixedDeltaTime(1.0f / 30.0f)
+	, Seed(1)
+	, ForceLODTier(0)
+	, bSpawnViewer(true)
+	, MonsterClass(AMonsterCharacter::StaticClass())
+	, ControllerClass(AMonsterAIController::StaticClass())
+{
+}
+
+float FMonsterBenchmarkResults::GetPercentile(TArray<float> Values, float Percentile)
+{
+	if (Values.Num() == 0)
+	{
+		return 0.0f;
+	}
+
+	Values.Sort();
+	const int32 Rank = FMath::CeilToInt(FMath::Clamp(Percentile, 0.0f, 100.0f) / 100.0f * Values.Num());
+	return Values[FMath::Clamp(Rank - 1, 0, Values.Num() - 1)];
+}
+
+namespace
+{
+	/** Sets an integer console variable for the length of a run and puts the previous value back afterwards */
+	class FScopedConsoleVariableOverride
+	{
+	public:
+		FScopedConsoleVariableOverride(const TCHAR* Name, int32 Value)
+			: Variable(IConsoleManager::Get().FindConsoleVariable(Name))
+			, PreviousValue(0)
+		{
+			if (Variable)
+			{
+				PreviousValue = Variable->GetInt();
+				Variable->Set(Value, ECVF_SetByCode);
+			}
+		}
+
+		~FScopedConsoleVariableOverride()
+		{
+			if (Variable)
+			{
+				Variable->Set(PreviousValue, ECVF_SetByCode);
+			}
+		}
+
+	private:
+		IConsoleVariable* Variable;
+		int32 PreviousValue;
+	};
+
+	/** Mean and percentiles of a per-frame series */
+	TSharedRef<FJsonObject> MakeSeriesSummary(const TArray<float>& Values)
+	{
+		double Sum = 0.0;
+		for (const float Value : Values)
+		{
+			Sum += Value;
+		}
+
+		TSharedRef<FJsonObject> Summary = MakeShared<FJsonObject>();
+		Summary->SetNumberField(TEXT("Mean"), Values.Num() > 0 ? Sum / Values.Num() : 0.0);
+		Summary->SetNumberField(TEXT("P50"), FMonsterBenchmarkResults::GetPercentile(Values, 50.0f));
+		Summary->SetNumberField(TEXT("P90"), FMonsterBenchmarkResults::GetPercentile(Values, 90.0f));
+		Summary->SetNumberField(TEXT("P95"), FMonsterBenchmarkResults::GetPercentile(Values, 95.0f));
+		Summary->SetNumberField(TEXT("P99"), FMonsterBenchmarkResults::GetPercentile(Values, 99.0f));
+		Summary->SetNumberField(TEXT("Max"), FMonsterBenchmarkResults::GetPercentile(Values, 100.0f));
+		return Summary;
+	}
+
+	TArray<float> ToFloatArray(const TArray<int32>& Values)
+	{
+		TArray<float> Result;
+		Result.Reserve(Values.Num());
+		for (const int32 Value : Values)
+		{
+			Result.Add(static_cast<float>(Value));
+		}
+		return Result;
+	}
+
+	FString GetStateName(EMonsterBehaviorState State)
+	{
+		return StaticEnum<EMonsterBehaviorState>()->GetNameStringByValue(static_cast<int64>(State));
+	}
+
+	/** Load the map or create an empty world, as a game world so the monster subsystems are created */
+	UWorld* CreateBenchmarkWorld(const FString& MapName)
+	{
+		UWorld* World = nullptr;
+		if (MapName.IsEmpty())
+		{
+			World = UWorld::CreateWorld(EWorldType::Game, false, TEXT("MonsterBenchmark"));
+		}
+		else
+		{
+			UPackage* Package = LoadPackage(nullptr, *MapName, LOAD_None);
+			World = Package ? UWorld::FindWorldInPackage(Package) : nullptr;
+			if (!World)
+			{
+				UE_LOG(LogMonsterBenchmark, Error, TEXT("Couldn't load map %s"), *MapName);
+				return nullptr;
+			}
+
+			World->WorldType = EWorldType::Game;
+			World->AddToRoot();
+			if (!World->bIsWorldInitialized)
+			{
+				World->InitWorld();
+			}
+			World->UpdateWorldComponents(true, false);
+		}
+
+		FWorldContext& WorldContext = GEngine->CreateNewWorldContext(EWorldType::Game);
+		WorldContext.SetCurrentWorld(World);
+		FNavigationSystem::AddNavigationSystemToWorld(*World, FNavigationSystemRunMode::GameMode);
+		return World;
+	}
+
+	void BeginBenchmarkPlay(UWorld* World)
+	{
+		World->InitializeActorsForPlay(FURL());
+		World->BeginPlay();
+
+		// Without a game mode nothing tells the actors the game has started
+		if (!World->HasBegunPlay())
+		{
+			World->GetWorldSettings()->NotifyBeginPlay();
+		}
+	}
+
+	void DestroyBenchmarkWorld(UWorld* World)
+	{
+		for (TActorIterator<AActor> It(World); It; ++It)
+		{
+			It->RouteEndPlay(EEndPlayReason::Quit);
+		}
+
+		World->RemoveFromRoot();
+		World->DestroyWorld(true);
+	}
+
+	/**
+	 * Cover the rooms of the generated level with navmesh bounds and build a navmesh over them, blocking until it is done.
+	 * The level only exists at runtime, so its navmesh has to be generated at runtime too.
+	 * @return False if the navigation system didn't create a navmesh to build
+	 */
+	bool BuildBenchmarkNavigation(UWorld* World, const TArray<FBox>& Rooms)
+	{
+		UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+		if (!NavSystem || Rooms.Num() == 0)
+		{
+			return false;
+		}
+
+		// Rooms start at the top of their floor; reach down to it and take the corridors between the rooms in
+		FBox Bounds(ForceInit);
+		for (const FBox& Room : Rooms)
+		{
+			Bounds += Room;
+		}
+		Bounds = Bounds.ExpandBy(100.0f);
+
+		ANavMeshBoundsVolume* BoundsVolume = World->SpawnActor<ANavMeshBoundsVolume>(Bounds.GetCenter(), FRotator::ZeroRotator);
+		if (!BoundsVolume)
+		{
+			return false;
+		}
+
+		// Volumes get their shape from a brush built in the editor; a box body gives the brush component the same bounds
+		UBrushComponent* BrushComponent = BoundsVolume->GetBrushComponent();
+		const FVector Size = Bounds.GetSize();
+		BrushComponent->BrushBodySetup = NewObject<UBodySetup>(BrushComponent);
+		BrushComponent->BrushBodySetup->AggGeom.BoxElems.Add(FKBoxElem(Size.X, Size.Y, Size.Z));
+		BrushComponent->UpdateBounds();
+		NavSystem->OnNavigationBoundsUpdated(BoundsVolume);
+
+		// Creates the navmesh of each supported agent; game worlds only build navmeshes with runtime generation
+		NavSystem->Build();
+
+#if ENGINE_MAJOR_VERSION > 4 || ENGINE_MINOR_VERSION >= 25
+		FProperty* RuntimeGenerationProperty = FindFProperty<FProperty>(ANavigationData::StaticClass(), TEXT("RuntimeGeneration"));
+#else
+		UProperty* RuntimeGenerationProperty = FindField<UProperty>(ANavigationData::StaticClass(), TEXT("RuntimeGeneration"));
+#endif
+
+		bool bBuilt = false;
+		for (TActorIterator<ARecastNavMesh> It(World); It; ++It)
+		{
+			ARecastNavMesh* NavMesh = *It;
+			if (RuntimeGenerationProperty && NavMesh->GetRuntimeGenerationMode() == ERuntimeGenerationType::Static)
+			{
+				RuntimeGenerationProperty->ImportText(TEXT("Dynamic"), RuntimeGenerationProperty->ContainerPtrToValuePtr<void>(NavMesh), PPF_None, NavMesh);
+			}
+
+			NavMesh->RebuildAll();
+			NavMesh->EnsureBuildCompletion();
+			bBuilt = true;
+		}
+
+		return bBuilt;
+	}
+
+	/** Areas monsters spawn in when there is no generated level: around the first player start, or the world origin */
+	FBox GetDefaultSpawnArea(UWorld* World, const FMonsterBenchmarkLevelSettings& Level)
+	{
+		FVector Floor = FVector::ZeroVector;
+		TActorIterator<APlayerStart> PlayerStart(World);
+		if (PlayerStart)
+		{
+			Floor = PlayerStart->GetActorLocation() - FVector(0.0f, 0.0f, PlayerStart->GetCapsuleComponent()->GetScaledCapsuleHalfHeight());
+		}
+
+		const float HalfSize = Level.RoomSize * 0.5f;
+		return FBox(Floor - FVector(HalfSize, HalfSize, 0.0f), Floor + FVector(HalfSize, HalfSize, Level.RoomHeight));
+	}
+
+	/** Behavior state of each monster to spawn, in the proportions of the weights */
+	TArray<EMonsterBehaviorState> MakeStateMix(const FMonsterBenchmarkSettings& Settings)
+	{
+		const EMonsterBehaviorState States[] = { EMonsterBehaviorState::Idle, EMonsterBehaviorState::PatrolStanding, EMonsterBehaviorState::PatrolCrawling };
+		const float Weights[] = { FMath::Max(0.0f, Settings.IdleWeight), FMath::Max(0.0f, Settings.PatrolStandingWeight), FMath::Max(0.0f, Settings.PatrolCrawlingWeight) };
+		const float TotalWeight = FMath::Max(Weights[0] + Weights[1] + Weights[2], KINDA_SMALL_NUMBER);
+
+		// Round the running totals, so the counts always add up to the number of monsters
+		TArray<EMonsterBehaviorState> Mix;
+		Mix.Reserve(Settings.NumMonsters);
+		float CumulativeWeight = 0.0f;
+		for (int32 Index = 0; Index < UE_ARRAY_COUNT(States); ++Index)
+		{
+			CumulativeWeight += Weights[Index];
+			const int32 End = Index == UE_ARRAY_COUNT(States) - 1 ? Settings.NumMonsters : FMath::RoundToInt(Settings.NumMonsters * CumulativeWeight / TotalWeight);
+			while (Mix.Num() < End)
+			{
+				Mix.Add(States[Index]);
+			}
+		}
+
+		return Mix;
+	}
+}
+
+bool MonsterBenchmark::Run(const FMonsterBenchmarkSettings& Settings, FMonsterBenchmarkResults& OutResults)
+{
+	OutResults = FMonsterBenchmarkResults();
+	if (!GEngine || !Settings.MonsterClass || !Settings.ControllerClass)
+	{
+		return false;
+	}
+
+	// Monsters with the Random seed policy are seeded from this and their name, so runs repeat
+	const FScopedConsoleVariableOverride RandomSeedOverride(TEXT("AuraMonster.RandomSeed"), Settings.Seed != 0 ? Settings.Seed : 1);
+	const FScopedConsoleVariableOverride LODTierOverride(TEXT("AuraMonster.LOD.ForceTier"), Settings.ForceLODTier);
+
+	UWorld* World = CreateBenchmarkWorld(Settings.MapName);
+	if (!World)
+	{
+		return false;
+	}
+
+	TArray<FBox> SpawnAreas;
+	if (Settings.bGenerateLevel)
+	{
+		FMonsterBenchmarkLevelSettings Level = Settings.Level;
+		Level.Seed = Settings.Seed;
+		if (!MonsterBenchmarkLevel::Generate(World, Level, SpawnAreas))
+		{
+			UE_LOG(LogMonsterBenchmark, Error, TEXT("Couldn't load the cube mesh the level is built from; spawning without a level"));
+		}
+	}
+	if (SpawnAreas.Num() == 0)
+	{
+		SpawnAreas.Add(GetDefaultSpawnArea(World, Settings.Level));
+	}
+
+	BeginBenchmarkPlay(World);
+
+	// Before the monsters spawn, so standing patrollers find the navmesh from their first destination on
+	if (Settings.bGenerateLevel && Settings.bBuildNavigation && Settings.MapName.IsEmpty())
+	{
+		OutResults.bBuiltNavigation = BuildBenchmarkNavigation(World, SpawnAreas);
+		if (!OutResults.bBuiltNavigation)
+		{
+			UE_LOG(LogMonsterBenchmark, Warning, TEXT("Couldn't build a navmesh over the generated level; standing patrols won't find destinations"));
+		}
+	}
+
+	if (Settings.bSpawnViewer)
+	{
+		const FVector ViewLocation = SpawnAreas[0].GetCenter();
+		if (APlayerController* Viewer = World->SpawnActor<APlayerController>(ViewLocation, FRotator::ZeroRotator))
+		{
+			Viewer->SetInitialLocationAndRotation(ViewLocation, FRotator::ZeroRotator);
+		}
+	}
+
+	// Spawn the monsters spread over the spawn areas, and put each in its starting state
+	const AMonsterCharacter* MonsterDefaults = Settings.MonsterClass->GetDefaultObject<AMonsterCharacter>();
+	const float SpawnHeight = MonsterDefaults->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() + 2.0f;
+	const float SpawnInset = MonsterDefaults->GetCapsuleComponent()->GetScaledCapsuleRadius() * 2.0f;
+	FRandomStream SpawnStream(Settings.Seed);
+
+	TArray<TWeakObjectPtr<AMonsterAIController>> Controllers;
+	TArray<EMonsterBehaviorState> LastStates;
+	for (const EMonsterBehaviorState State : MakeStateMix(Settings))
+	{
+		const FBox& Area = SpawnAreas[SpawnStream.RandHelper(SpawnAreas.Num())];
+		const FVector Location(
+			SpawnStream.FRandRange(Area.Min.X + SpawnInset, Area.Max.X - SpawnInset),
+			SpawnStream.FRandRange(Area.Min.Y + SpawnInset, Area.Max.Y - SpawnInset),
+			Area.Min.Z + SpawnHeight);
+		const FTransform Transform(FRotator(0.0f, SpawnStream.FRandRange(0.0f, 360.0f), 0.0f), Location);
+
+		AMonsterCharacter* Monster = World->SpawnActorDeferred<AMonsterCharacter>(Settings.MonsterClass, Transform, nullptr, nullptr, ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn);
+		if (!Monster)
+		{
+			continue;
+		}
+
+		Monster->AIControllerClass = Settings.ControllerClass;
+		Monster->AutoPossessAI = EAutoPossessAI::Spawned;
+		Monster->FinishSpawning(Transform);
+
+		AMonsterAIController* Controller = Cast<AMonsterAIController>(Monster->GetController());
+		if (!Controller)
+		{
+			continue;
+		}
+
+		if (Settings.PatrolTransitionChance >= 0.0f)
+		{
+			Controller->SetPatrolTransitionChance(Settings.PatrolTransitionChance);
+		}
+
+		if (Controller->GetCurrentState() != State)
+		{
+			Controller->TransitionToState(State);
+		}
+
+		Controllers.Add(Controller);
+		LastStates.Add(Controller->GetCurrentState());
+		OutResults.InitialStateCounts.FindOrAdd(GetStateName(State))++;
+	}
+	OutResults.NumMonsters = Controllers.Num();
+
+	UMonsterBudgetSubsystem* BudgetSubsystem = World->GetSubsystem<UMonsterBudgetSubsystem>();
+	const float DeltaTime = FMath::Max(Settings.FixedDeltaTime, KINDA_SMALL_NUMBER);
+	const int32 NumFrames = FMath::Max(0, Settings.NumFrames);
+	const int32 WarmupFrames = FMath::Max(0, Settings.WarmupFrames);
+
+	OutResults.FrameTimesMs.Reserve(NumFrames);
+	OutResults.MonsterTimesMs.Reserve(NumFrames);
+	OutResults.FrameTraces.Reserve(NumFrames);
+	OutResults.FrameTransitions.Reserve(NumFrames);
+
+	for (int32 Frame = 0; Frame < WarmupFrames + NumFrames; ++Frame)
+	{
+		FApp::SetDeltaTime(DeltaTime);
+		FApp::SetCurrentTime(FApp::GetCurrentTime() + DeltaTime);
+
+		const double StartTime = FPlatformTime::Seconds();
+		World->Tick(LEVELTICK_All, DeltaTime);
+		FTaskGraphInterface::Get().ProcessThreadUntilIdle(ENamedThreads::GameThread);
+		const double FrameSeconds = FPlatformTime::Seconds() - StartTime;
+
+		const bool bMeasured = Frame >= WarmupFrames;
+		int32 NumTransitions = 0;
+		for (int32 Index = 0; Index < Controllers.Num(); ++Index)
+		{
+			const AMonsterAIController* Controller = Controllers[Index].Get();
+			if (!Controller || Controller->GetCurrentState() == LastStates[Index])
+			{
+				continue;
+			}
+
+			if (bMeasured)
+			{
+				++NumTransitions;
+				OutResults.TransitionCounts.FindOrAdd(GetStateName(LastStates[Index]) + TEXT("->") + GetStateName(Controller->GetCurrentState()))++;
+			}
+			LastStates[Index] = Controller->GetCurrentState();
+		}
+
+		if (bMeasured)
+		{
+			OutResults.FrameTimesMs.Add(static_cast<float>(FrameSeconds * 1000.0));
+			OutResults.MonsterTimesMs.Add(BudgetSubsystem ? static_cast<float>(BudgetSubsystem->GetFrameSpentSeconds() * 1000.0) : 0.0f);
+			OutResults.FrameTraces.Add(BudgetSubsystem ? BudgetSubsystem->GetFrameSpentTraces() : 0);
+			OutResults.FrameTransitions.Add(NumTransitions);
+		}
+
+		// Nothing runs the engine loop here, so advance the frame number the monster subsystems go by
+		++GFrameCounter;
+	}
+
+	DestroyBenchmarkWorld(World);
+	return true;
+}
+
+FString FMonsterBenchmarkResults::ToJson(const FMonsterBenchmarkSettings& Settings) const
+{
+	TSharedRef<FJsonObject> SettingsObject = MakeShared<FJsonObject>();
+	SettingsObject->SetStringField(TEXT("Map"), Settings.MapName);
+	SettingsObject->SetBoolField(TEXT("GeneratedLevel"), Settings.bGenerateLevel);
+	SettingsObject->SetBoolField(TEXT("BuiltNavigation"), bBuiltNavigation);
+	SettingsObject->SetNumberField(TEXT("Rooms"), Settings.bGenerateLevel ? Settings.Level.NumRooms : 0);
+	SettingsObject->SetNumberField(TEXT("Monsters"), NumMonsters);
+	SettingsObject->SetNumberField(TEXT("IdleWeight"), Settings.IdleWeight);
+	SettingsObject->SetNumberField(TEXT("PatrolStandingWeight"), Settings.PatrolStandingWeight);
+	SettingsObject->SetNumberField(TEXT("PatrolCrawlingWeight"), Settings.PatrolCrawlingWeight);
+	SettingsObject->SetNumberField(TEXT("PatrolTransitionChance"), Settings.PatrolTransitionChance);
+	SettingsObject->SetNumberField(TEXT("WarmupFrames"), Settings.WarmupFrames);
+	SettingsObject->SetNumberField(TEXT("Frames"), Settings.NumFrames);
+	SettingsObject->SetNumberField(TEXT("FixedDeltaTime"), Settings.FixedDeltaTime);
+	SettingsObject->SetNumberField(TEXT("Seed"), Settings.Seed);
+	SettingsObject->SetNumberField(TEXT("ForceLODTier"), Settings.ForceLODTier);
+	SettingsObject->SetStringField(TEXT("MonsterClass"), GetPathNameSafe(Settings.MonsterClass));
+	SettingsObject->SetStringField(TEXT("ControllerClass"), GetPathNameSafe(Settings.ControllerClass));
+
+	TSharedRef<FJsonObject> InitialStatesObject = MakeShared<FJsonObject>();
+	for (const TPair<FString, int32>& Pair : InitialStateCounts)
+	{
+		InitialStatesObject->SetNumberField(Pair.Key, Pair.Value);
+	}
+
+	int32 TotalTransitions = 0;
+	TSharedRef<FJsonObject> TransitionsObject = MakeShared<FJsonObject>();
+	for (const TPair<FString, int32>& Pair : TransitionCounts)
+	{
+		TransitionsObject->SetNumberField(Pair.Key, Pair.Value);
+		TotalTransitions += Pair.Value;
+	}
+
+	TSharedRef<FJsonObject> Root = MakeShared<FJsonObject>();
+	Root->SetObjectField(TEXT("Settings"), SettingsObject);
+	Root->SetObjectField(TEXT("InitialStates"), InitialStatesObject);
+	Root->SetObjectField(TEXT("FrameMs"), MakeSeriesSummary(FrameTimesMs));
+	Root->SetObjectField(TEXT("MonsterMs"), MakeSeriesSummary(MonsterTimesMs));
+	Root->SetObjectField(TEXT("TracesPerFrame"), MakeSeriesSummary(ToFloatArray(FrameTraces)));
+	Root->SetObjectField(TEXT("TransitionsPerFrame"), MakeSeriesSummary(ToFloatArray(FrameTransitions)));
+	Root->SetNumberField(TEXT("TotalTransitions"), TotalTransitions);
+	Root->SetObjectField(TEXT("Transitions"), TransitionsObject);
+
+	FString Json;
+	const TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Root, Writer);
+	return Json;
+}
+
+FString FMonsterBenchmarkResults::ToCsv() const
+{
+	FString Csv = TEXT("Frame,FrameMs,MonsterMs,Traces,Transitions\n");
+	for (int32 Frame = 0; Frame < FrameTimesMs.Num(); ++Frame)
+	{
+		Csv += FString::Printf(TEXT("%d,%.4f,%.4f,%d,%d\n"), Frame, FrameTimesMs[Frame], MonsterTimesMs[Frame], FrameTraces[Frame], FrameTransitions[Frame]);
+	}
+	return Csv;
+}
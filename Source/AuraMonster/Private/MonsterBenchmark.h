@@ -0,0 +1,124 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Templates/SubclassOf.h"
+#include "MonsterBehaviorState.h"
+#include "MonsterBenchmarkLevel.h"
+
+class AMonsterCharacter;
+class AMonsterAIController;
+
+/**
+ * What a monster benchmark runs
+ */
+struct FMonsterBenchmarkSettings
+{
+	/** Map to load (empty = an empty world) */
+	FString MapName;
+
+	/** Whether to build a generated level into the world */
+	bool bGenerateLevel;
+
+	/** Layout of the generated level; its seed is taken from Seed */
+	FMonsterBenchmarkLevelSettings Level;
+
+	/** Whether to build a navmesh over the generated level, so standing patrols find destinations */
+	bool bBuildNavigation;
+
+	/** Monsters to spawn */
+	int32 NumMonsters;
+
+	/** Share of the monsters starting in each behavior state (weights, they don't need to add up to 1) */
+	float IdleWeight;
+	float PatrolStandingWeight;
+	float PatrolCrawlingWeight;
+
+	/** Chance of idle monsters going on patrol when an idle spell ends (-1 = the controller's own) */
+	float PatrolTransitionChance;
+
+	/** Frames run before measuring, so monsters are spread over their behaviors */
+	int32 WarmupFrames;
+
+	/** Frames measured */
+	int32 NumFrames;
+
+	/** Seconds every frame simulates */
+	float FixedDeltaTime;
+
+	/** Seed of the level, the spawn points and the monsters' random streams */
+	int32 Seed;
+
+	/** LOD tier forced on every monster for the run (-1 = leave it to distance and visibility) */
+	int32 ForceLODTier;
+
+	/** Whether to put a player viewpoint in the first room, for distance-based LOD and budget priorities */
+	bool bSpawnViewer;
+
+	/** Monster and controller classes to spawn */
+	TSubclassOf<AMonsterCharacter> MonsterClass;
+	TSubclassOf<AMonsterAIController> ControllerClass;
+
+	FMonsterBenchmarkSettings();
+};
+
+/**
+ * What a monster benchmark measured, one entry per measured frame
+ */
+struct FMonsterBenchmarkResults
+{
+	/** Milliseconds of the whole world tick */
+	TArray<float> FrameTimesMs;
+
+	/** Milliseconds of monster AI, as reported to UMonsterBudgetSubsystem by controllers, the tick manager and surface pathfinding */
+	TArray<float> MonsterTimesMs;
+
+	/** Surface traces issued, as reported to UMonsterBudgetSubsystem */
+	TArray<int32> FrameTraces;
+
+	/** Behavior state transitions */
+	TArray<int32> FrameTransitions;
+
+	/** Transitions of the whole run by kind ("Idle->PatrolCrawling") */
+	TMap<FString, int32> TransitionCounts;
+
+	/** Monsters spawned in each behavior state */
+	TMap<FString, int32> InitialStateCounts;
+
+	/** Monsters spawned */
+	int32 NumMonsters;
+
+	/** Whether a navmesh was built over the generated level */
+	bool bBuiltNavigation;
+
+	FMonsterBenchmarkResults()
+		: NumMonsters(0)
+		, bBuiltNavigation(false)
+	{
+	}
+
+	/** Nearest-rank percentile (0-100) of a series */
+	static float GetPercentile(TArray<float> Values, float Percentile);
+
+	/** Settings and summary (percentiles, means, transition counts) as JSON */
+	FString ToJson(const FMonsterBenchmarkSettings& Settings) const;
+
+	/** Per-frame measurements as CSV */
+	FString ToCsv() const;
+};
+
+/**
+ * Runs monsters at scale in a world of its own, frame by frame with a fixed delta time, so runs are
+ * repeatable on any machine (including headless with -nullrhi). Used by UMonsterBenchmarkCommandlet.
+ */
+namespace MonsterBenchmark
+{
+	/**
+	 * Create the world, spawn the monsters, run the frames and tear the world down again
+	 * @param Settings What to run
+	 * @param OutResults Receives the measurements
+	 * @return False if the world couldn't be set up
+	 */
+	bool Run(const FMonsterBenchmarkSettings& Settings, FMonsterBenchmarkResults& OutResults);
+}
@@ -0,0 +1,97 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterBenchmarkCommandlet.h"
+#include "MonsterBenchmark.h"
+#include "MonsterCharacter.h"
+#include "MonsterAIController.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/DateTime.h"
+#include "Misc/Parse.h"
+
+DEFINE_LOG_CATEGORY_STATIC(LogMonsterBenchmarkCommandlet, Log, All);
+
+UMonsterBenchmarkCommandlet::UMonsterBenchmarkCommandlet()
+{
+	IsClient = false;
+	IsEditor = false;
+	IsServer = true;
+	LogToConsole = true;
+}
+
+int32 UMonsterBenchmarkCommandlet::Main(const FString& Params)
+{
+	FMonsterBenchmarkSettings Settings;
+	FParse::Value(*Params, TEXT("Map="), Settings.MapName);
+	FParse::Value(*Params, TEXT("Monsters="), Settings.NumMonsters);
+	FParse::Value(*Params, TEXT("Idle="), Settings.IdleWeight);
+	FParse::Value(*Params, TEXT("Standing="), Settings.PatrolStandingWeight);
+	FParse::Value(*Params, TEXT("Crawling="), Settings.PatrolCrawlingWeight);
+	FParse::Value(*Params, TEXT("PatrolChance="), Settings.PatrolTransitionChance);
+	FParse::Value(*Params, TEXT("Frames="), Settings.NumFrames);
+	FParse::Value(*Params, TEXT("Warmup="), Settings.WarmupFrames);
+	FParse::Value(*Params, TEXT("DeltaTime="), Settings.FixedDeltaTime);
+	FParse::Value(*Params, TEXT("Seed="), Settings.Seed);
+	FParse::Value(*Params, TEXT("Rooms="), Settings.Level.NumRooms);
+	FParse::Value(*Params, TEXT("LODTier="), Settings.ForceLODTier);
+	Settings.bGenerateLevel = !FParse::Param(*Params, TEXT("NoLevel"));
+	Settings.bBuildNavigation = !FParse::Param(*Params, TEXT("NoNavigation"));
+	Settings.bSpawnViewer = !FParse::Param(*Params, TEXT("NoViewer"));
+
+	FString ClassPath;
+	if (FParse::Value(*Params, TEXT("MonsterClass="), ClassPath))
+	{
+		Settings.MonsterClass = LoadClass<AMonsterCharacter>(nullptr, *ClassPath);
+		if (!Settings.MonsterClass)
+		{
+			UE_LOG(LogMonsterBenchmarkCommandlet, Error, TEXT("%s is not a monster character class"), *ClassPath);
+			return 1;
+		}
+	}
+	if (FParse::Value(*Params, TEXT("ControllerClass="), ClassPath))
+	{
+		Settings.ControllerClass = LoadClass<AMonsterAIController>(nullptr, *ClassPath);
+		if (!Settings.ControllerClass)
+		{
+			UE_LOG(LogMonsterBenchmarkCommandlet, Error, TEXT("%s is not a monster AI controller class"), *ClassPath);
+			return 1;
+		}
+	}
+
+	FString OutputPath;
+	if (!FParse::Value(*Params, TEXT("Output="), OutputPath))
+	{
+		OutputPath = FPaths::Combine(FPaths::ProjectSavedDir(), TEXT("MonsterBenchmark"), FString::Printf(TEXT("MonsterBenchmark-%s"), *FDateTime::Now().ToString()));
+	}
+
+	UE_LOG(LogMonsterBenchmarkCommandlet, Display, TEXT("Running %d monsters for %d frames (%d warmup) of %.4f s"), Settings.NumMonsters, Settings.NumFrames, Settings.WarmupFrames, Settings.FixedDeltaTime);
+
+	FMonsterBenchmarkResults Results;
+	if (!MonsterBenchmark::Run(Settings, Results))
+	{
+		UE_LOG(LogMonsterBenchmarkCommandlet, Error, TEXT("The benchmark world couldn't be set up"));
+		return 1;
+	}
+
+	const FString Json = Results.ToJson(Settings);
+	if (!FFileHelper::SaveStringToFile(Json, *(OutputPath + TEXT(".json"))) || !FFileHelper::SaveStringToFile(Results.ToCsv(), *(OutputPath + TEXT(".csv"))))
+	{
+		UE_LOG(LogMonsterBenchmarkCommandlet, Error, TEXT("Couldn't write the results to %s"), *OutputPath);
+		return 1;
+	}
+
+	int32 TotalTraces = 0;
+	for (const int32 FrameTraces : Results.FrameTraces)
+	{
+		TotalTraces += FrameTraces;
+	}
+
+	UE_LOG(LogMonsterBenchmarkCommandlet, Display, TEXT("%d monsters: %.3f ms/frame median, %.3f ms p99, %.3f ms monster AI median, %.1f traces/frame"),
+		Results.NumMonsters,
+		FMonsterBenchmarkResults::GetPercentile(Results.FrameTimesMs, 50.0f),
+		FMonsterBenchmarkResults::GetPercentile(Results.FrameTimesMs, 99.0f),
+		FMonsterBenchmarkResults::GetPercentile(Results.MonsterTimesMs, 50.0f),
+		Results.FrameTraces.Num() > 0 ? static_cast<float>(TotalTraces) / Results.FrameTraces.Num() : 0.0f);
+	UE_LOG(LogMonsterBenchmarkCommandlet, Display, TEXT("Results written to %s.json and %s.csv"), *OutputPath, *OutputPath);
+	return 0;
+}
@@ -0,0 +1,210 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterBenchmarkLevel.h"
+#include "Engine/World.h"
+#include "Engine/StaticMesh.h"
+#include "Engine/StaticMeshActor.h"
+#include "Components/StaticMeshComponent.h"
+#include "Math/RandomStream.h"
+
+namespace
+{
+	/** Engine cube used for every piece; 100 units along each axis, pivot at its center */
+	const TCHAR* CubeMeshPath = TEXT("/Engine/BasicShapes/Cube.Cube");
+	constexpr float CubeHalfSize = 50.0f;
+
+	/** Grid directions rooms connect in; opposite directions are two apart */
+	const FIntPoint GridDirections[4] = { FIntPoint(1, 0), FIntPoint(0, 1), FIntPoint(-1, 0), FIntPoint(0, -1) };
+
+	/** Chance of the next room branching off an earlier room instead of the latest one */
+	constexpr float BranchChance = 0.3f;
+
+	/** Spawns the axis-aligned boxes a level is made of */
+	struct FLevelBuilder
+	{
+		UWorld* World;
+		UStaticMesh* CubeMesh;
+		float Thickness;
+
+		void AddBox(const FVector& Center, const FVector& Extent) const
+		{
+			const FTransform Transform(FQuat::Identity, Center, Extent / CubeHalfSize);
+			AStaticMeshActor* Box = World->SpawnActorDeferred<AStaticMeshActor>(AStaticMeshActor::StaticClass(), Transform);
+			if (Box)
+			{
+				Box->GetStaticMeshComponent()->SetStaticMesh(CubeMesh);
+				Box->FinishSpawning(Transform);
+			}
+		}
+
+		/**
+		 * Add a box given in a frame turned towards a grid direction
+		 * @param Origin Frame origin
+		 * @param Direction Grid direction the frame's forward axis points in
+		 * @param Offset Box center as (forward, side, up) in the frame
+		 * @param Extent Box half size as (forward, side, up) in the frame
+		 */
+		void AddBox(const FVector& Origin, const FIntPoint& Direction, const FVector& Offset, const FVector& Extent) const
+		{
+			const FVector Forward(Direction.X, Direction.Y, 0.0f);
+			const FVector Side(-Direction.Y, Direction.X, 0.0f);
+			const FVector Center = Origin + Forward * Offset.X + Side * Offset.Y + FVector::UpVector * Offset.Z;
+			AddBox(Center, Forward.GetAbs() * Extent.X + Side.GetAbs() * Extent.Y + FVector::UpVector * Extent.Z);
+		}
+
+		/**
+		 * Add a horizontal slab, optionally with a square hole in its middle
+		 * @param Center Slab center
+		 * @param HalfSize Half the slab's edge length
+		 * @param HoleHalfSize Half the hole's edge length (0 = no hole)
+		 */
+		void AddSlab(const FVector& Center, float HalfSize, float HoleHalfSize) const
+		{
+			if (HoleHalfSize <= 0.0f)
+			{
+				AddBox(Center, FVector(HalfSize, HalfSize, Thickness * 0.5f));
+				return;
+			}
+
+			// Two full-width strips on either side of the hole, and two short ones closing its ends
+			const float StripHalfWidth = (HalfSize - HoleHalfSize) * 0.5f;
+			const float StripOffset = HoleHalfSize + StripHalfWidth;
+			for (const float Sign : { -1.0f, 1.0f })
+			{
+				AddBox(Center + FVector(0.0f, Sign * StripOffset, 0.0f), FVector(HalfSize, StripHalfWidth, Thickness * 0.5f));
+				AddBox(Center + FVector(Sign * StripOffset, 0.0f, 0.0f), FVector(StripHalfWidth, HoleHalfSize, Thickness * 0.5f));
+			}
+		}
+
+		/**
+		 * Add one wall of a room, from just below its floor to just above its ceiling
+		 * @param RoomCenter Center of the room's floor
+		 * @param Direction Side of the room the wall is on
+		 * @param RoomHalfSize Half the room's edge length
+		 * @param Height Room height
+		 * @param DoorHalfWidth Half the width of a doorway in the wall's middle (0 = no doorway)
+		 * @param DoorHeight Height of the doorway
+		 */
+		void AddWall(const FVector& RoomCenter, const FIntPoint& Direction, float RoomHalfSize, float Height, float DoorHalfWidth, float DoorHeight) const
+		{
+			const float WallOffset = RoomHalfSize + Thickness * 0.5f;
+			const float WallHalfLength = RoomHalfSize + Thickness;
+			const float WallHalfHeight = Height * 0.5f + Thickness;
+			if (DoorHalfWidth <= 0.0f)
+			{
+				AddBox(RoomCenter, Direction, FVector(WallOffset, 0.0f, Height * 0.5f), FVector(Thickness * 0.5f, WallHalfLength, WallHalfHeight));
+				return;
+			}
+
+			// Posts on either side of the doorway, and a lintel above it
+			const float PostHalfLength = (WallHalfLength - DoorHalfWidth) * 0.5f;
+			for (const float Sign : { -1.0f, 1.0f })
+			{
+				AddBox(RoomCenter, Direction, FVector(WallOffset, Sign * (DoorHalfWidth + PostHalfLength), Height * 0.5f), FVector(Thickness * 0.5f, PostHalfLength, WallHalfHeight));
+			}
+
+			const float LintelHalfHeight = (Height + Thickness - DoorHeight) * 0.5f;
+			AddBox(RoomCenter, Direction, FVector(WallOffset, 0.0f, DoorHeight + LintelHalfHeight), FVector(Thickness * 0.5f, DoorHalfWidth, LintelHalfHeight));
+		}
+	};
+}
+
+bool MonsterBenchmarkLevel::Generate(UWorld* World, const FMonsterBenchmarkLevelSettings& Settings, TArray<FBox>& OutRooms)
+{
+	OutRooms.Reset();
+
+	UStaticMesh* CubeMesh = LoadObject<UStaticMesh>(nullptr, CubeMeshPath);
+	if (!World || !CubeMesh)
+	{
+		return false;
+	}
+
+	// Lay the rooms out on a grid, each next to an earlier one, remembering the doorways between them
+	FRandomStream RandomStream(Settings.Seed);
+	TArray<FIntPoint> Cells;
+	TArray<uint8> Doorways;
+	Cells.Add(FIntPoint::ZeroValue);
+	Doorways.Add(0);
+
+	while (Cells.Num() < FMath::Max(1, Settings.NumRooms))
+	{
+		// Mostly grow from the latest room, sometimes branch off an earlier one; a room with free neighbours always exists
+		const int32 FirstCandidate = RandomStream.FRand() < BranchChance ? RandomStream.RandHelper(Cells.Num()) : Cells.Num() - 1;
+		for (int32 Step = 0; Step < Cells.Num(); ++Step)
+		{
+			const int32 From = (FirstCandidate + Cells.Num() - Step) % Cells.Num();
+
+			int32 FreeDirections[4];
+			int32 NumFreeDirections = 0;
+			for (int32 DirectionIndex = 0; DirectionIndex < 4; ++DirectionIndex)
+			{
+				if (!Cells.Contains(Cells[From] + GridDirections[DirectionIndex]))
+				{
+					FreeDirections[NumFreeDirections++] = DirectionIndex;
+				}
+			}
+
+			if (NumFreeDirections > 0)
+			{
+				const int32 DirectionIndex = FreeDirections[RandomStream.RandHelper(NumFreeDirections)];
+				Cells.Add(Cells[From] + GridDirections[DirectionIndex]);
+				Doorways[From] |= 1 << DirectionIndex;
+				Doorways.Add(1 << ((DirectionIndex + 2) % 4));
+				break;
+			}
+		}
+	}
+
+	const FLevelBuilder Builder{ World, CubeMesh, Settings.WallThickness };
+	const float RoomHalfSize = Settings.RoomSize * 0.5f;
+	const float CellSize = Settings.RoomSize + Settings.WallThickness * 2.0f + Settings.CorridorLength;
+	const float Thickness = Settings.WallThickness;
+
+	for (int32 RoomIndex = 0; RoomIndex < Cells.Num(); ++RoomIndex)
+	{
+		const FVector RoomCenter(Cells[RoomIndex].X * CellSize, Cells[RoomIndex].Y * CellSize, 0.0f);
+		const bool bHasShaft = RandomStream.FRand() < Settings.ShaftChance;
+		const float ShaftHalfSize = bHasShaft ? FMath::Min(Settings.ShaftSize * 0.5f, RoomHalfSize * 0.5f) : 0.0f;
+
+		Builder.AddSlab(RoomCenter - FVector(0.0f, 0.0f, Thickness * 0.5f), RoomHalfSize + Thickness, 0.0f);
+		Builder.AddSlab(RoomCenter + FVector(0.0f, 0.0f, Settings.RoomHeight + Thickness * 0.5f), RoomHalfSize + Thickness, ShaftHalfSize);
+
+		for (int32 DirectionIndex = 0; DirectionIndex < 4; ++DirectionIndex)
+		{
+			const bool bHasDoorway = (Doorways[RoomIndex] & (1 << DirectionIndex)) != 0;
+			Builder.AddWall(RoomCenter, GridDirections[DirectionIndex], RoomHalfSize, Settings.RoomHeight,
+				bHasDoorway ? Settings.CorridorWidth * 0.5f : 0.0f, FMath::Min(Settings.CorridorHeight, Settings.RoomHeight));
+
+			// Each corridor is built by the room on its positive side
+			if (bHasDoorway && DirectionIndex < 2)
+			{
+				const float CorridorHalfLength = Settings.CorridorLength * 0.5f;
+				const float CorridorHalfWidth = Settings.CorridorWidth * 0.5f;
+				const FVector CorridorStart = RoomCenter + FVector(GridDirections[DirectionIndex].X, GridDirections[DirectionIndex].Y, 0.0f) * (RoomHalfSize + Thickness);
+				const FIntPoint& Direction = GridDirections[DirectionIndex];
+
+				Builder.AddBox(CorridorStart, Direction, FVector(CorridorHalfLength, 0.0f, -Thickness * 0.5f), FVector(CorridorHalfLength, CorridorHalfWidth + Thickness, Thickness * 0.5f));
+				Builder.AddBox(CorridorStart, Direction, FVector(CorridorHalfLength, 0.0f, Settings.CorridorHeight + Thickness * 0.5f), FVector(CorridorHalfLength, CorridorHalfWidth + Thickness, Thickness * 0.5f));
+				for (const float Sign : { -1.0f, 1.0f })
+				{
+					Builder.AddBox(CorridorStart, Direction, FVector(CorridorHalfLength, Sign * (CorridorHalfWidth + Thickness * 0.5f), Settings.CorridorHeight * 0.5f), FVector(CorridorHalfLength, Thickness * 0.5f, Settings.CorridorHeight * 0.5f));
+				}
+			}
+		}
+
+		// A closed shaft rising out of the hole in the ceiling
+		if (bHasShaft)
+		{
+			const FVector ShaftBase = RoomCenter + FVector(0.0f, 0.0f, Settings.RoomHeight + Thickness);
+			for (int32 DirectionIndex = 0; DirectionIndex < 4; ++DirectionIndex)
+			{
+				Builder.AddWall(ShaftBase, GridDirections[DirectionIndex], ShaftHalfSize, Settings.ShaftHeight, 0.0f, 0.0f);
+			}
+			Builder.AddSlab(ShaftBase + FVector(0.0f, 0.0f, Settings.ShaftHeight + Thickness * 0.5f), ShaftHalfSize + Thickness, 0.0f);
+		}
+
+		OutRooms.Add(FBox(RoomCenter - FVector(RoomHalfSize, RoomHalfSize, 0.0f), RoomCenter + FVector(RoomHalfSize, RoomHalfSize, Settings.RoomHeight)));
+	}
+
+	return true;
+}
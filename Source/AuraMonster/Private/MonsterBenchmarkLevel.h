@@ -0,0 +1,78 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class UWorld;
+
+/**
+ * Layout of a procedurally generated benchmark level
+ */
+struct FMonsterBenchmarkLevelSettings
+{
+	/** Number of rooms, chained by corridors */
+	int32 NumRooms;
+
+	/** Edge length of the square rooms */
+	float RoomSize;
+
+	/** Height of the rooms */
+	float RoomHeight;
+
+	/** Length of the corridors between rooms */
+	float CorridorLength;
+
+	/** Width of the corridors and of the doorways they open into */
+	float CorridorWidth;
+
+	/** Height of the corridors and of the doorways they open into */
+	float CorridorHeight;
+
+	/** Chance of a room having a vertical shaft rising out of its ceiling */
+	float ShaftChance;
+
+	/** Edge length of the square shafts */
+	float ShaftSize;
+
+	/** Height of the shafts above the room ceiling */
+	float ShaftHeight;
+
+	/** Thickness of floors, walls and ceilings */
+	float WallThickness;
+
+	/** Seed of the layout */
+	int32 Seed;
+
+	FMonsterBenchmarkLevelSettings()
+		: NumRooms(8)
+		, RoomSize(1600.0f)
+		, RoomHeight(600.0f)
+		, CorridorLength(800.0f)
+		, CorridorWidth(400.0f)
+		, CorridorHeight(300.0f)
+		, ShaftChance(0.5f)
+		, ShaftSize(400.0f)
+		, ShaftHeight(1200.0f)
+		, WallThickness(40.0f)
+		, Seed(0)
+	{
+	}
+};
+
+/**
+ * Builds benchmark levels out of engine cube meshes: rooms on a grid, joined by corridors through doorways,
+ * some with a shaft rising out of the ceiling. Floors, walls, ceilings, doorway edges and shaft rims give
+ * crawlers every kind of surface transition (floor to wall, wall to ceiling, convex edges and vertical climbs).
+ */
+namespace MonsterBenchmarkLevel
+{
+	/**
+	 * Spawn a level into a world; call before the world begins play
+	 * @param World World to spawn the level into
+	 * @param Settings Layout of the level
+	 * @param OutRooms Receives the inside of each room, floor at Min.Z
+	 * @return False if the cube mesh couldn't be loaded
+	 */
+	bool Generate(UWorld* World, const FMonsterBenchmarkLevelSettings& Settings, TArray<FBox>& OutRooms);
+}
@@ -0,0 +1,271 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterBudgetSubsystem.h"
+#include "Engine/World.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarMonsterBudgetMilliseconds(
+	TEXT("AuraMonster.Budget.MillisecondsPerFrame"),
+	0.0f,
+	TEXT("Game thread milliseconds monster AI updates may take per frame; the least important updates wait for a later frame once it is spent (0 = unlimited)."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMonsterBudgetTraces(
+	TEXT("AuraMonster.Budget.TracesPerFrame"),
+	0,
+	TEXT("Surface traces monsters may issue per frame; crawl target searches wait for a later frame once they are spent (0 = unlimited)."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMonsterBudgetPriorityDistance(
+	TEXT("AuraMonster.Budget.PriorityDistance"),
+	5000.0f,
+	TEXT("Distance to the nearest viewer from which monsters get no priority for being close."),
+	ECVF_Default);
+
+namespace MonsterBudget
+{
+	/** Priority a second of waiting adds; a monster far away outranks a fresh one next to a viewer after a quarter second */
+	constexpr float WaitPriorityPerSecond = 4.0f;
+
+	/** Priority added to urgent work, ahead of anything that is merely waiting */
+	constexpr float UrgentPriority = 10.0f;
+
+	/** Seconds after which a queued request or grant whose requester stopped asking is dropped */
+	constexpr float RequestLifetime = 1.0f;
+}
+
+UMonsterBudgetSubsystem::UMonsterBudgetSubsystem()
+{
+	CurrentFrame = 0;
+	SpentSeconds = 0.0;
+	SpentTraces = 0;
+	NumDeferredUpdates = 0;
+}
+
+bool UMonsterBudgetSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Only game worlds have monsters ticking
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UMonsterBudgetSubsystem::Deinitialize()
+{
+	TraceRequests.Reset();
+	GrantedTraces.Reset();
+
+	Super::Deinitialize();
+}
+
+float UMonsterBudgetSubsystem::GetFrameTimeBudgetMs()
+{
+	return FMath::Max(0.0f, CVarMonsterBudgetMilliseconds.GetValueOnGameThread());
+}
+
+int32 UMonsterBudgetSubsystem::GetFrameTraceBudget()
+{
+	return FMath::Max(0, CVarMonsterBudgetTraces.GetValueOnGameThread());
+}
+
+void UMonsterBudgetSubsystem::ReportTime(double Seconds)
+{
+	BeginFrameIfNeeded();
+	SpentSeconds += Seconds;
+}
+
+void UMonsterBudgetSubsystem::ReportTraces(int32 NumTraces)
+{
+	BeginFrameIfNeeded();
+	SpentTraces += NumTraces;
+}
+
+float UMonsterBudgetSubsystem::GetRemainingTimeMs()
+{
+	const float BudgetMs = GetFrameTimeBudgetMs();
+	if (BudgetMs <= 0.0f)
+	{
+		return MAX_flt;
+	}
+
+	BeginFrameIfNeeded();
+	return BudgetMs - static_cast<float>(SpentSeconds * 1000.0);
+}
+
+float UMonsterBudgetSubsystem::GetUpdatePriority(const FVector& Location, float OverdueTime, bool bUrgent)
+{
+	BeginFrameIfNeeded();
+
+	// 1 next to a viewer, falling to 0 at the priority distance
+	const float PriorityDistance = FMath::Max(1.0f, CVarMonsterBudgetPriorityDistance.GetValueOnGameThread());
+	const float Proximity = 1.0f - FMath::Min(GetDistanceToNearestViewer(Location) / PriorityDistance, 1.0f);
+
+	// Waiting raises the priority, so deferred monsters always get their turn
+	return Proximity + FMath::Max(0.0f, OverdueTime) * MonsterBudget::WaitPriorityPerSecond + (bUrgent ? MonsterBudget::UrgentPriority : 0.0f);
+}
+
+bool UMonsterBudgetSubsystem::ShouldDeferUpdate(float Priority)
+{
+	if (Priority >= 1.0f || !IsTimeBudgetSpent())
+	{
+		return false;
+	}
+
+	++NumDeferredUpdates;
+	return true;
+}
+
+bool UMonsterBudgetSubsystem::TryReserveTraces(const UObject* Requester, const FVector& Location, int32 NumTraces, bool bUrgent)
+{
+	const int32 TraceBudget = GetFrameTraceBudget();
+	BeginFrameIfNeeded();
+
+	if (TraceBudget <= 0)
+	{
+		SpentTraces += NumTraces;
+		return true;
+	}
+
+	// Granted at the start of a frame, and already counted then
+	const TWeakObjectPtr<const UObject> RequesterPtr(Requester);
+	if (GrantedTraces.Remove(RequesterPtr) > 0)
+	{
+		return true;
+	}
+
+	// Go ahead while the budget lasts, unless others were already waiting for it (urgent work doesn't wait in line)
+	const int32 RequestIndex = TraceRequests.IndexOfByPredicate([&RequesterPtr](const FTraceRequest& Request) { return Request.Requester == RequesterPtr; });
+	if ((TraceRequests.Num() == 0 || bUrgent) && SpentTraces + NumTraces <= TraceBudget)
+	{
+		if (RequestIndex != INDEX_NONE)
+		{
+			TraceRequests.RemoveAtSwap(RequestIndex);
+		}
+
+		SpentTraces += NumTraces;
+		return true;
+	}
+
+	const float Now = GetWorld()->GetTimeSeconds();
+	FTraceRequest* Request = RequestIndex != INDEX_NONE ? &TraceRequests[RequestIndex] : nullptr;
+	if (!Request)
+	{
+		Request = &TraceRequests.AddDefaulted_GetRef();
+		Request->Requester = RequesterPtr;
+		Request->FirstTime = Now;
+	}
+
+	Request->Location = Location;
+	Request->NumTraces = NumTraces;
+	Request->bUrgent = bUrgent;
+	Request->LastTime = Now;
+	return false;
+}
+
+void UMonsterBudgetSubsystem::BeginFrameIfNeeded()
+{
+	if (CurrentFrame == GFrameCounter)
+	{
+		return;
+	}
+
+	CurrentFrame = GFrameCounter;
+	SpentSeconds = 0.0;
+	SpentTraces = 0;
+	NumDeferredUpdates = 0;
+
+	ViewLocations.Reset();
+	if (UWorld* World = GetWorld())
+	{
+		for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+		{
+			if (APlayerController* PlayerController = It->Get())
+			{
+				FVector ViewLocation;
+				FRotator ViewRotation;
+				PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+				ViewLocations.Add(ViewLocation);
+			}
+		}
+	}
+
+	GrantTraceRequests();
+}
+
+void UMonsterBudgetSubsystem::GrantTraceRequests()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	// Forget requesters that went away or stopped asking (e.g. left the crawl state)
+	const float Now = World->GetTimeSeconds();
+	for (auto It = GrantedTraces.CreateIterator(); It; ++It)
+	{
+		if (!It.Key().IsValid() || Now - It.Value() > MonsterBudget::RequestLifetime)
+		{
+			It.RemoveCurrent();
+		}
+	}
+	TraceRequests.RemoveAllSwap([Now](const FTraceRequest& Request)
+	{
+		return !Request.Requester.IsValid() || Now - Request.LastTime > MonsterBudget::RequestLifetime;
+	});
+
+	const int32 TraceBudget = GetFrameTraceBudget();
+	if (TraceRequests.Num() == 0 || TraceBudget <= 0)
+	{
+		return;
+	}
+
+	// Queued requests are few, so sort them whole
+	TArray<float, TInlineAllocator<64>> Priorities;
+	Priorities.SetNumUninitialized(TraceRequests.Num());
+	for (int32 Index = 0; Index < TraceRequests.Num(); ++Index)
+	{
+		const FTraceRequest& Request = TraceRequests[Index];
+		Priorities[Index] = GetUpdatePriority(Request.Location, Now - Request.FirstTime, Request.bUrgent);
+	}
+
+	TArray<int32, TInlineAllocator<64>> Order;
+	Order.SetNumUninitialized(TraceRequests.Num());
+	for (int32 Index = 0; Index < Order.Num(); ++Index)
+	{
+		Order[Index] = Index;
+	}
+	Order.Sort([&Priorities](int32 A, int32 B) { return Priorities[A] > Priorities[B]; });
+
+	// The first request always gets through, so one larger than the whole budget can't wait forever
+	TArray<int32, TInlineAllocator<64>> Granted;
+	for (const int32 Index : Order)
+	{
+		const FTraceRequest& Request = TraceRequests[Index];
+		if (Granted.Num() > 0 && SpentTraces + Request.NumTraces > TraceBudget)
+		{
+			break;
+		}
+
+		SpentTraces += Request.NumTraces;
+		GrantedTraces.Add(Request.Requester, Now);
+		Granted.Add(Index);
+	}
+
+	Granted.Sort([](int32 A, int32 B) { return A > B; });
+	for (const int32 Index : Granted)
+	{
+		TraceRequests.RemoveAtSwap(Index);
+	}
+}
+
+float UMonsterBudgetSubsystem::GetDistanceToNearestViewer(const FVector& Location) const
+{
+	float ClosestDistanceSq = MAX_flt;
+	for (const FVector& ViewLocation : ViewLocations)
+	{
+		ClosestDistanceSq = FMath::Min(ClosestDistanceSq, FVector::DistSquared(ViewLocation, Location));
+	}
+
+	return ViewLocations.Num() > 0 ? FMath::Sqrt(ClosestDistanceSq) : MAX_flt;
+}
@@ -3,10 +3,50 @@
 #include "MonsterCharacter.h"
 #include "MonsterAIController.h"
 #include "SurfacePathfindingComponent.h"
+#include "MonsterLODSubsystem.h"
+#include "MonsterAnimInstance.h"
+#include "MonsterMovementComponent.h"
+#include "AuraMonsterStats.h"
+#include "Components/SkeletalMeshComponent.h"
 #include "GameFramework/CharacterMovementComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+#include "Misc/Crc.h"
+
+static TAutoConsoleVariable<int32> CVarMonsterRandomSeed(
+	TEXT("AuraMonster.RandomSeed"),
+	0,
+	TEXT("When non-zero, monsters with the Random seed policy are seeded from this and their name instead, so a whole run can be replayed. Read when monsters spawn."),
+	ECVF_Default);
+
+namespace
+{
+	/** Add monsters to (or with a negative count, remove them from) the stat counting monsters in a behavior state */
+	void AddToStateStat(EMonsterBehaviorState State, int32 Count)
+	{
+		switch (State)
+		{
+			case EMonsterBehaviorState::Idle:
+				INC_DWORD_STAT_BY(STAT_AuraMonster_MonstersIdle, Count);
+				break;
+
+			case EMonsterBehaviorState::PatrolStanding:
+				INC_DWORD_STAT_BY(STAT_AuraMonster_MonstersPatrolStanding, Count);
+				break;
+
+			case EMonsterBehaviorState::PatrolCrawling:
+				INC_DWORD_STAT_BY(STAT_AuraMonster_MonstersPatrolCrawling, Count);
+				break;
+
+			default:
+				break;
+		}
+	}
+}
 
 // Sets default values
-AMonsterCharacter::AMonsterCharacter()
+AMonsterCharacter::AMonsterCharacter(const FObjectInitializer& ObjectInitializer)
+	: Super(ObjectInitializer.SetDefaultSubobjectClass<UMonsterMovementComponent>(ACharacter::CharacterMovementComponentName))
 {
  	// Set this character to call Tick() every frame.
 	PrimaryActorTick.bCanEverTick = true;
@@ -18,20 +58,86 @@ AMonsterCharacter::AMonsterCharacter()
 	PatrolStandingSpeed = 300.0f;
 	PatrolCrawlingSpeed = 150.0f;
 
+	// Set default AI LOD tiers
+	bUseAILOD = true;
+	FullRateLOD = FMonsterLODSettings(2500.0f, 0.0f, 0.0f, true);
+	ReducedRateLOD = FMonsterLODSettings(6000.0f, 0.1f, 0.25f, true);
+	SimulationOnlyLOD = FMonsterLODSettings(0.0f, 0.25f, 1.0f, false);
+	RecentlyRenderedTolerance = 0.5f;
+	CurrentLODTier = EMonsterLODTier::FullRate;
+
+	RandomSeedPolicy = EMonsterRandomSeedPolicy::Random;
+	RandomSeed = 0;
+
+	bCountedInStateStats = false;
+
 	// Create and configure surface pathfinding component
 	SurfacePathfinding = CreateDefaultSubobject<USurfacePathfindingComponent>(TEXT("SurfacePathfinding"));
 }
 
+void AMonsterCharacter::PostInitializeComponents()
+{
+	// Seed before the default controller is spawned and possesses us, as it draws from the stream right away
+	RandomStream.Initialize(MakeSpawnRandomSeed(FCrc::StrCrc32(*GetName())));
+
+	Super::PostInitializeComponents();
+}
+
+int32 AMonsterCharacter::MakeRandomSeed(EMonsterRandomSeedPolicy Policy, int32 BaseSeed, uint32 MonsterKey)
+{
+	switch (Policy)
+	{
+		case EMonsterRandomSeedPolicy::Fixed:
+			return BaseSeed;
+
+		case EMonsterRandomSeedPolicy::FixedPerMonster:
+			return static_cast<int32>(HashCombine(static_cast<uint32>(BaseSeed), MonsterKey));
+
+		default:
+		{
+			const int32 GlobalSeed = CVarMonsterRandomSeed.GetValueOnGameThread();
+			return GlobalSeed != 0 ? static_cast<int32>(HashCombine(static_cast<uint32>(GlobalSeed), MonsterKey)) : FMath::Rand();
+		}
+	}
+}
+
 // Called when the game starts or when spawned
 void AMonsterCharacter::BeginPlay()
 {
+	// Counted before Super, so state changes from Blueprint BeginPlay move the count along
+	AddToStateStat(CurrentBehaviorState, 1);
+	bCountedInStateStats = true;
+
 	Super::BeginPlay();
 	
 	// Initialize movement speed based on initial state
-	if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
+	ApplyMovementForState(CurrentBehaviorState);
+
+	if (bUseAILOD)
+	{
+		ApplyLODSettings();
+
+		if (UMonsterLODSubsystem* LODSubsystem = GetWorld()->GetSubsystem<UMonsterLODSubsystem>())
+		{
+			LODSubsystem->RegisterMonster(this);
+		}
+	}
+}
+
+void AMonsterCharacter::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	if (UMonsterLODSubsystem* LODSubsystem = GetWorld()->GetSubsystem<UMonsterLODSubsystem>())
+	{
+		LODSubsystem->UnregisterMonster(this);
+	}
+
+	if (bCountedInStateStats)
 	{
-		MovementComp->MaxWalkSpeed = GetMovementSpeedForState(CurrentBehaviorState);
+		AddToStateStat(CurrentBehaviorState, -1);
+		bCountedInStateStats = false;
 	}
+
+	Super::EndPlay(EndPlayReason);
 }
 
 // Called every frame
@@ -46,6 +152,86 @@ void AMonsterCharacter::SetupPlayerInputComponent(UInputComponent* PlayerInputCo
 	Super::SetupPlayerInputComponent(PlayerInputComponent);
 }
 
+void AMonsterCharacter::PossessedBy(AController* NewController)
+{
+	Super::PossessedBy(NewController);
+
+	// A controller possessing us after BeginPlay still needs the current tier's tick interval
+	if (bUseAILOD && HasActorBegunPlay())
+	{
+		ApplyLODSettings();
+	}
+}
+
+UMonsterAnimInstance* AMonsterCharacter::GetMonsterAnimInstance() const
+{
+	return GetMesh() ? Cast<UMonsterAnimInstance>(GetMesh()->GetAnimInstance()) : nullptr;
+}
+
+void AMonsterCharacter::SetLODTier(EMonsterLODTier NewTier)
+{
+	if (CurrentLODTier != NewTier)
+	{
+		CurrentLODTier = NewTier;
+		ApplyLODSettings();
+	}
+}
+
+EMonsterLODTier AMonsterCharacter::SelectLODTier(float DistanceToViewer) const
+{
+	int32 Tier = static_cast<int32>(EMonsterLODTier::SimulationOnly);
+	if (DistanceToViewer <= FullRateLOD.MaxDistance)
+	{
+		Tier = static_cast<int32>(EMonsterLODTier::FullRate);
+	}
+	else if (DistanceToViewer <= ReducedRateLOD.MaxDistance)
+	{
+		Tier = static_cast<int32>(EMonsterLODTier::ReducedRate);
+	}
+
+	// Occluded or off-screen: nobody can tell it updates less often
+	if (!WasRecentlyRendered(RecentlyRenderedTolerance))
+	{
+		Tier = FMath::Min(Tier + 1, static_cast<int32>(EMonsterLODTier::SimulationOnly));
+	}
+
+	return static_cast<EMonsterLODTier>(Tier);
+}
+
+const FMonsterLODSettings& AMonsterCharacter::GetLODSettings(EMonsterLODTier Tier) const
+{
+	switch (Tier)
+	{
+		case EMonsterLODTier::ReducedRate:
+			return ReducedRateLOD;
+
+		case EMonsterLODTier::SimulationOnly:
+			return SimulationOnlyLOD;
+
+		default:
+			return FullRateLOD;
+	}
+}
+
+void AMonsterCharacter::ApplyLODSettings()
+{
+	const FMonsterLODSettings& Settings = GetLODSettings(CurrentLODTier);
+
+	SetActorTickInterval(Settings.TickInterval);
+
+	if (AMonsterAIController* AIController = Cast<AMonsterAIController>(GetController()))
+	{
+		AIController->SetBehaviorTickInterval(Settings.TickInterval);
+	}
+
+	if (SurfacePathfinding)
+	{
+		SurfacePathfinding->SetComponentTickInterval(Settings.TickInterval);
+		SurfacePathfinding->SurfaceTraceInterval = Settings.SurfaceTraceInterval;
+		SurfacePathfinding->bAlignToSurface = Settings.bAlignToSurface;
+	}
+}
+
 void AMonsterCharacter::SetBehaviorState(EMonsterBehaviorState NewState)
 {
 	if (CurrentBehaviorState != NewState)
@@ -53,12 +239,15 @@ void AMonsterCharacter::SetBehaviorState(EMonsterBehaviorState NewState)
 		EMonsterBehaviorState OldState = CurrentBehaviorState;
 		CurrentBehaviorState = NewState;
 
-		// Update movement speed based on new state
-		if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
+		if (bCountedInStateStats)
 		{
-			MovementComp->MaxWalkSpeed = GetMovementSpeedForState(NewState);
+			AddToStateStat(OldState, -1);
+			AddToStateStat(NewState, 1);
 		}
 
+		// Update movement speed based on new state
+		ApplyMovementForState(NewState);
+
 		// Notify AI Controller about state change if this was called directly
 		// (not from AI Controller's TransitionToState)
 		if (AMonsterAIController* AIController = Cast<AMonsterAIController>(GetController()))
@@ -98,17 +287,43 @@ void AMonsterCharacter::SetBehaviorStateInternal(EMonsterBehaviorState NewState)
 		EMonsterBehaviorState OldState = CurrentBehaviorState;
 		CurrentBehaviorState = NewState;
 
-		// Update movement speed based on new state
-		if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
+		if (bCountedInStateStats)
 		{
-			MovementComp->MaxWalkSpeed = GetMovementSpeedForState(NewState);
+			AddToStateStat(OldState, -1);
+			AddToStateStat(NewState, 1);
 		}
 
+		// Update movement speed based on new state
+		ApplyMovementForState(NewState);
+
 		// Notify about state change (but don't sync with AI Controller)
 		OnBehaviorStateChanged(OldState, NewState);
 	}
 }
 
+void AMonsterCharacter::ApplyMovementForState(EMonsterBehaviorState State)
+{
+	if (UCharacterMovementComponent* MovementComp = GetCharacterMovement())
+	{
+		MovementComp->MaxWalkSpeed = GetMovementSpeedForState(State);
+	}
+
+	// The surface pathfinding component enters the crawl mode once it moves us; anything else walks upright
+	if (State != EMonsterBehaviorState::PatrolCrawling)
+	{
+		if (UMonsterMovementComponent* MonsterMovement = Cast<UMonsterMovementComponent>(GetCharacterMovement()))
+		{
+			MonsterMovement->SetCrawling(false);
+		}
+	}
+
+	// Only crawling follows surfaces; idle and standing monsters don't pay for the traces
+	if (SurfacePathfinding && SurfacePathfinding->HasBegunPlay())
+	{
+		SurfacePathfinding->SetSurfaceTrackingActive(State == EMonsterBehaviorState::PatrolCrawling);
+	}
+}
+
 float AMonsterCharacter::GetMovementSpeedForState(EMonsterBehaviorState State) const
 {
 	switch (State)
@@ -0,0 +1,611 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterHordeSubsystem.h"
+#include "MonsterCharacter.h"
+#include "MonsterAIController.h"
+#include "SurfacePathfindingComponent.h"
+#include "SurfacePointCloudSubsystem.h"
+#include "MonsterPatrolPointSubsystem.h"
+#include "SurfaceNavGraph.h"
+#include "AuraMonsterStats.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Components/CapsuleComponent.h"
+#include "GameFramework/PlayerController.h"
+#include "NavigationSystem.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarMonsterHordeHydrateDistance(
+	TEXT("AuraMonster.Horde.HydrateDistance"),
+	3000.0f,
+	TEXT("Horde monsters closer than this to a player are spawned as full monster actors."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMonsterHordeDehydrateDistance(
+	TEXT("AuraMonster.Horde.DehydrateDistance"),
+	4000.0f,
+	TEXT("Hydrated horde monsters further than this from every player go back to lightweight rows. Keep it above HydrateDistance."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMonsterHordeMaxHydrationsPerFrame(
+	TEXT("AuraMonster.Horde.MaxHydrationsPerFrame"),
+	4,
+	TEXT("Maximum number of horde monsters hydrated or dehydrated per horde update, to spread spawn cost."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarMonsterHordeTickInterval(
+	TEXT("AuraMonster.Horde.TickInterval"),
+	0.1f,
+	TEXT("Seconds between horde updates. Far monsters don't need per-frame precision."),
+	ECVF_Default);
+
+namespace
+{
+	float RandRangeValidated(FRandomStream& RandomStream, float MinValue, float MaxValue)
+	{
+		return RandomStream.FRandRange(FMath::Min(MinValue, MaxValue), FMath::Max(MinValue, MaxValue));
+	}
+}
+
+void FMonsterHordeTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target)
+	{
+		Target->TickHorde(DeltaTime);
+	}
+}
+
+FString FMonsterHordeTickFunction::DiagnosticMessage()
+{
+	return TEXT("FMonsterHordeTickFunction");
+}
+
+UMonsterHordeSubsystem::UMonsterHordeSubsystem()
+{
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = true;
+	TickFunction.bRunOnAnyThread = false;
+	TickFunction.TickGroup = TG_PrePhysics;
+	TickFunction.Target = this;
+
+	NumMonstersAdded = 0;
+}
+
+bool UMonsterHordeSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Only game worlds have monsters ticking
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UMonsterHordeSubsystem::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+
+	Archetypes.Reset();
+	ArchetypeIndices.Reset();
+	Locations.Reset();
+	Rotations.Reset();
+	SurfaceNormals.Reset();
+	RuntimeStates.Reset();
+	MoveTargets.Reset();
+	MoveTargetNormals.Reset();
+	HasMoveTargets.Reset();
+	RandomStreams.Reset();
+	IsHydrated.Reset();
+	HydratedCharacters.Reset();
+
+	Super::Deinitialize();
+}
+
+void UMonsterHordeSubsystem::AddHordeMonster(TSubclassOf<AMonsterCharacter> CharacterClass, const FTransform& Transform, EMonsterBehaviorState InitialState)
+{
+	if (!CharacterClass)
+	{
+		return;
+	}
+
+	RegisterTickFunction();
+
+	ArchetypeIndices.Add(FindOrAddArchetype(CharacterClass));
+	Locations.Add(Transform.GetLocation());
+	Rotations.Add(Transform.GetRotation());
+	SurfaceNormals.Add(Transform.GetRotation().GetUpVector());
+	RuntimeStates.AddDefaulted();
+	MoveTargets.Add(FVector::ZeroVector);
+	MoveTargetNormals.Add(FVector::UpVector);
+	HasMoveTargets.Add(false);
+	RandomStreams.Emplace(CharacterClass->GetDefaultObject<AMonsterCharacter>()->MakeSpawnRandomSeed(NumMonstersAdded++));
+	IsHydrated.Add(false);
+	HydratedCharacters.Add(nullptr);
+
+	EnterState(Locations.Num() - 1, InitialState);
+}
+
+int32 UMonsterHordeSubsystem::GetNumHydratedMonsters() const
+{
+	int32 NumHydrated = 0;
+	for (bool bIsHydrated : IsHydrated)
+	{
+		NumHydrated += bIsHydrated ? 1 : 0;
+	}
+	return NumHydrated;
+}
+
+void UMonsterHordeSubsystem::RegisterTickFunction()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	if (World && World->PersistentLevel)
+	{
+		TickFunction.TickInterval = FMath::Max(0.0f, CVarMonsterHordeTickInterval.GetValueOnGameThread());
+		TickFunction.RegisterTickFunction(World->PersistentLevel);
+	}
+}
+
+int32 UMonsterHordeSubsystem::FindOrAddArchetype(TSubclassOf<AMonsterCharacter> CharacterClass)
+{
+	const int32 ExistingIndex = Archetypes.IndexOfByPredicate([CharacterClass](const FMonsterHordeArchetype& Archetype)
+	{
+		return Archetype.CharacterClass == CharacterClass;
+	});
+	if (ExistingIndex != INDEX_NONE)
+	{
+		return ExistingIndex;
+	}
+
+	FMonsterHordeArchetype Archetype;
+	Archetype.CharacterClass = CharacterClass;
+
+	const AMonsterCharacter* CharacterDefaults = CharacterClass->GetDefaultObject<AMonsterCharacter>();
+	Archetype.PatrolStandingSpeed = CharacterDefaults->GetMovementSpeedForState(EMonsterBehaviorState::PatrolStanding);
+	Archetype.PatrolCrawlingSpeed = CharacterDefaults->GetMovementSpeedForState(EMonsterBehaviorState::PatrolCrawling);
+
+	const AMonsterAIController* ControllerDefaults = CharacterDefaults->AIControllerClass
+		? Cast<AMonsterAIController>(CharacterDefaults->AIControllerClass->GetDefaultObject())
+		: nullptr;
+	if (ControllerDefaults)
+	{
+		Archetype.MinIdleDuration = ControllerDefaults->MinIdleDuration;
+		Archetype.MaxIdleDuration = ControllerDefaults->MaxIdleDuration;
+		Archetype.MinSubtleMovementInterval = ControllerDefaults->MinSubtleMovementInterval;
+		Archetype.MaxSubtleMovementInterval = ControllerDefaults->MaxSubtleMovementInterval;
+		Archetype.PatrolTransitionChance = ControllerDefaults->PatrolTransitionChance;
+		Archetype.PatrolRange = ControllerDefaults->PatrolRange;
+		Archetype.MinStopDuration = ControllerDefaults->MinStopDuration;
+		Archetype.MaxStopDuration = ControllerDefaults->MaxStopDuration;
+		Archetype.PatrolAcceptanceRadius = ControllerDefaults->PatrolAcceptanceRadius;
+	}
+
+	return Archetypes.Add(Archetype);
+}
+
+void UMonsterHordeSubsystem::TickHorde(float DeltaTime)
+{
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_TickHorde);
+
+	UpdateHydration();
+
+	ProcessIdle(DeltaTime);
+	ProcessPatrolStanding(DeltaTime);
+	ProcessPatrolCrawling(DeltaTime);
+}
+
+void UMonsterHordeSubsystem::UpdateHydration()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	const float HydrateDistanceSq = FMath::Square(CVarMonsterHordeHydrateDistance.GetValueOnGameThread());
+	const float DehydrateDistanceSq = FMath::Square(FMath::Max(CVarMonsterHordeDehydrateDistance.GetValueOnGameThread(), CVarMonsterHordeHydrateDistance.GetValueOnGameThread()));
+	int32 Budget = CVarMonsterHordeMaxHydrationsPerFrame.GetValueOnGameThread();
+
+	// Backwards, so removing a row doesn't skip the one swapped into its place
+	for (int32 Index = Locations.Num() - 1; Index >= 0; --Index)
+	{
+		if (IsHydrated[Index])
+		{
+			AMonsterCharacter* Character = HydratedCharacters[Index];
+			if (!Character || Character->IsPendingKill())
+			{
+				// The monster was killed or removed while it was an actor
+				RemoveMonster(Index);
+				continue;
+			}
+
+			Locations[Index] = Character->GetActorLocation();
+		}
+
+		float ClosestDistanceSq = MAX_flt;
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			ClosestDistanceSq = FMath::Min(ClosestDistanceSq, FVector::DistSquared(ViewLocation, Locations[Index]));
+		}
+
+		if (Budget <= 0)
+		{
+			continue;
+		}
+
+		if (!IsHydrated[Index] && ClosestDistanceSq < HydrateDistanceSq)
+		{
+			HydrateMonster(Index);
+			--Budget;
+		}
+		else if (IsHydrated[Index] && ClosestDistanceSq > DehydrateDistanceSq)
+		{
+			DehydrateMonster(Index);
+			--Budget;
+		}
+	}
+}
+
+bool UMonsterHordeSubsystem::HydrateMonster(int32 Index)
+{
+	UWorld* World = GetWorld();
+	const FMonsterHordeArchetype& Archetype = Archetypes[ArchetypeIndices[Index]];
+
+	if (!PlaceRowForSpawn(Index))
+	{
+		return false;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	AMonsterCharacter* Character = World->SpawnActor<AMonsterCharacter>(Archetype.CharacterClass, Locations[Index], Rotations[Index].Rotator(), SpawnParams);
+	if (!Character)
+	{
+		return false;
+	}
+
+	// The character keeps drawing from the row's stream, so hydrating doesn't change what the monster does
+	Character->SetRandomStream(RandomStreams[Index]);
+
+	if (!Character->GetController())
+	{
+		Character->SpawnDefaultController();
+	}
+
+	// Continue where the row left off; a crawler keeps heading for its surface target
+	FMonsterAIRuntimeState State = RuntimeStates[Index];
+	if (State.BehaviorState == EMonsterBehaviorState::PatrolCrawling)
+	{
+		State.bHasCrawlingTarget = HasMoveTargets[Index];
+		State.CrawlingTargetLocation = MoveTargets[Index];
+		State.PreviousCrawlingLocation = Locations[Index];
+		State.StuckTime = 0.0f;
+	}
+
+	if (AMonsterAIController* Controller = Cast<AMonsterAIController>(Character->GetController()))
+	{
+		Controller->RestoreRuntimeState(State.BehaviorState, State);
+	}
+	else
+	{
+		Character->SetBehaviorState(State.BehaviorState);
+	}
+
+	IsHydrated[Index] = true;
+	HydratedCharacters[Index] = Character;
+	return true;
+}
+
+bool UMonsterHordeSubsystem::PlaceRowForSpawn(int32 Index)
+{
+	UWorld* World = GetWorld();
+	const FMonsterHordeArchetype& Archetype = Archetypes[ArchetypeIndices[Index]];
+
+	// Crawlers go to the closest baked surface node or point cloud sample, where a crawling actor would stand
+	if (RuntimeStates[Index].BehaviorState == EMonsterBehaviorState::PatrolCrawling)
+	{
+		FVector SurfaceLocation, SurfaceNormal;
+		bool bFound = false;
+		if (const ASurfaceNavGraph* Graph = ASurfaceNavGraph::FindGraphForLocation(World, Locations[Index]))
+		{
+			const int32 NodeIndex = Graph->FindNearestNode(Locations[Index], Archetype.PatrolRange);
+			if (NodeIndex != INDEX_NONE)
+			{
+				SurfaceLocation = Graph->GetNode(NodeIndex).Location;
+				SurfaceNormal = Graph->GetNode(NodeIndex).Normal;
+				bFound = true;
+			}
+		}
+
+		if (!bFound)
+		{
+			USurfacePointCloudSubsystem* PointCloud = World->GetSubsystem<USurfacePointCloudSubsystem>();
+			bFound = PointCloud && PointCloud->FindNearestPoint(Locations[Index], Archetype.PatrolRange, SurfaceLocation, SurfaceNormal);
+		}
+
+		if (!bFound)
+		{
+			return false;
+		}
+
+		Locations[Index] = SurfaceLocation;
+		SurfaceNormals[Index] = SurfaceNormal;
+		Rotations[Index] = FRotationMatrix::MakeFromXZ(Rotations[Index].GetForwardVector(), SurfaceNormal).ToQuat();
+		return true;
+	}
+
+	// Everyone else stands on the navmesh, with the capsule resting on it
+	UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(World);
+	if (!NavSystem)
+	{
+		return true;
+	}
+
+	const AMonsterCharacter* DefaultCharacter = Archetype.CharacterClass ? Archetype.CharacterClass->GetDefaultObject<AMonsterCharacter>() : nullptr;
+	const float HalfHeight = DefaultCharacter && DefaultCharacter->GetCapsuleComponent() ? DefaultCharacter->GetCapsuleComponent()->GetScaledCapsuleHalfHeight() : 0.0f;
+
+	FNavLocation NavLocation;
+	if (!NavSystem->ProjectPointToNavigation(Locations[Index], NavLocation, FVector(Archetype.PatrolAcceptanceRadius, Archetype.PatrolAcceptanceRadius, HalfHeight * 2.0f)))
+	{
+		return false;
+	}
+
+	Locations[Index] = NavLocation.Location + FVector(0.0f, 0.0f, HalfHeight);
+	SurfaceNormals[Index] = FVector::UpVector;
+	Rotations[Index] = FRotator(0.0f, Rotations[Index].Rotator().Yaw, 0.0f).Quaternion();
+	return true;
+}
+
+void UMonsterHordeSubsystem::DehydrateMonster(int32 Index)
+{
+	AMonsterCharacter* Character = HydratedCharacters[Index];
+
+	Locations[Index] = Character->GetActorLocation();
+	Rotations[Index] = Character->GetActorQuat();
+	SurfaceNormals[Index] = Character->GetSurfacePathfinding()
+		? Character->GetSurfacePathfinding()->GetCurrentSurfaceNormal()
+		: Character->GetActorUpVector();
+	HasMoveTargets[Index] = false;
+	RandomStreams[Index] = Character->GetRandomStream();
+
+	AMonsterAIController* Controller = Cast<AMonsterAIController>(Character->GetController());
+	if (Controller)
+	{
+		Controller->SyncScheduledTimers();
+
+		FMonsterAIRuntimeState& State = RuntimeStates[Index];
+		State = Controller->GetRuntimeState();
+		State.BehaviorState = Controller->GetCurrentState();
+		State.bAdvanceTimersInBatch = false;
+		State.bWaitingForScheduledWake = false;
+
+		// A walker's navigation path isn't kept, it picks a new destination; a crawler keeps its surface target
+		if (State.BehaviorState == EMonsterBehaviorState::PatrolCrawling && State.bHasCrawlingTarget)
+		{
+			HasMoveTargets[Index] = true;
+			MoveTargets[Index] = State.CrawlingTargetLocation;
+			MoveTargetNormals[Index] = SurfaceNormals[Index];
+		}
+	}
+	else
+	{
+		EnterState(Index, Character->GetBehaviorState());
+	}
+
+	Character->Destroy();
+	if (Controller)
+	{
+		Controller->Destroy();
+	}
+
+	IsHydrated[Index] = false;
+	HydratedCharacters[Index] = nullptr;
+}
+
+void UMonsterHordeSubsystem::RemoveMonster(int32 Index)
+{
+	ArchetypeIndices.RemoveAtSwap(Index);
+	Locations.RemoveAtSwap(Index);
+	Rotations.RemoveAtSwap(Index);
+	SurfaceNormals.RemoveAtSwap(Index);
+	RuntimeStates.RemoveAtSwap(Index);
+	MoveTargets.RemoveAtSwap(Index);
+	MoveTargetNormals.RemoveAtSwap(Index);
+	HasMoveTargets.RemoveAtSwap(Index);
+	RandomStreams.RemoveAtSwap(Index);
+	IsHydrated.RemoveAtSwap(Index);
+	HydratedCharacters.RemoveAtSwap(Index);
+}
+
+void UMonsterHordeSubsystem::EnterState(int32 Index, EMonsterBehaviorState NewState)
+{
+	const FMonsterHordeArchetype& Archetype = Archetypes[ArchetypeIndices[Index]];
+	FMonsterAIRuntimeState& State = RuntimeStates[Index];
+	State.BehaviorState = NewState;
+
+	if (NewState == EMonsterBehaviorState::Idle)
+	{
+		State.CurrentIdleTime = 0.0f;
+		State.TargetIdleDuration = RandRangeValidated(RandomStreams[Index], Archetype.MinIdleDuration, Archetype.MaxIdleDuration);
+		State.TimeSinceLastSubtleMovement = 0.0f;
+		State.NextSubtleMovementTime = RandRangeValidated(RandomStreams[Index], Archetype.MinSubtleMovementInterval, Archetype.MaxSubtleMovementInterval);
+		State.BreathingCycleTime = 0.0f;
+	}
+	else
+	{
+		State.CurrentStopTime = 0.0f;
+		State.TargetStopDuration = 0.0f;
+		State.bIsStoppedAtDestination = false;
+		State.bHasCrawlingTarget = false;
+		State.CrawlingTargetLocation = FVector::ZeroVector;
+		State.StuckTime = 0.0f;
+		State.PreviousCrawlingLocation = FVector::ZeroVector;
+		HasMoveTargets[Index] = false;
+	}
+}
+
+void UMonsterHordeSubsystem::ProcessIdle(float DeltaTime)
+{
+	for (int32 Index = 0; Index < RuntimeStates.Num(); ++Index)
+	{
+		FMonsterAIRuntimeState& State = RuntimeStates[Index];
+		if (IsHydrated[Index] || State.BehaviorState != EMonsterBehaviorState::Idle)
+		{
+			continue;
+		}
+
+		// Breathing and subtle movements have nothing to animate without an actor, only the idle period matters
+		State.AdvanceIdleTimers(DeltaTime);
+		if (State.CurrentIdleTime < State.TargetIdleDuration)
+		{
+			continue;
+		}
+
+		const FMonsterHordeArchetype& Archetype = Archetypes[ArchetypeIndices[Index]];
+		if (RandomStreams[Index].FRand() < Archetype.PatrolTransitionChance)
+		{
+			EnterState(Index, (RandomStreams[Index].FRand() < 0.5f) ? EMonsterBehaviorState::PatrolStanding : EMonsterBehaviorState::PatrolCrawling);
+		}
+		else
+		{
+			State.CurrentIdleTime = 0.0f;
+			State.TargetIdleDuration = RandRangeValidated(RandomStreams[Index], Archetype.MinIdleDuration, Archetype.MaxIdleDuration);
+		}
+	}
+}
+
+void UMonsterHordeSubsystem::ProcessPatrolStanding(float DeltaTime)
+{
+	UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	UMonsterPatrolPointSubsystem* PatrolPoints = GetWorld()->GetSubsystem<UMonsterPatrolPointSubsystem>();
+
+	for (int32 Index = 0; Index < RuntimeStates.Num(); ++Index)
+	{
+		FMonsterAIRuntimeState& State = RuntimeStates[Index];
+		if (IsHydrated[Index] || State.BehaviorState != EMonsterBehaviorState::PatrolStanding)
+		{
+			continue;
+		}
+
+		State.AdvanceStopTimer(DeltaTime);
+		if (State.bIsStoppedAtDestination)
+		{
+			if (State.CurrentStopTime < State.TargetStopDuration)
+			{
+				continue;
+			}
+
+			State.bIsStoppedAtDestination = false;
+			State.CurrentStopTime = 0.0f;
+		}
+
+		const FMonsterHordeArchetype& Archetype = Archetypes[ArchetypeIndices[Index]];
+
+		// Same destinations an actor would pick; the walk itself is a straight line, nobody is close enough to see it
+		if (!HasMoveTargets[Index])
+		{
+			FNavLocation ResultLocation;
+			if (!PatrolPoints || !PatrolPoints->FindRandomPatrolPoint(Locations[Index], Archetype.PatrolRange, RandomStreams[Index], ResultLocation.Location))
+			{
+				if (!NavSystem || !NavSystem->GetRandomReachablePointInRadius(Locations[Index], Archetype.PatrolRange, ResultLocation))
+				{
+					continue;
+				}
+			}
+
+			MoveTargets[Index] = ResultLocation.Location;
+			MoveTargetNormals[Index] = FVector::UpVector;
+			HasMoveTargets[Index] = true;
+		}
+
+		MoveTowardsTarget(Index, Archetype.PatrolStandingSpeed, DeltaTime);
+	}
+}
+
+void UMonsterHordeSubsystem::ProcessPatrolCrawling(float DeltaTime)
+{
+	USurfacePointCloudSubsystem* PointCloud = GetWorld()->GetSubsystem<USurfacePointCloudSubsystem>();
+
+	for (int32 Index = 0; Index < RuntimeStates.Num(); ++Index)
+	{
+		FMonsterAIRuntimeState& State = RuntimeStates[Index];
+		if (IsHydrated[Index] || State.BehaviorState != EMonsterBehaviorState::PatrolCrawling)
+		{
+			continue;
+		}
+
+		State.AdvanceStopTimer(DeltaTime);
+		if (State.bIsStoppedAtDestination)
+		{
+			if (State.CurrentStopTime < State.TargetStopDuration)
+			{
+				continue;
+			}
+
+			State.bIsStoppedAtDestination = false;
+			State.CurrentStopTime = 0.0f;
+		}
+
+		const FMonsterHordeArchetype& Archetype = Archetypes[ArchetypeIndices[Index]];
+
+		// Surface targets come from the level's point cloud, in the same distance band as an actor's search.
+		// The straight walk there must not pass through geometry, so a target costs a line of sight trace per candidate.
+		if (!HasMoveTargets[Index])
+		{
+			const int32 MaxCandidates = 4;
+			FVector TargetLocation, TargetNormal;
+			if (!PointCloud || !PointCloud->FindVisiblePointInRange(Locations[Index], Archetype.PatrolRange * 0.5f, Archetype.PatrolRange,
+				FCollisionQueryParams(SCENE_QUERY_STAT(HordeCrawlTarget), false), MaxCandidates, TargetLocation, TargetNormal, RandomStreams[Index]))
+			{
+				continue;
+			}
+
+			MoveTargets[Index] = TargetLocation;
+			MoveTargetNormals[Index] = TargetNormal;
+			HasMoveTargets[Index] = true;
+		}
+
+		MoveTowardsTarget(Index, Archetype.PatrolCrawlingSpeed, DeltaTime);
+	}
+}
+
+void UMonsterHordeSubsystem::MoveTowardsTarget(int32 Index, float Speed, float DeltaTime)
+{
+	const FMonsterHordeArchetype& Archetype = Archetypes[ArchetypeIndices[Index]];
+	FMonsterAIRuntimeState& State = RuntimeStates[Index];
+
+	const FVector ToTarget = MoveTargets[Index] - Locations[Index];
+	const float DistanceToTarget = ToTarget.Size();
+
+	if (DistanceToTarget <= Archetype.PatrolAcceptanceRadius)
+	{
+		// Reached destination, stop to listen/look around
+		SurfaceNormals[Index] = MoveTargetNormals[Index];
+		HasMoveTargets[Index] = false;
+		State.bIsStoppedAtDestination = true;
+		State.CurrentStopTime = 0.0f;
+		State.TargetStopDuration = RandRangeValidated(RandomStreams[Index], Archetype.MinStopDuration, Archetype.MaxStopDuration);
+		return;
+	}
+
+	const FVector Direction = ToTarget / DistanceToTarget;
+	Locations[Index] += Direction * FMath::Min(Speed * DeltaTime, DistanceToTarget);
+	Rotations[Index] = FRotationMatrix::MakeFromXZ(Direction, SurfaceNormals[Index]).ToQuat();
+}
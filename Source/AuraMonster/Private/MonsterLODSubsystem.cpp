@@ -0,0 +1,142 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterLODSubsystem.h"
+#include "MonsterCharacter.h"
+#include "AuraMonsterStats.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "GameFramework/PlayerController.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarMonsterLODUpdateInterval(
+	TEXT("AuraMonster.LOD.UpdateInterval"),
+	0.25f,
+	TEXT("Seconds between re-evaluations of the monsters' LOD tiers."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMonsterLODForceTier(
+	TEXT("AuraMonster.LOD.ForceTier"),
+	-1,
+	TEXT("Put every monster with LOD in this tier (0 = full rate, 1 = reduced rate, 2 = simulation only, -1 = off)."),
+	ECVF_Cheat);
+
+void FMonsterLODTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target)
+	{
+		Target->UpdateLOD();
+	}
+}
+
+FString FMonsterLODTickFunction::DiagnosticMessage()
+{
+	return TEXT("FMonsterLODTickFunction");
+}
+
+UMonsterLODSubsystem::UMonsterLODSubsystem()
+{
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = true;
+	TickFunction.bRunOnAnyThread = false;
+	TickFunction.TickGroup = TG_PrePhysics;
+	TickFunction.Target = this;
+}
+
+bool UMonsterLODSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Only game worlds have monsters ticking
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UMonsterLODSubsystem::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+
+	Monsters.Reset();
+
+	Super::Deinitialize();
+}
+
+void UMonsterLODSubsystem::RegisterMonster(AMonsterCharacter* Monster)
+{
+	if (Monster)
+	{
+		Monsters.AddUnique(Monster);
+		RegisterTickFunction();
+	}
+}
+
+void UMonsterLODSubsystem::UnregisterMonster(AMonsterCharacter* Monster)
+{
+	Monsters.RemoveSwap(Monster);
+}
+
+void UMonsterLODSubsystem::RegisterTickFunction()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	if (World && World->PersistentLevel)
+	{
+		TickFunction.TickInterval = FMath::Max(0.0f, CVarMonsterLODUpdateInterval.GetValueOnGameThread());
+		TickFunction.RegisterTickFunction(World->PersistentLevel);
+	}
+}
+
+void UMonsterLODSubsystem::UpdateLOD()
+{
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_UpdateLOD);
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+	for (FConstPlayerControllerIterator It = World->GetPlayerControllerIterator(); It; ++It)
+	{
+		if (APlayerController* PlayerController = It->Get())
+		{
+			FVector ViewLocation;
+			FRotator ViewRotation;
+			PlayerController->GetPlayerViewPoint(ViewLocation, ViewRotation);
+			ViewLocations.Add(ViewLocation);
+		}
+	}
+
+	const int32 ForcedTier = CVarMonsterLODForceTier.GetValueOnGameThread();
+
+	for (int32 Index = Monsters.Num() - 1; Index >= 0; --Index)
+	{
+		AMonsterCharacter* Monster = Monsters[Index];
+		if (!Monster || Monster->IsPendingKill())
+		{
+			Monsters.RemoveAtSwap(Index);
+			continue;
+		}
+
+		if (ForcedTier >= 0)
+		{
+			Monster->SetLODTier(static_cast<EMonsterLODTier>(FMath::Min(ForcedTier, static_cast<int32>(EMonsterLODTier::SimulationOnly))));
+			continue;
+		}
+
+		// Without any viewer (e.g. a dedicated server with no players yet) nothing needs full rate
+		float ClosestDistanceSq = MAX_flt;
+		const FVector Location = Monster->GetActorLocation();
+		for (const FVector& ViewLocation : ViewLocations)
+		{
+			ClosestDistanceSq = FMath::Min(ClosestDistanceSq, FVector::DistSquared(ViewLocation, Location));
+		}
+
+		Monster->SetLODTier(Monster->SelectLODTier(FMath::Sqrt(ClosestDistanceSq)));
+	}
+}
@@ -0,0 +1,331 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterMovementComponent.h"
+#include "AuraMonsterStats.h"
+#include "GameFramework/Character.h"
+#include "Components/CapsuleComponent.h"
+#include "Engine/World.h"
+
+UMonsterMovementComponent::UMonsterMovementComponent()
+{
+	CrawlSurfaceCheckDistance = 50.0f;
+	CrawlTransitionAngle = 45.0f;
+	CrawlGravityScale = 1.0f;
+	MaxCrawlDetachTime = 0.25f;
+
+	CrawlDestination = FVector::ZeroVector;
+	CrawlSpeed = 0.0f;
+	CrawlAcceptanceRadius = 0.0f;
+	CrawlAlignmentSpeed = 0.0f;
+	bHasCrawlMove = false;
+	CrawlSurfaceLocation = FVector::ZeroVector;
+	CrawlSurfaceNormal = FVector::UpVector;
+	bHasCrawlSurface = false;
+	CrawlDetachTime = 0.0f;
+}
+
+float UMonsterMovementComponent::GetMaxSpeed() const
+{
+	return IsCrawling() ? CrawlSpeed : Super::GetMaxSpeed();
+}
+
+void UMonsterMovementComponent::SetCrawling(bool bCrawl)
+{
+	if (bCrawl == IsCrawling())
+	{
+		return;
+	}
+
+	if (bCrawl)
+	{
+		SetMovementMode(MOVE_Custom, static_cast<uint8>(EMonsterMovementMode::Crawl));
+	}
+	else
+	{
+		SetMovementMode(MOVE_Falling);
+	}
+}
+
+bool UMonsterMovementComponent::IsCrawling() const
+{
+	return MovementMode == MOVE_Custom && CustomMovementMode == static_cast<uint8>(EMonsterMovementMode::Crawl);
+}
+
+void UMonsterMovementComponent::RequestCrawlMove(const FVector& Destination, float Speed, float AcceptanceRadius, float AlignmentSpeed)
+{
+	CrawlDestination = Destination;
+	CrawlSpeed = Speed;
+	CrawlAcceptanceRadius = AcceptanceRadius;
+	CrawlAlignmentSpeed = AlignmentSpeed;
+	bHasCrawlMove = true;
+}
+
+void UMonsterMovementComponent::StopCrawlMove()
+{
+	bHasCrawlMove = false;
+	if (IsCrawling())
+	{
+		Velocity = FVector::ZeroVector;
+	}
+}
+
+void UMonsterMovementComponent::SetCrawlSurface(const FVector& Location, const FVector& Normal)
+{
+	CrawlSurfaceLocation = Location;
+	CrawlSurfaceNormal = Normal;
+	bHasCrawlSurface = true;
+	CrawlDetachTime = 0.0f;
+}
+
+void UMonsterMovementComponent::OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode)
+{
+	Super::OnMovementModeChanged(PreviousMovementMode, PreviousCustomMode);
+
+	const bool bWasCrawling = PreviousMovementMode == MOVE_Custom && PreviousCustomMode == static_cast<uint8>(EMonsterMovementMode::Crawl);
+	if (!UpdatedComponent || bWasCrawling == IsCrawling())
+	{
+		return;
+	}
+
+	bHasCrawlMove = false;
+	Velocity = FVector::ZeroVector;
+
+	if (IsCrawling())
+	{
+		// Start out on whatever the capsule stands on
+		CrawlSurfaceNormal = UpdatedComponent->GetUpVector();
+		bHasCrawlSurface = false;
+		CrawlDetachTime = 0.0f;
+
+		FHitResult Hit;
+		if (FindCrawlSurface(UpdatedComponent->GetComponentLocation(), CrawlSurfaceNormal, Hit))
+		{
+			ApplyCrawlSurface(Hit);
+		}
+	}
+	else
+	{
+		// The other modes expect an upright capsule
+		bHasCrawlSurface = false;
+
+		const FVector Forward = FVector::VectorPlaneProject(UpdatedComponent->GetForwardVector(), FVector::UpVector).GetSafeNormal();
+		const FRotator Upright = Forward.IsNearlyZero() ? FRotator(0.0f, UpdatedComponent->GetComponentRotation().Yaw, 0.0f) : Forward.Rotation();
+
+		FHitResult Hit;
+		SafeMoveUpdatedComponent(FVector::ZeroVector, Upright.Quaternion(), true, Hit);
+	}
+}
+
+void UMonsterMovementComponent::PhysCustom(float deltaTime, int32 Iterations)
+{
+	if (IsCrawling())
+	{
+		PhysCrawl(deltaTime, Iterations);
+		return;
+	}
+
+	Super::PhysCustom(deltaTime, Iterations);
+}
+
+void UMonsterMovementComponent::PhysCrawl(float deltaTime, int32 Iterations)
+{
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_PhysCrawl);
+
+	if (deltaTime < MIN_TICK_TIME || !CharacterOwner || !UpdatedComponent)
+	{
+		return;
+	}
+
+	// Stopped on a surface: the last surface result still holds, so there is nothing to query
+	if (!bHasCrawlMove && bHasCrawlSurface)
+	{
+		Velocity = FVector::ZeroVector;
+		return;
+	}
+
+	const float TransitionCos = FMath::Cos(FMath::DegreesToRadians(CrawlTransitionAngle));
+
+	float RemainingTime = deltaTime;
+	while (RemainingTime >= MIN_TICK_TIME && Iterations < MaxSimulationIterations)
+	{
+		++Iterations;
+		const float TimeTick = GetSimulationTimeStep(RemainingTime, Iterations);
+		RemainingTime -= TimeTick;
+
+		const FVector OldLocation = UpdatedComponent->GetComponentLocation();
+
+		if (bHasCrawlSurface)
+		{
+			// Reached the destination
+			if (!bHasCrawlMove || FVector::DistSquared(CrawlDestination, OldLocation) <= FMath::Square(CrawlAcceptanceRadius))
+			{
+				StopCrawlMove();
+				break;
+			}
+
+			// Head for the destination along the surface plane, without overshooting it
+			const FVector ToDestination = FVector::VectorPlaneProject(CrawlDestination - OldLocation, CrawlSurfaceNormal);
+			const float Distance = ToDestination.Size();
+			if (Distance <= KINDA_SMALL_NUMBER)
+			{
+				StopCrawlMove();
+				break;
+			}
+			Velocity = ToDestination / Distance * FMath::Min(CrawlSpeed, Distance / TimeTick);
+		}
+		else
+		{
+			// Off the surface: crawl gravity pulls back towards it, until the crawler gives up and falls
+			CrawlDetachTime += TimeTick;
+			if (CrawlDetachTime > MaxCrawlDetachTime)
+			{
+				SetMovementMode(MOVE_Falling);
+				StartNewPhysics(RemainingTime + TimeTick, Iterations - 1);
+				return;
+			}
+
+			Velocity += GetCrawlGravityDirection() * FMath::Abs(GetGravityZ()) * CrawlGravityScale * TimeTick;
+		}
+
+		const FVector Delta = Velocity * TimeTick;
+		if (Delta.IsNearlyZero())
+		{
+			break;
+		}
+
+		FHitResult Hit(1.0f);
+		SafeMoveUpdatedComponent(Delta, UpdatedComponent->GetComponentQuat(), true, Hit);
+
+		bool bFoundSurface = false;
+		if (Hit.IsValidBlockingHit())
+		{
+			if (FVector::DotProduct(Hit.Normal, CrawlSurfaceNormal) < TransitionCos)
+			{
+				// Ran into a wall (or a ceiling, or the floor on the way down): crawl on it from here,
+				// its hit is our surface result for this step
+				ApplyCrawlSurface(Hit);
+				bFoundSurface = true;
+			}
+			else
+			{
+				SlideAlongSurface(Delta, 1.0f - Hit.Time, Hit.Normal, Hit, true);
+			}
+		}
+
+		if (!bFoundSurface)
+		{
+			FHitResult SurfaceHit;
+			FVector EdgeLocation;
+			if (FindCrawlSurface(UpdatedComponent->GetComponentLocation(), CrawlSurfaceNormal, SurfaceHit))
+			{
+				// Close the gap to the surface below, like the floor snap of walking
+				const float Gap = SurfaceHit.bStartPenetrating ? 0.0f : SurfaceHit.Distance - MIN_FLOOR_DIST;
+				if (Gap > KINDA_SMALL_NUMBER)
+				{
+					FHitResult SnapHit;
+					SafeMoveUpdatedComponent(-CrawlSurfaceNormal * Gap, UpdatedComponent->GetComponentQuat(), true, SnapHit);
+				}
+
+				ApplyCrawlSurface(SurfaceHit);
+			}
+			else if (bHasCrawlSurface && FindSurfaceAroundEdge(Delta.GetSafeNormal(), SurfaceHit, EdgeLocation))
+			{
+				// Both legs of the way around the edge were swept already
+				MoveUpdatedComponent(EdgeLocation - UpdatedComponent->GetComponentLocation(), UpdatedComponent->GetComponentQuat(), false);
+				ApplyCrawlSurface(SurfaceHit);
+			}
+			else
+			{
+				bHasCrawlSurface = false;
+			}
+		}
+
+		// On a surface the velocity is what the sweeps let through; off it, gravity keeps accumulating
+		if (bHasCrawlSurface && !bJustTeleported)
+		{
+			Velocity = (UpdatedComponent->GetComponentLocation() - OldLocation) / TimeTick;
+		}
+	}
+
+	AlignToCrawlSurface(deltaTime);
+}
+
+bool UMonsterMovementComponent::FindCrawlSurface(const FVector& Location, const FVector& Normal, FHitResult& OutHit) const
+{
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MonsterCrawlSurface), false, CharacterOwner);
+	FCollisionResponseParams ResponseParam;
+	InitCollisionParams(QueryParams, ResponseParam);
+
+	const FVector End = Location - Normal * CrawlSurfaceCheckDistance;
+	INC_DWORD_STAT(STAT_AuraMonster_TracesCrawlSweeps);
+	return GetWorld()->SweepSingleByChannel(OutHit, Location, End, UpdatedComponent->GetComponentQuat(), UpdatedComponent->GetCollisionObjectType(),
+		GetPawnCapsuleCollisionShape(SHRINK_None), QueryParams, ResponseParam);
+}
+
+bool UMonsterMovementComponent::FindSurfaceAroundEdge(const FVector& MoveDirection, FHitResult& OutHit, FVector& OutLocation) const
+{
+	if (MoveDirection.IsNearlyZero())
+	{
+		return false;
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(MonsterCrawlEdge), false, CharacterOwner);
+	FCollisionResponseParams ResponseParam;
+	InitCollisionParams(QueryParams, ResponseParam);
+
+	const FCollisionShape Shape = GetPawnCapsuleCollisionShape(SHRINK_None);
+	const FQuat Rotation = UpdatedComponent->GetComponentQuat();
+	const FVector Location = UpdatedComponent->GetComponentLocation();
+
+	// Drop below the level of the surface just left; anything in the way is not the edge's face
+	const FVector Below = Location - CrawlSurfaceNormal * (CrawlSurfaceCheckDistance + Shape.GetCapsuleHalfHeight());
+	FHitResult DropHit;
+	INC_DWORD_STAT(STAT_AuraMonster_TracesCrawlSweeps);
+	if (GetWorld()->SweepSingleByChannel(DropHit, Location, Below, Rotation, UpdatedComponent->GetCollisionObjectType(), Shape, QueryParams, ResponseParam))
+	{
+		return false;
+	}
+
+	// Then back under the edge onto its face
+	const FVector BackEnd = Below - MoveDirection * (Shape.GetCapsuleRadius() * 2.0f + CrawlSurfaceCheckDistance);
+	INC_DWORD_STAT(STAT_AuraMonster_TracesCrawlSweeps);
+	if (!GetWorld()->SweepSingleByChannel(OutHit, Below, BackEnd, Rotation, UpdatedComponent->GetCollisionObjectType(), Shape, QueryParams, ResponseParam)
+		|| OutHit.bStartPenetrating)
+	{
+		return false;
+	}
+
+	OutLocation = OutHit.Location;
+	return true;
+}
+
+void UMonsterMovementComponent::ApplyCrawlSurface(const FHitResult& Hit)
+{
+	SetCrawlSurface(Hit.ImpactPoint, Hit.Normal);
+}
+
+void UMonsterMovementComponent::AlignToCrawlSurface(float DeltaTime)
+{
+	if (CrawlAlignmentSpeed <= 0.0f || !bHasCrawlSurface)
+	{
+		return;
+	}
+
+	// Face the way we crawl, or keep the current heading when stopped
+	const FQuat CurrentRotation = UpdatedComponent->GetComponentQuat();
+	FVector Forward = FVector::VectorPlaneProject(Velocity.IsNearlyZero() ? CurrentRotation.GetForwardVector() : Velocity, CrawlSurfaceNormal);
+	if (!Forward.Normalize())
+	{
+		// Heading along the normal, any direction on the surface will do
+		Forward = FVector::VectorPlaneProject(FMath::Abs(CrawlSurfaceNormal.Z) < 0.9f ? FVector::UpVector : FVector::ForwardVector, CrawlSurfaceNormal).GetSafeNormal();
+	}
+
+	const FQuat TargetRotation = FRotationMatrix::MakeFromZX(CrawlSurfaceNormal, Forward).ToQuat();
+	if (CurrentRotation.Equals(TargetRotation, KINDA_SMALL_NUMBER))
+	{
+		return;
+	}
+
+	FHitResult Hit;
+	SafeMoveUpdatedComponent(FVector::ZeroVector, FMath::QInterpTo(CurrentRotation, TargetRotation, DeltaTime, CrawlAlignmentSpeed), true, Hit);
+}
@@ -0,0 +1,391 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterPatrolPointSubsystem.h"
+#include "AuraMonsterStats.h"
+#include "Async/Async.h"
+#include "NavigationSystem.h"
+#include "NavigationData.h"
+#include "NavMesh/RecastNavMesh.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarMonsterPatrolPointSpacing(
+	TEXT("AuraMonster.PatrolPoints.Spacing"),
+	200.0f,
+	TEXT("Average distance between the patrol points sampled from the navmesh."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMonsterPatrolPointMaxPoints(
+	TEXT("AuraMonster.PatrolPoints.MaxPoints"),
+	200000,
+	TEXT("Maximum number of pooled patrol points; the spacing grows on large navmeshes to stay under it."),
+	ECVF_Default);
+
+namespace
+{
+	/** Probes of random tiles before giving up on a draw */
+	constexpr int32 MaxProbes = 16;
+
+#if WITH_RECAST
+	/** Root of a polygon's island, compressing the path on the way */
+	int32 FindIsland(TArray<int32>& Parents, int32 Index)
+	{
+		while (Parents[Index] != Index)
+		{
+			Parents[Index] = Parents[Parents[Index]];
+			Index = Parents[Index];
+		}
+		return Index;
+	}
+
+	/** Area of a triangle of a polygon's fan */
+	float GetTriangleArea(const FVector& A, const FVector& B, const FVector& C)
+	{
+		return 0.5f * FVector::CrossProduct(B - A, C - A).Size();
+	}
+
+	/**
+	 * Polygons of a navmesh, copied on the game thread so the background build never reads tiles
+	 * the navigation system may be adding, removing or rebuilding meanwhile
+	 */
+	struct FNavMeshPolygons
+	{
+		/** Edge length of a navmesh tile */
+		float TileSize;
+
+		/** Every polygon of the navmesh */
+		TArray<NavNodeRef> PolyRefs;
+
+		/** Start of each polygon's vertices in Verts, with one extra entry past the last polygon */
+		TArray<int32> VertStarts;
+		TArray<FVector> Verts;
+
+		/** Start of each polygon's neighbors in Neighbors, with one extra entry past the last polygon */
+		TArray<int32> NeighborStarts;
+		TArray<NavNodeRef> Neighbors;
+
+		FNavMeshPolygons()
+			: TileSize(1.0f)
+		{
+		}
+	};
+
+	/** Copy the polygons, vertices and neighbors of every navmesh tile; game thread only */
+	void CopyNavMeshPolygons(const ARecastNavMesh* NavMesh, FNavMeshPolygons& OutPolygons)
+	{
+		OutPolygons.TileSize = FMath::Max(NavMesh->TileSizeUU, 1.0f);
+
+		TArray<FNavPoly> TilePolys;
+		TArray<FVector> PolyVerts;
+		TArray<NavNodeRef> PolyNeighbors;
+		for (int32 TileIndex = 0; TileIndex < NavMesh->GetNavMeshTilesCount(); ++TileIndex)
+		{
+			TilePolys.Reset();
+			NavMesh->GetPolysInTile(TileIndex, TilePolys);
+			for (const FNavPoly& Poly : TilePolys)
+			{
+				OutPolygons.PolyRefs.Add(Poly.Ref);
+
+				OutPolygons.VertStarts.Add(OutPolygons.Verts.Num());
+				PolyVerts.Reset();
+				if (NavMesh->GetPolyVerts(Poly.Ref, PolyVerts))
+				{
+					OutPolygons.Verts.Append(PolyVerts);
+				}
+
+				OutPolygons.NeighborStarts.Add(OutPolygons.Neighbors.Num());
+				PolyNeighbors.Reset();
+				NavMesh->GetPolyNeighbors(Poly.Ref, PolyNeighbors);
+				OutPolygons.Neighbors.Append(PolyNeighbors);
+			}
+		}
+
+		OutPolygons.VertStarts.Add(OutPolygons.Verts.Num());
+		OutPolygons.NeighborStarts.Add(OutPolygons.Neighbors.Num());
+	}
+
+	/**
+	 * Sample a copy of a navmesh into a patrol point pool; safe on any thread, it doesn't touch the navmesh itself
+	 * @param Polygons Navmesh polygons to sample
+	 * @param Spacing Average distance between points
+	 * @param MaxPoints Maximum number of points; the spacing grows to stay under it
+	 * @param CancelFlag Set to abandon the build, which then returns an empty pool
+	 */
+	TSharedPtr<FMonsterPatrolPointPool, ESPMode::ThreadSafe> BuildPatrolPointPool(const FNavMeshPolygons& Polygons, float Spacing, int32 MaxPoints, const FThreadSafeBool& CancelFlag)
+	{
+		TSharedPtr<FMonsterPatrolPointPool, ESPMode::ThreadSafe> Pool = MakeShared<FMonsterPatrolPointPool, ESPMode::ThreadSafe>();
+		Pool->TileSize = Polygons.TileSize;
+
+		const TArray<NavNodeRef>& PolyRefs = Polygons.PolyRefs;
+		const TArray<FVector>& Verts = Polygons.Verts;
+
+		// Index every polygon and total up its area
+		TMap<NavNodeRef, int32> PolyIndices;
+		PolyIndices.Reserve(PolyRefs.Num());
+		float TotalArea = 0.0f;
+		for (int32 Index = 0; Index < PolyRefs.Num(); ++Index)
+		{
+			PolyIndices.Add(PolyRefs[Index], Index);
+
+			const int32 FirstVert = Polygons.VertStarts[Index];
+			for (int32 Vert = FirstVert + 1; Vert + 1 < Polygons.VertStarts[Index + 1]; ++Vert)
+			{
+				TotalArea += GetTriangleArea(Verts[FirstVert], Verts[Vert], Verts[Vert + 1]);
+			}
+		}
+
+		if (CancelFlag)
+		{
+			return MakeShared<FMonsterPatrolPointPool, ESPMode::ThreadSafe>();
+		}
+
+		// Connected islands: union polygons across their shared edges
+		TArray<int32> Parents;
+		Parents.SetNumUninitialized(PolyRefs.Num());
+		for (int32 Index = 0; Index < PolyRefs.Num(); ++Index)
+		{
+			Parents[Index] = Index;
+		}
+
+		for (int32 Index = 0; Index < PolyRefs.Num(); ++Index)
+		{
+			for (int32 Neighbor = Polygons.NeighborStarts[Index]; Neighbor < Polygons.NeighborStarts[Index + 1]; ++Neighbor)
+			{
+				if (const int32* NeighborIndex = PolyIndices.Find(Polygons.Neighbors[Neighbor]))
+				{
+					Parents[FindIsland(Parents, Index)] = FindIsland(Parents, *NeighborIndex);
+				}
+			}
+		}
+
+		Pool->PolyIslands.Reserve(PolyRefs.Num());
+		for (int32 Index = 0; Index < PolyRefs.Num(); ++Index)
+		{
+			Pool->PolyIslands.Add(PolyRefs[Index], FindIsland(Parents, Index));
+		}
+
+		// Scatter points uniformly over the polygons; a fixed seed keeps the pool the same from run to run
+		const float MinSpacing = FMath::Sqrt(TotalArea / FMath::Max(1, MaxPoints));
+		const float SpacingSq = FMath::Square(FMath::Max3(Spacing, MinSpacing, 10.0f));
+		FRandomStream RandomStream(0);
+
+		for (int32 Index = 0; Index < PolyRefs.Num(); ++Index)
+		{
+			if (CancelFlag)
+			{
+				return MakeShared<FMonsterPatrolPointPool, ESPMode::ThreadSafe>();
+			}
+
+			const int32 Island = Pool->PolyIslands[PolyRefs[Index]];
+			const int32 FirstVert = Polygons.VertStarts[Index];
+			for (int32 Vert = FirstVert + 1; Vert + 1 < Polygons.VertStarts[Index + 1]; ++Vert)
+			{
+				const FVector& A = Verts[FirstVert];
+				const FVector& B = Verts[Vert];
+				const FVector& C = Verts[Vert + 1];
+
+				// Small triangles get a point with a chance matching their share of one
+				const float ExpectedPoints = GetTriangleArea(A, B, C) / SpacingSq;
+				int32 NumPoints = FMath::FloorToInt(ExpectedPoints);
+				if (RandomStream.FRand() < ExpectedPoints - NumPoints)
+				{
+					++NumPoints;
+				}
+
+				for (int32 Point = 0; Point < NumPoints; ++Point)
+				{
+					float U = RandomStream.FRand();
+					float V = RandomStream.FRand();
+					if (U + V > 1.0f)
+					{
+						U = 1.0f - U;
+						V = 1.0f - V;
+					}
+
+					const FVector Location = A + (B - A) * U + (C - A) * V;
+					const int32 PointIndex = Pool->Locations.Add(Location);
+					Pool->TileIslandPoints.FindOrAdd(Pool->GetKey(Location, Island)).Add(PointIndex);
+				}
+			}
+		}
+
+		return Pool;
+	}
+#endif // WITH_RECAST
+}
+
+UMonsterPatrolPointSubsystem::UMonsterPatrolPointSubsystem()
+{
+	bBuildRequested = false;
+}
+
+bool UMonsterPatrolPointSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Only game worlds have monsters patrolling
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UMonsterPatrolPointSubsystem::Deinitialize()
+{
+	if (UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld()))
+	{
+		NavSystem->OnNavigationGenerationFinishedDelegate.RemoveDynamic(this, &UMonsterPatrolPointSubsystem::HandleNavigationGenerationFinished);
+	}
+
+	// The build reads the navmesh, it must not outlive it
+	CancelBuild();
+	Pool.Reset();
+
+	Super::Deinitialize();
+}
+
+void UMonsterPatrolPointSubsystem::EnsureBuildStarted()
+{
+	// The navigation system and its data aren't in place until the level's actors are initialized
+	const UWorld* World = GetWorld();
+	if (!bBuildRequested && World && World->AreActorsInitialized())
+	{
+		RebuildPatrolPoints();
+	}
+}
+
+void UMonsterPatrolPointSubsystem::HandleNavigationGenerationFinished(ANavigationData* NavData)
+{
+	UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (NavSystem && NavData == NavSystem->GetDefaultNavDataInstance())
+	{
+		RebuildPatrolPoints();
+	}
+}
+
+void UMonsterPatrolPointSubsystem::RebuildPatrolPoints()
+{
+	CancelBuild();
+
+	// From the first build on, the pool follows navmesh rebuilds
+	UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (!bBuildRequested && NavSystem)
+	{
+		NavSystem->OnNavigationGenerationFinishedDelegate.AddUniqueDynamic(this, &UMonsterPatrolPointSubsystem::HandleNavigationGenerationFinished);
+	}
+	bBuildRequested = true;
+
+#if WITH_RECAST
+	const ARecastNavMesh* NavMesh = NavSystem ? Cast<ARecastNavMesh>(NavSystem->GetDefaultNavDataInstance()) : nullptr;
+
+	// A navmesh being built is sampled once the build finishes
+	if (!NavMesh || NavSystem->IsNavigationBuildInProgress())
+	{
+		return;
+	}
+
+	const float Spacing = CVarMonsterPatrolPointSpacing.GetValueOnGameThread();
+	const int32 MaxPoints = CVarMonsterPatrolPointMaxPoints.GetValueOnGameThread();
+
+	// Nothing fences worker threads against tiles changing on the game thread, so the worker only gets a copy
+	TSharedPtr<FNavMeshPolygons, ESPMode::ThreadSafe> Polygons = MakeShared<FNavMeshPolygons, ESPMode::ThreadSafe>();
+	CopyNavMeshPolygons(NavMesh, *Polygons);
+
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> CancelFlag = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false);
+	BuildCancelFlag = CancelFlag;
+	BuildNavData = const_cast<ARecastNavMesh*>(NavMesh);
+
+	// The next rebuild and Deinitialize wait for the build
+	BuildTask = Async(EAsyncExecution::ThreadPool, [Polygons, Spacing, MaxPoints, CancelFlag]()
+	{
+		return BuildPatrolPointPool(*Polygons, Spacing, MaxPoints, *CancelFlag);
+	});
+#endif
+}
+
+bool UMonsterPatrolPointSubsystem::IsPoolReady()
+{
+	ConsumeFinishedBuild();
+	return Pool.IsValid() && Pool->Locations.Num() > 0;
+}
+
+void UMonsterPatrolPointSubsystem::ConsumeFinishedBuild()
+{
+	// A build sampled before the navmesh started changing is out of date; the generation-finished event starts a new one
+	UNavigationSystemV1* NavSystem = FNavigationSystem::GetCurrent<UNavigationSystemV1>(GetWorld());
+	if (BuildTask.IsValid() && NavSystem && NavSystem->IsNavigationBuildInProgress())
+	{
+		CancelBuild();
+		return;
+	}
+
+	if (BuildTask.IsValid() && BuildTask.IsReady())
+	{
+		Pool = BuildTask.Get();
+		PoolNavData = BuildNavData;
+		BuildTask = TFuture<TSharedPtr<FMonsterPatrolPointPool, ESPMode::ThreadSafe>>();
+		BuildCancelFlag.Reset();
+	}
+}
+
+void UMonsterPatrolPointSubsystem::CancelBuild()
+{
+	if (BuildTask.IsValid())
+	{
+		if (BuildCancelFlag.IsValid())
+		{
+			*BuildCancelFlag = true;
+		}
+
+		BuildTask.Wait();
+		BuildTask = TFuture<TSharedPtr<FMonsterPatrolPointPool, ESPMode::ThreadSafe>>();
+	}
+
+	BuildCancelFlag.Reset();
+}
+
+bool UMonsterPatrolPointSubsystem::FindRandomPatrolPoint(const FVector& Origin, float Range, FRandomStream& RandomStream, FVector& OutLocation)
+{
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_FindRandomPatrolPoint);
+
+	EnsureBuildStarted();
+	ANavigationData* NavData = PoolNavData.Get();
+	if (!IsPoolReady() || !NavData)
+	{
+		return false;
+	}
+
+	// Only points on the island the monster stands on are reachable
+	FNavLocation OriginOnNavMesh;
+	if (!NavData->ProjectPoint(Origin, OriginOnNavMesh, NavData->GetDefaultQueryExtent()))
+	{
+		return false;
+	}
+
+	const FMonsterPatrolPointPool& PointPool = *Pool;
+	const int32* Island = PointPool.PolyIslands.Find(OriginOnNavMesh.NodeRef);
+	if (!Island)
+	{
+		// A polygon rebuilt since the pool was sampled
+		return false;
+	}
+
+	// Probe random tiles in range - constant time, however many monsters and points there are
+	const float RangeSq = FMath::Square(Range);
+	for (int32 Probe = 0; Probe < MaxProbes; ++Probe)
+	{
+		const float Angle = RandomStream.FRand() * 2.0f * PI;
+		const float Distance = Range * FMath::Sqrt(RandomStream.FRand());
+		const FVector ProbeLocation = Origin + FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * Distance;
+
+		const TArray<int32>* Points = PointPool.TileIslandPoints.Find(PointPool.GetKey(ProbeLocation, *Island));
+		if (!Points || Points->Num() == 0)
+		{
+			continue;
+		}
+
+		const int32 PointIndex = (*Points)[RandomStream.RandHelper(Points->Num())];
+		if (FVector::DistSquared(PointPool.Locations[PointIndex], Origin) <= RangeSq)
+		{
+			OutLocation = PointPool.Locations[PointIndex];
+			return true;
+		}
+	}
+
+	return false;
+}
@@ -0,0 +1,452 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterTickManager.h"
+#include "MonsterAIController.h"
+#include "MonsterCharacter.h"
+#include "SurfacePathfindingComponent.h"
+#include "SurfaceQuerySubsystem.h"
+#include "MonsterBudgetSubsystem.h"
+#include "AuraMonsterStats.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarMonsterParallelDecisions(
+	TEXT("AuraMonster.TickManager.ParallelDecisions"),
+	1,
+	TEXT("Run the behavior decisions of managed monsters with native behaviors on worker threads and apply their side effects on the game thread afterwards (0 = decide serially)."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarMonsterParallelDecisionBatchSize(
+	TEXT("AuraMonster.TickManager.ParallelDecisionBatchSize"),
+	32,
+	TEXT("Monster decisions per worker task. With no more decisions than this in a frame, they run on the game thread."),
+	ECVF_Default);
+
+void FMonsterTickManagerTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target)
+	{
+		Target->TickMonsters(DeltaTime);
+	}
+}
+
+FString FMonsterTickManagerTickFunction::DiagnosticMessage()
+{
+	return TEXT("FMonsterTickManagerTickFunction");
+}
+
+UMonsterTickManager::UMonsterTickManager()
+{
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = true;
+	TickFunction.bRunOnAnyThread = false;
+	TickFunction.TickGroup = TG_PrePhysics;
+	TickFunction.Target = this;
+
+	bIsTickingMonsters = false;
+	AverageUpdateCostMs = 0.0f;
+	BudgetSubsystem = nullptr;
+}
+
+bool UMonsterTickManager::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Only game worlds have monsters ticking
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UMonsterTickManager::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+
+	RuntimeStates.Reset();
+	Controllers.Reset();
+	SurfaceComponents.Reset();
+	TickIntervals.Reset();
+	TimeSinceLastUpdate.Reset();
+	UpdateCostsMs.Reset();
+	PendingRegistrations.Reset();
+
+	Super::Deinitialize();
+}
+
+bool UMonsterTickManager::RegisterMonster(AMonsterAIController* Controller)
+{
+	if (!Controller || Controller->TickManagerSlot != INDEX_NONE || PendingRegistrations.Contains(Controller))
+	{
+		return false;
+	}
+
+	APawn* Pawn = Controller->GetPawn();
+	USurfacePathfindingComponent* SurfaceComponent = Controller->ControlledMonster ? Controller->ControlledMonster->GetSurfacePathfinding() : nullptr;
+
+	// A Blueprint Event Tick only runs from the per-actor tick, so such monsters keep ticking themselves
+	static const FName ReceiveTickName(TEXT("ReceiveTick"));
+	if (Controller->GetClass()->IsFunctionImplementedInScript(ReceiveTickName)
+		|| (Pawn && Pawn->GetClass()->IsFunctionImplementedInScript(ReceiveTickName))
+		|| (SurfaceComponent && SurfaceComponent->GetClass()->IsFunctionImplementedInScript(ReceiveTickName)))
+	{
+		return false;
+	}
+
+	Controller->SetActorTickEnabled(false);
+	if (Pawn)
+	{
+		Pawn->SetActorTickEnabled(false);
+	}
+	if (SurfaceComponent)
+	{
+		SurfaceComponent->SetTickManaged(true);
+	}
+
+	RegisterTickFunction();
+
+	// Monsters spawned by a behavior update join once the update loop is done, so the arrays don't move under it
+	if (bIsTickingMonsters)
+	{
+		PendingRegistrations.Add(Controller);
+		return true;
+	}
+
+	const int32 Slot = RuntimeStates.Add(Controller->RuntimeState);
+	RuntimeStates[Slot].bAdvanceTimersInBatch = Controller->CanBatchBehaviorTimers();
+	Controllers.Add(Controller);
+	SurfaceComponents.Add(SurfaceComponent);
+	TickIntervals.Add(Controller->GetActorTickInterval());
+	TimeSinceLastUpdate.Add(0.0f);
+	UpdateCostsMs.Add(0.0f);
+
+	Controller->TickManager = this;
+	Controller->TickManagerSlot = Slot;
+	return true;
+}
+
+void UMonsterTickManager::UnregisterMonster(AMonsterAIController* Controller)
+{
+	if (!Controller)
+	{
+		return;
+	}
+
+	if (PendingRegistrations.Remove(Controller) == 0)
+	{
+		const int32 Slot = Controller->TickManagerSlot;
+		if (!Controllers.IsValidIndex(Slot) || Controllers[Slot] != Controller)
+		{
+			return;
+		}
+
+		Controller->RuntimeState = RuntimeStates[Slot];
+		Controller->RuntimeState.bAdvanceTimersInBatch = false;
+		Controller->TickManager = nullptr;
+		Controller->TickManagerSlot = INDEX_NONE;
+
+		if (bIsTickingMonsters)
+		{
+			// Compacted once the update loop is done
+			Controllers[Slot] = nullptr;
+			SurfaceComponents[Slot] = nullptr;
+		}
+		else
+		{
+			RuntimeStates.RemoveAtSwap(Slot);
+			Controllers.RemoveAtSwap(Slot);
+			SurfaceComponents.RemoveAtSwap(Slot);
+			TickIntervals.RemoveAtSwap(Slot);
+			TimeSinceLastUpdate.RemoveAtSwap(Slot);
+			UpdateCostsMs.RemoveAtSwap(Slot);
+
+			if (Controllers.IsValidIndex(Slot) && Controllers[Slot])
+			{
+				Controllers[Slot]->TickManagerSlot = Slot;
+			}
+		}
+	}
+
+	// Hand ticking back to the actors
+	Controller->SetActorTickEnabled(true);
+	if (APawn* Pawn = Controller->GetPawn())
+	{
+		Pawn->SetActorTickEnabled(true);
+	}
+	if (Controller->ControlledMonster)
+	{
+		if (USurfacePathfindingComponent* SurfaceComponent = Controller->ControlledMonster->GetSurfacePathfinding())
+		{
+			SurfaceComponent->SetTickManaged(false);
+		}
+	}
+}
+
+void UMonsterTickManager::SetMonsterTickInterval(AMonsterAIController* Controller, float TickInterval)
+{
+	const int32 Slot = Controller ? Controller->TickManagerSlot : INDEX_NONE;
+	if (Controllers.IsValidIndex(Slot) && Controllers[Slot] == Controller)
+	{
+		TickIntervals[Slot] = FMath::Max(0.0f, TickInterval);
+	}
+}
+
+void UMonsterTickManager::RegisterTickFunction()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	if (World && World->PersistentLevel)
+	{
+		TickFunction.RegisterTickFunction(World->PersistentLevel);
+		BudgetSubsystem = World->GetSubsystem<UMonsterBudgetSubsystem>();
+
+		// Managed monsters consume batched surface query results, so run after the batch
+		if (USurfaceQuerySubsystem* SurfaceQueryService = World->GetSubsystem<USurfaceQuerySubsystem>())
+		{
+			SurfaceQueryService->AddBatchPrerequisite(TickFunction);
+		}
+	}
+}
+
+void UMonsterTickManager::TickMonsters(float DeltaTime)
+{
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_TickMonsters);
+
+	// Advance the behavior timers of every monster in one sweep over contiguous state
+	for (FMonsterAIRuntimeState& State : RuntimeStates)
+	{
+		// Sleeping monsters catch up on their timers when UMonsterTimerSubsystem wakes them
+		if (State.bAdvanceTimersInBatch && !State.bWaitingForScheduledWake)
+		{
+			State.AdvanceTimers(DeltaTime);
+		}
+	}
+
+	// Pick the monsters to update; lower LOD tiers update less often, with the time accumulated since their last update
+	UpdateSlots.Reset();
+	UpdateDeltaTimes.Reset();
+	for (int32 Slot = 0; Slot < Controllers.Num(); ++Slot)
+	{
+		AMonsterAIController* Controller = Controllers[Slot];
+		if (!Controller || Controller->IsPendingKill())
+		{
+			continue;
+		}
+
+		TimeSinceLastUpdate[Slot] += DeltaTime;
+		if (TimeSinceLastUpdate[Slot] >= TickIntervals[Slot])
+		{
+			UpdateSlots.Add(Slot);
+		}
+	}
+
+	// Monsters that don't fit in the frame's budget keep accumulating time until a later frame
+	ApplyUpdateBudget();
+	for (const int32 Slot : UpdateSlots)
+	{
+		UpdateDeltaTimes.Add(TimeSinceLastUpdate[Slot]);
+		TimeSinceLastUpdate[Slot] = 0.0f;
+	}
+
+	bIsTickingMonsters = true;
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+	DecideInParallel();
+
+	// Apply the decisions and run everything else in slot order; monsters that are only waiting at most turn towards their path
+	const int32 BatchSize = GetDecisionBatchSize();
+	int32 NextDecision = 0;
+	for (int32 UpdateIndex = 0; UpdateIndex < UpdateSlots.Num(); ++UpdateIndex)
+	{
+		const int32 Slot = UpdateSlots[UpdateIndex];
+		const float UpdateDeltaTime = UpdateDeltaTimes[UpdateIndex];
+
+		const bool bDecided = DecisionUpdateIndices.IsValidIndex(NextDecision) && DecisionUpdateIndices[NextDecision] == UpdateIndex;
+		const int32 DecisionIndex = bDecided ? NextDecision++ : INDEX_NONE;
+
+		// Side effects of monsters updated earlier may have removed this one
+		AMonsterAIController* Controller = Controllers[Slot];
+		if (!Controller || Controller->IsPendingKill())
+		{
+			continue;
+		}
+
+		const uint64 UpdateStartCycles = FPlatformTime::Cycles64();
+
+		if (bDecided)
+		{
+			const FMonsterAIIntentQueue& Intents = BatchIntents[DecisionIndex / BatchSize];
+			Controller->TickManagedDecided(Intents.GetData() + DecisionIntentStarts[DecisionIndex], DecisionIntentCounts[DecisionIndex], DecisionStates[DecisionIndex], UpdateDeltaTime);
+		}
+		else if (!RuntimeStates[Slot].bWaitingForScheduledWake)
+		{
+			Controller->TickManaged(UpdateDeltaTime);
+		}
+		else
+		{
+			Controller->TickManagedWaiting(UpdateDeltaTime);
+		}
+
+		USurfacePathfindingComponent* SurfaceComponent = SurfaceComponents[Slot];
+		if (SurfaceComponent && !SurfaceComponent->IsPendingKill() && SurfaceComponent->IsSurfaceTrackingActive())
+		{
+			SurfaceComponent->UpdateSurfaceTracking(UpdateDeltaTime);
+		}
+
+		// Smoothed, so one slow update doesn't starve the monster for long
+		const float UpdateCostMs = static_cast<float>(FPlatformTime::ToMilliseconds64(FPlatformTime::Cycles64() - UpdateStartCycles));
+		UpdateCostsMs[Slot] = UpdateCostsMs[Slot] > 0.0f ? FMath::Lerp(UpdateCostsMs[Slot], UpdateCostMs, 0.25f) : UpdateCostMs;
+		AverageUpdateCostMs = AverageUpdateCostMs > 0.0f ? FMath::Lerp(AverageUpdateCostMs, UpdateCostMs, 0.05f) : UpdateCostMs;
+	}
+	bIsTickingMonsters = false;
+
+	if (BudgetSubsystem)
+	{
+		BudgetSubsystem->ReportTime(FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles));
+	}
+
+	// Drop monsters unregistered during the loop
+	for (int32 Slot = Controllers.Num() - 1; Slot >= 0; --Slot)
+	{
+		if (!Controllers[Slot])
+		{
+			RuntimeStates.RemoveAtSwap(Slot);
+			Controllers.RemoveAtSwap(Slot);
+			SurfaceComponents.RemoveAtSwap(Slot);
+			TickIntervals.RemoveAtSwap(Slot);
+			TimeSinceLastUpdate.RemoveAtSwap(Slot);
+			UpdateCostsMs.RemoveAtSwap(Slot);
+
+			if (Controllers.IsValidIndex(Slot) && Controllers[Slot])
+			{
+				Controllers[Slot]->TickManagerSlot = Slot;
+			}
+		}
+	}
+
+	// And add the ones registered during it
+	TArray<AMonsterAIController*> NewControllers = MoveTemp(PendingRegistrations);
+	PendingRegistrations.Reset();
+	for (AMonsterAIController* Controller : NewControllers)
+	{
+		if (Controller && !Controller->IsPendingKill())
+		{
+			RegisterMonster(Controller);
+		}
+	}
+}
+
+void UMonsterTickManager::ApplyUpdateBudget()
+{
+	const float RemainingMs = BudgetSubsystem ? BudgetSubsystem->GetRemainingTimeMs() : MAX_flt;
+	if (RemainingMs == MAX_flt)
+	{
+		return;
+	}
+
+	float EstimatedMs = 0.0f;
+	for (const int32 Slot : UpdateSlots)
+	{
+		EstimatedMs += UpdateCostsMs[Slot] > 0.0f ? UpdateCostsMs[Slot] : AverageUpdateCostMs;
+	}
+	if (EstimatedMs <= RemainingMs)
+	{
+		return;
+	}
+
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_ApplyUpdateBudget);
+
+	UpdatePriorities.Reset();
+	for (const int32 Slot : UpdateSlots)
+	{
+		const AMonsterAIController* Controller = Controllers[Slot];
+		const FVector Location = Controller->ControlledMonster ? Controller->ControlledMonster->GetActorLocation() : FVector::ZeroVector;
+		const float OverdueTime = TimeSinceLastUpdate[Slot] - TickIntervals[Slot];
+		UpdatePriorities.Emplace(BudgetSubsystem->GetUpdatePriority(Location, OverdueTime, RuntimeStates[Slot].StuckTime > 0.0f), Slot);
+	}
+	UpdatePriorities.Sort([](const TPair<float, int32>& A, const TPair<float, int32>& B) { return A.Key > B.Key; });
+
+	// The most important update always runs, so a budget smaller than one update still makes progress
+	UpdateSlots.Reset();
+	float BudgetedMs = 0.0f;
+	for (const TPair<float, int32>& Priority : UpdatePriorities)
+	{
+		const int32 Slot = Priority.Value;
+		const float CostMs = UpdateCostsMs[Slot] > 0.0f ? UpdateCostsMs[Slot] : AverageUpdateCostMs;
+		if (UpdateSlots.Num() > 0 && BudgetedMs + CostMs > RemainingMs)
+		{
+			break;
+		}
+
+		BudgetedMs += CostMs;
+		UpdateSlots.Add(Slot);
+	}
+	BudgetSubsystem->AddDeferredUpdates(UpdatePriorities.Num() - UpdateSlots.Num());
+
+	// Back in slot order, which walks the arrays front to back
+	UpdateSlots.Sort();
+}
+
+int32 UMonsterTickManager::GetDecisionBatchSize()
+{
+	return FMath::Max(1, CVarMonsterParallelDecisionBatchSize.GetValueOnGameThread());
+}
+
+void UMonsterTickManager::DecideInParallel()
+{
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_DecideInParallel);
+
+	DecisionUpdateIndices.Reset();
+	DecisionInputs.Reset();
+	DecisionStates.Reset();
+	if (CVarMonsterParallelDecisions.GetValueOnGameThread() == 0)
+	{
+		return;
+	}
+
+	// Only the native behaviors are known to decide without side effects; the rest tick as usual
+	for (int32 UpdateIndex = 0; UpdateIndex < UpdateSlots.Num(); ++UpdateIndex)
+	{
+		const int32 Slot = UpdateSlots[UpdateIndex];
+		const FMonsterAIRuntimeState& State = RuntimeStates[Slot];
+		if (State.bAdvanceTimersInBatch && !State.bWaitingForScheduledWake && State.NeedsBehaviorUpdate() && Controllers[Slot]->ControlledMonster)
+		{
+			DecisionUpdateIndices.Add(UpdateIndex);
+			DecisionStates.Add(Controllers[Slot]->GetCurrentState());
+			Controllers[Slot]->GatherDecisionInput(DecisionInputs.AddDefaulted_GetRef());
+		}
+	}
+
+	const int32 NumDecisions = DecisionUpdateIndices.Num();
+	const int32 BatchSize = GetDecisionBatchSize();
+	const int32 NumBatches = FMath::DivideAndRoundUp(NumDecisions, BatchSize);
+	DecisionIntentStarts.SetNumUninitialized(NumDecisions, false);
+	DecisionIntentCounts.SetNumUninitialized(NumDecisions, false);
+	if (BatchIntents.Num() < NumBatches)
+	{
+		BatchIntents.SetNum(NumBatches);
+	}
+
+	// Each decision only writes its own runtime state and random stream, and its batch's queue
+	ParallelFor(NumBatches, [this, NumDecisions, BatchSize](int32 Batch)
+	{
+		FMonsterAIIntentQueue& Intents = BatchIntents[Batch];
+		Intents.Reset();
+
+		const int32 LastDecision = FMath::Min((Batch + 1) * BatchSize, NumDecisions);
+		for (int32 DecisionIndex = Batch * BatchSize; DecisionIndex < LastDecision; ++DecisionIndex)
+		{
+			const int32 UpdateIndex = DecisionUpdateIndices[DecisionIndex];
+			const int32 Slot = UpdateSlots[UpdateIndex];
+
+			DecisionIntentStarts[DecisionIndex] = Intents.Num();
+			Controllers[Slot]->DecideBehavior(DecisionInputs[DecisionIndex], UpdateDeltaTimes[UpdateIndex], RuntimeStates[Slot], Intents);
+			DecisionIntentCounts[DecisionIndex] = Intents.Num() - DecisionIntentStarts[DecisionIndex];
+		}
+	}, NumBatches < 2);
+}
@@ -0,0 +1,119 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "MonsterTimerSubsystem.h"
+#include "MonsterAIController.h"
+#include "AuraMonsterStats.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarMonsterTimerResolution(
+	TEXT("AuraMonster.Timers.Resolution"),
+	0.05f,
+	TEXT("Seconds per tick of the monster timing wheel. Scheduled behavior timers fire up to this much late. Read when a world starts."),
+	ECVF_Default);
+
+void FMonsterTimerTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target)
+	{
+		Target->TickTimers();
+	}
+}
+
+FString FMonsterTimerTickFunction::DiagnosticMessage()
+{
+	return TEXT("FMonsterTimerTickFunction");
+}
+
+UMonsterTimerSubsystem::UMonsterTimerSubsystem()
+{
+	TickFunction.bCanEverTick = true;
+	TickFunction.bStartWithTickEnabled = true;
+	TickFunction.bRunOnAnyThread = false;
+	TickFunction.TickGroup = TG_PrePhysics;
+	TickFunction.Target = this;
+
+	Resolution = 0.05f;
+}
+
+bool UMonsterTimerSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Only game worlds have monsters ticking
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void UMonsterTimerSubsystem::Initialize(FSubsystemCollectionBase& Collection)
+{
+	Super::Initialize(Collection);
+
+	Resolution = FMath::Max(0.001f, CVarMonsterTimerResolution.GetValueOnGameThread());
+	TimingWheel.Reset(GetTickForTime(GetWorld()->GetTimeSeconds()));
+}
+
+void UMonsterTimerSubsystem::Deinitialize()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		TickFunction.UnRegisterTickFunction();
+	}
+
+	TimingWheel.Reset(0);
+	ExpiredTimers.Reset();
+
+	Super::Deinitialize();
+}
+
+FMonsterTimerHandle UMonsterTimerSubsystem::ScheduleWake(AMonsterAIController* Controller, float Delay)
+{
+	RegisterTickFunction();
+
+	// Round up, so nothing wakes before its timer has actually run out
+	const double DueTime = GetWorld()->GetTimeSeconds() + FMath::Max(0.0f, Delay);
+	const uint64 DueTick = static_cast<uint64>(FMath::CeilToDouble(DueTime / Resolution));
+	return TimingWheel.Schedule(DueTick, Controller);
+}
+
+void UMonsterTimerSubsystem::CancelWake(FMonsterTimerHandle& Handle)
+{
+	TimingWheel.Cancel(Handle);
+	Handle.Invalidate();
+}
+
+void UMonsterTimerSubsystem::RegisterTickFunction()
+{
+	if (TickFunction.IsTickFunctionRegistered())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	if (World && World->PersistentLevel)
+	{
+		TickFunction.RegisterTickFunction(World->PersistentLevel);
+	}
+}
+
+uint64 UMonsterTimerSubsystem::GetTickForTime(double TimeSeconds) const
+{
+	return static_cast<uint64>(FMath::FloorToDouble(FMath::Max(0.0, TimeSeconds) / Resolution));
+}
+
+void UMonsterTimerSubsystem::TickTimers()
+{
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_TickTimers);
+
+	ExpiredTimers.Reset();
+	TimingWheel.Advance(GetTickForTime(GetWorld()->GetTimeSeconds()), ExpiredTimers);
+
+	// Woken monsters may schedule again right away, which is safe as the expired list is already complete
+	for (const auto& Expired : ExpiredTimers)
+	{
+		AMonsterAIController* Controller = Expired.Payload.Get();
+		if (Controller && !Controller->IsPendingKill())
+		{
+			Controller->OnScheduledWake(Expired.Handle);
+		}
+	}
+}
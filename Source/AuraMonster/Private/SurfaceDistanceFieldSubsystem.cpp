@@ -0,0 +1,340 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SurfaceDistanceFieldSubsystem.h"
+#include "Components/PrimitiveComponent.h"
+#include "Engine/World.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarSurfaceDistanceFieldVoxelSize(
+	TEXT("AuraMonster.DistanceField.VoxelSize"),
+	25.0f,
+	TEXT("Distance between distance field samples. Each brick covers 8 voxels per axis. Changing it drops all built bricks."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<float> CVarSurfaceDistanceFieldBuildBudgetMs(
+	TEXT("AuraMonster.DistanceField.BuildBudgetMs"),
+	0.5f,
+	TEXT("Game thread milliseconds per frame spent building distance field bricks lazily. Lookups in unbuilt bricks fall back to traces."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSurfaceDistanceFieldMaxBricks(
+	TEXT("AuraMonster.DistanceField.MaxBricks"),
+	4096,
+	TEXT("Maximum number of distance field bricks kept (about 3 KB each). The least recently used bricks are dropped beyond it."),
+	ECVF_Default);
+
+namespace
+{
+	/** Voxels per brick edge; each brick stores BrickResolution + 1 samples per axis so lookups never cross bricks */
+	constexpr int32 BrickResolution = 8;
+	constexpr int32 SamplesPerAxis = BrickResolution + 1;
+
+	/** Distances below this count as touching or inside geometry, where an unsigned field has no usable gradient */
+	constexpr float ContactDistance = 1.0f;
+
+	int32 GetSampleIndex(int32 X, int32 Y, int32 Z)
+	{
+		return X + Y * SamplesPerAxis + Z * SamplesPerAxis * SamplesPerAxis;
+	}
+}
+
+USurfaceDistanceFieldSubsystem::USurfaceDistanceFieldSubsystem()
+{
+	BuildBudgetFrame = 0;
+	BuildSecondsThisFrame = 0.0;
+	BuiltVoxelSize = 0.0f;
+}
+
+bool USurfaceDistanceFieldSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Only game worlds have monsters querying surfaces
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void USurfaceDistanceFieldSubsystem::Deinitialize()
+{
+	Bricks.Reset();
+
+	Super::Deinitialize();
+}
+
+bool USurfaceDistanceFieldSubsystem::SampleDistance(const FVector& Location, float& OutDistance, FVector& OutGradient)
+{
+	SyncVoxelSize();
+
+	const FIntVector BrickCoord = GetBrickCoord(Location);
+	const FSurfaceDistanceBrick* Brick = FindOrBuildBrick(BrickCoord, false);
+	if (!Brick || !Brick->bIsQueryable)
+	{
+		return false;
+	}
+
+	// No static geometry anywhere near this brick
+	if (Brick->Distances.Num() == 0)
+	{
+		OutDistance = GetMaxDistance();
+		OutGradient = FVector::ZeroVector;
+		return true;
+	}
+
+	const float VoxelSize = BuiltVoxelSize;
+	const FVector Local = (Location - FVector(BrickCoord) * GetBrickSize()) / VoxelSize;
+
+	const int32 X = FMath::Clamp(FMath::FloorToInt(Local.X), 0, BrickResolution - 1);
+	const int32 Y = FMath::Clamp(FMath::FloorToInt(Local.Y), 0, BrickResolution - 1);
+	const int32 Z = FMath::Clamp(FMath::FloorToInt(Local.Z), 0, BrickResolution - 1);
+	const float FX = FMath::Clamp(Local.X - X, 0.0f, 1.0f);
+	const float FY = FMath::Clamp(Local.Y - Y, 0.0f, 1.0f);
+	const float FZ = FMath::Clamp(Local.Z - Z, 0.0f, 1.0f);
+
+	const TArray<float>& D = Brick->Distances;
+	const float D000 = D[GetSampleIndex(X, Y, Z)];
+	const float D100 = D[GetSampleIndex(X + 1, Y, Z)];
+	const float D010 = D[GetSampleIndex(X, Y + 1, Z)];
+	const float D110 = D[GetSampleIndex(X + 1, Y + 1, Z)];
+	const float D001 = D[GetSampleIndex(X, Y, Z + 1)];
+	const float D101 = D[GetSampleIndex(X + 1, Y, Z + 1)];
+	const float D011 = D[GetSampleIndex(X, Y + 1, Z + 1)];
+	const float D111 = D[GetSampleIndex(X + 1, Y + 1, Z + 1)];
+
+	// Trilinear interpolation
+	const float C00 = FMath::Lerp(D000, D100, FX);
+	const float C10 = FMath::Lerp(D010, D110, FX);
+	const float C01 = FMath::Lerp(D001, D101, FX);
+	const float C11 = FMath::Lerp(D011, D111, FX);
+	const float C0 = FMath::Lerp(C00, C10, FY);
+	const float C1 = FMath::Lerp(C01, C11, FY);
+	OutDistance = FMath::Lerp(C0, C1, FZ);
+
+	// Inside geometry every sample is 0, so there is no direction to the surface to read
+	if (OutDistance < ContactDistance)
+	{
+		return false;
+	}
+
+	// Analytic derivative of the trilinear interpolation
+	const float GX = (D100 - D000) * (1.0f - FY) * (1.0f - FZ)
+		+ (D110 - D010) * FY * (1.0f - FZ)
+		+ (D101 - D001) * (1.0f - FY) * FZ
+		+ (D111 - D011) * FY * FZ;
+	const float GY = (C10 - C00) * (1.0f - FZ) + (C11 - C01) * FZ;
+	const float GZ = C1 - C0;
+	OutGradient = FVector(GX, GY, GZ) / VoxelSize;
+
+	return true;
+}
+
+void USurfaceDistanceFieldSubsystem::PrewarmRegion(const FBox& Region)
+{
+	if (!Region.IsValid)
+	{
+		return;
+	}
+
+	SyncVoxelSize();
+
+	const FIntVector MinCoord = GetBrickCoord(Region.Min);
+	const FIntVector MaxCoord = GetBrickCoord(Region.Max);
+
+	for (int32 X = MinCoord.X; X <= MaxCoord.X; ++X)
+	{
+		for (int32 Y = MinCoord.Y; Y <= MaxCoord.Y; ++Y)
+		{
+			for (int32 Z = MinCoord.Z; Z <= MaxCoord.Z; ++Z)
+			{
+				FindOrBuildBrick(FIntVector(X, Y, Z), true);
+			}
+		}
+	}
+}
+
+void USurfaceDistanceFieldSubsystem::InvalidateRegion(const FBox& Region)
+{
+	if (!Region.IsValid)
+	{
+		return;
+	}
+
+	SyncVoxelSize();
+
+	// Bricks sample geometry up to one max distance outside themselves, so widen the region accordingly
+	const FBox AffectedRegion = Region.ExpandBy(GetMaxDistance());
+	const FIntVector MinCoord = GetBrickCoord(AffectedRegion.Min);
+	const FIntVector MaxCoord = GetBrickCoord(AffectedRegion.Max);
+
+	for (auto It = Bricks.CreateIterator(); It; ++It)
+	{
+		const FIntVector& Coord = It.Key();
+		if (Coord.X >= MinCoord.X && Coord.X <= MaxCoord.X
+			&& Coord.Y >= MinCoord.Y && Coord.Y <= MaxCoord.Y
+			&& Coord.Z >= MinCoord.Z && Coord.Z <= MaxCoord.Z)
+		{
+			It.RemoveCurrent();
+		}
+	}
+}
+
+float USurfaceDistanceFieldSubsystem::GetMaxDistance() const
+{
+	// One brick of margin is enough for surface following, whose detection range is of the same order
+	return GetBrickSize();
+}
+
+void USurfaceDistanceFieldSubsystem::SyncVoxelSize()
+{
+	const float VoxelSize = FMath::Max(1.0f, CVarSurfaceDistanceFieldVoxelSize.GetValueOnGameThread());
+	if (VoxelSize != BuiltVoxelSize)
+	{
+		Bricks.Reset();
+		BuiltVoxelSize = VoxelSize;
+	}
+}
+
+const FSurfaceDistanceBrick* USurfaceDistanceFieldSubsystem::FindOrBuildBrick(const FIntVector& BrickCoord, bool bIgnoreBudget)
+{
+	if (FSurfaceDistanceBrick* ExistingBrick = Bricks.Find(BrickCoord))
+	{
+		ExistingBrick->LastUsedFrame = GFrameCounter;
+		return ExistingBrick;
+	}
+
+	if (BuildBudgetFrame != GFrameCounter)
+	{
+		BuildBudgetFrame = GFrameCounter;
+		BuildSecondsThisFrame = 0.0;
+	}
+
+	// A brick costs one distance query per sample and nearby primitive, so the budget is time rather than a brick count
+	if (!bIgnoreBudget && BuildSecondsThisFrame * 1000.0 >= CVarSurfaceDistanceFieldBuildBudgetMs.GetValueOnGameThread())
+	{
+		return nullptr;
+	}
+
+	const double StartTime = FPlatformTime::Seconds();
+	FSurfaceDistanceBrick NewBrick;
+	BuildBrick(BrickCoord, NewBrick);
+	NewBrick.LastUsedFrame = GFrameCounter;
+	BuildSecondsThisFrame += FPlatformTime::Seconds() - StartTime;
+
+	Bricks.Add(BrickCoord, MoveTemp(NewBrick));
+	EvictBricks(FMath::Max(1, CVarSurfaceDistanceFieldMaxBricks.GetValueOnGameThread()), BrickCoord);
+	return Bricks.Find(BrickCoord);
+}
+
+void USurfaceDistanceFieldSubsystem::EvictBricks(int32 MaxBricks, const FIntVector& KeepCoord)
+{
+	while (Bricks.Num() > MaxBricks)
+	{
+		const FIntVector* OldestCoord = nullptr;
+		uint64 OldestFrame = MAX_uint64;
+		for (const TPair<FIntVector, FSurfaceDistanceBrick>& Brick : Bricks)
+		{
+			if (Brick.Value.LastUsedFrame < OldestFrame && Brick.Key != KeepCoord)
+			{
+				OldestFrame = Brick.Value.LastUsedFrame;
+				OldestCoord = &Brick.Key;
+			}
+		}
+
+		if (!OldestCoord)
+		{
+			return;
+		}
+		Bricks.Remove(FIntVector(*OldestCoord));
+	}
+}
+
+void USurfaceDistanceFieldSubsystem::BuildBrick(const FIntVector& BrickCoord, FSurfaceDistanceBrick& OutBrick) const
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		OutBrick.bIsQueryable = false;
+		return;
+	}
+
+	const float BrickSize = GetBrickSize();
+	const float MaxDistance = GetMaxDistance();
+	const FVector BrickOrigin = FVector(BrickCoord) * BrickSize;
+
+	// One overlap gathers every static primitive close enough to affect a sample in this brick
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SurfaceDistanceFieldBuild), false);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	TArray<FOverlapResult> Overlaps;
+	World->OverlapMultiByChannel(
+		Overlaps,
+		BrickOrigin + FVector(BrickSize * 0.5f),
+		FQuat::Identity,
+		ECC_Visibility,
+		FCollisionShape::MakeBox(FVector(BrickSize * 0.5f + MaxDistance)),
+		QueryParams);
+
+	TArray<UPrimitiveComponent*, TInlineAllocator<8>> Primitives;
+	TArray<FBox, TInlineAllocator<8>> PrimitiveBounds;
+	for (const FOverlapResult& Overlap : Overlaps)
+	{
+		UPrimitiveComponent* Primitive = Overlap.GetComponent();
+		if (Primitive && Overlap.bBlockingHit && !Primitives.Contains(Primitive))
+		{
+			Primitives.Add(Primitive);
+			PrimitiveBounds.Add(Primitive->Bounds.GetBox());
+		}
+	}
+
+	if (Primitives.Num() == 0)
+	{
+		return;
+	}
+
+	OutBrick.Distances.SetNumUninitialized(SamplesPerAxis * SamplesPerAxis * SamplesPerAxis);
+
+	for (int32 Z = 0; Z < SamplesPerAxis; ++Z)
+	{
+		for (int32 Y = 0; Y < SamplesPerAxis; ++Y)
+		{
+			for (int32 X = 0; X < SamplesPerAxis; ++X)
+			{
+				const FVector SamplePoint = BrickOrigin + FVector(X, Y, Z) * BuiltVoxelSize;
+				float Distance = MaxDistance;
+
+				for (int32 PrimitiveIndex = 0; PrimitiveIndex < Primitives.Num(); ++PrimitiveIndex)
+				{
+					// A primitive whose bounds are further than the closest surface so far can't be closer
+					if (PrimitiveBounds[PrimitiveIndex].ComputeSquaredDistanceToPoint(SamplePoint) >= FMath::Square(Distance))
+					{
+						continue;
+					}
+
+					FVector ClosestPoint;
+					const float PrimitiveDistance = Primitives[PrimitiveIndex]->GetDistanceToCollision(SamplePoint, ClosestPoint);
+					if (PrimitiveDistance < 0.0f)
+					{
+						// This primitive can't answer distance queries, so the brick can't be trusted
+						OutBrick.Distances.Reset();
+						OutBrick.bIsQueryable = false;
+						return;
+					}
+					Distance = FMath::Min(Distance, PrimitiveDistance);
+				}
+
+				OutBrick.Distances[GetSampleIndex(X, Y, Z)] = Distance;
+			}
+		}
+	}
+}
+
+FIntVector USurfaceDistanceFieldSubsystem::GetBrickCoord(const FVector& Location) const
+{
+	const float BrickSize = GetBrickSize();
+	return FIntVector(
+		FMath::FloorToInt(Location.X / BrickSize),
+		FMath::FloorToInt(Location.Y / BrickSize),
+		FMath::FloorToInt(Location.Z / BrickSize));
+}
+
+float USurfaceDistanceFieldSubsystem::GetBrickSize() const
+{
+	return BuiltVoxelSize * BrickResolution;
+}
@@ -0,0 +1,480 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SurfaceNavGraph.h"
+#include "SurfaceSampling.h"
+#include "Components/BoxComponent.h"
+#include "Engine/World.h"
+#include "EngineUtils.h"
+#include "Algo/Reverse.h"
+
+ASurfaceNavGraph::ASurfaceNavGraph()
+{
+	PrimaryActorTick.bCanEverTick = false;
+
+	Bounds = CreateDefaultSubobject<UBoxComponent>(TEXT("Bounds"));
+	Bounds->SetBoxExtent(FVector(1000.0f, 1000.0f, 500.0f));
+	Bounds->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	Bounds->SetMobility(EComponentMobility::Static);
+	RootComponent = Bounds;
+
+	NodeSpacing = 100.0f;
+	TransitionAngle = 45.0f;
+	TransitionCostMultiplier = 1.5f;
+}
+
+void ASurfaceNavGraph::PostLoad()
+{
+	Super::PostLoad();
+
+	// The spatial hash is transient, rebuild it from the serialized nodes
+	RebuildSpatialHash();
+
+	// Graphs baked before islands existed
+	if (Nodes.Num() > 0 && Nodes[0].Island == INDEX_NONE)
+	{
+		RebuildIslands();
+	}
+}
+
+void ASurfaceNavGraph::BuildGraph()
+{
+	UWorld* World = GetWorld();
+	if (!World || !Bounds)
+	{
+		return;
+	}
+
+	Modify();
+
+	Nodes.Reset();
+	Edges.Reset();
+
+	// Only bake static geometry - moving objects are handled by the runtime trace fallback
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SurfaceNavGraphBuild), false, this);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	TArray<FSurfaceSample> Samples;
+	SurfaceSampling::SampleSurfacesInBox(World, Bounds->Bounds.GetBox(), NodeSpacing, QueryParams, Samples);
+
+	Nodes.Reserve(Samples.Num());
+	for (const FSurfaceSample& Sample : Samples)
+	{
+		FSurfaceNavNode& Node = Nodes.AddDefaulted_GetRef();
+		Node.Location = Sample.Location;
+		Node.Normal = Sample.Normal;
+	}
+
+	RebuildSpatialHash();
+
+	const float MaxEdgeLength = NodeSpacing * 1.5f;
+	const float TransitionDot = FMath::Cos(FMath::DegreesToRadians(TransitionAngle));
+	const int32 NumSampledNodes = Nodes.Num();
+
+	TArray<TArray<FSurfaceNavEdge>> Adjacency;
+	Adjacency.SetNum(NumSampledNodes);
+
+	auto AddEdgePair = [&Adjacency, this, TransitionDot](int32 A, int32 B)
+	{
+		const float Cost = FVector::Dist(Nodes[A].Location, Nodes[B].Location);
+		const bool bIsTransition = FVector::DotProduct(Nodes[A].Normal, Nodes[B].Normal) < TransitionDot;
+		const float EdgeCost = bIsTransition ? Cost * TransitionCostMultiplier : Cost;
+
+		FSurfaceNavEdge Forward;
+		Forward.TargetNode = B;
+		Forward.Cost = EdgeCost;
+		Forward.bIsTransition = bIsTransition;
+		Adjacency[A].Add(Forward);
+
+		FSurfaceNavEdge Backward = Forward;
+		Backward.TargetNode = A;
+		Adjacency[B].Add(Backward);
+	};
+
+	for (int32 NodeIndex = 0; NodeIndex < NumSampledNodes; ++NodeIndex)
+	{
+		const FIntVector Cell = GetCell(Nodes[NodeIndex].Location);
+
+		for (int32 DX = -1; DX <= 1; ++DX)
+		{
+			for (int32 DY = -1; DY <= 1; ++DY)
+			{
+				for (int32 DZ = -1; DZ <= 1; ++DZ)
+				{
+					const TArray<int32>* CellNodes = NodeHash.Find(Cell + FIntVector(DX, DY, DZ));
+					if (!CellNodes)
+					{
+						continue;
+					}
+
+					for (int32 OtherIndex : *CellNodes)
+					{
+						// Each pair is handled once, from the lower index
+						if (OtherIndex <= NodeIndex || OtherIndex >= NumSampledNodes)
+						{
+							continue;
+						}
+
+						const FSurfaceNavNode& From = Nodes[NodeIndex];
+						const FSurfaceNavNode& To = Nodes[OtherIndex];
+
+						// Opposite faces of a thin wall are never connected
+						if (FVector::DotProduct(From.Normal, To.Normal) < -0.5f
+							|| FVector::DistSquared(From.Location, To.Location) > FMath::Square(MaxEdgeLength))
+						{
+							continue;
+						}
+
+						if (CanConnectNodes(From, To))
+						{
+							AddEdgePair(NodeIndex, OtherIndex);
+							continue;
+						}
+
+						// Convex corners (floor over a ledge onto the wall below) block the direct line.
+						// Route around them through an extra node pushed out along the averaged normal.
+						if (FVector::DotProduct(From.Normal, To.Normal) < TransitionDot)
+						{
+							FSurfaceNavNode Corner;
+							Corner.Normal = (From.Normal + To.Normal).GetSafeNormal();
+							Corner.Location = (From.Location + To.Location) * 0.5f + Corner.Normal * NodeSpacing * 0.5f;
+
+							if (CanConnectNodes(From, Corner) && CanConnectNodes(Corner, To))
+							{
+								const int32 CornerIndex = Nodes.Add(Corner);
+								Adjacency.AddDefaulted();
+								AddEdgePair(NodeIndex, CornerIndex);
+								AddEdgePair(CornerIndex, OtherIndex);
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	// Flatten the adjacency lists so each node references a contiguous run of edges
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		Nodes[NodeIndex].FirstEdge = Edges.Num();
+		Nodes[NodeIndex].NumEdges = Adjacency[NodeIndex].Num();
+		Edges.Append(Adjacency[NodeIndex]);
+	}
+
+	RebuildSpatialHash();
+	RebuildIslands();
+}
+
+void ASurfaceNavGraph::ClearGraph()
+{
+	Modify();
+
+	Nodes.Reset();
+	Edges.Reset();
+	NodeHash.Reset();
+}
+
+int32 ASurfaceNavGraph::FindNearestNode(const FVector& Location, float MaxDistance) const
+{
+	if (NodeHash.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const FIntVector Center = GetCell(Location);
+	const int32 CellRadius = FMath::Max(1, FMath::CeilToInt(MaxDistance / NodeSpacing));
+
+	int32 BestNode = INDEX_NONE;
+	float BestDistanceSq = FMath::Square(MaxDistance);
+
+	for (int32 DX = -CellRadius; DX <= CellRadius; ++DX)
+	{
+		for (int32 DY = -CellRadius; DY <= CellRadius; ++DY)
+		{
+			for (int32 DZ = -CellRadius; DZ <= CellRadius; ++DZ)
+			{
+				const TArray<int32>* CellNodes = NodeHash.Find(Center + FIntVector(DX, DY, DZ));
+				if (!CellNodes)
+				{
+					continue;
+				}
+
+				for (int32 NodeIndex : *CellNodes)
+				{
+					const float DistanceSq = FVector::DistSquared(Nodes[NodeIndex].Location, Location);
+					if (DistanceSq <= BestDistanceSq)
+					{
+						BestDistanceSq = DistanceSq;
+						BestNode = NodeIndex;
+					}
+				}
+			}
+		}
+	}
+
+	return BestNode;
+}
+
+int32 ASurfaceNavGraph::FindRandomNodeInRange(const FVector& Origin, float MinDistance, float MaxDistance, FRandomStream& RandomStream, int32 Island) const
+{
+	if (NodeHash.Num() == 0)
+	{
+		return INDEX_NONE;
+	}
+
+	const float MinDistanceSq = FMath::Square(MinDistance);
+	const float MaxDistanceSq = FMath::Square(MaxDistance);
+
+	// Probe a few random cells first - this is constant time and succeeds almost always on populated graphs
+	const int32 MaxProbes = 16;
+	for (int32 Probe = 0; Probe < MaxProbes; ++Probe)
+	{
+		const FVector ProbeLocation = Origin + RandomStream.VRand() * RandomStream.FRandRange(MinDistance, MaxDistance);
+		const TArray<int32>* CellNodes = NodeHash.Find(GetCell(ProbeLocation));
+		if (!CellNodes || CellNodes->Num() == 0)
+		{
+			continue;
+		}
+
+		const int32 NodeIndex = (*CellNodes)[RandomStream.RandHelper(CellNodes->Num())];
+		const float DistanceSq = FVector::DistSquared(Nodes[NodeIndex].Location, Origin);
+		if (DistanceSq >= MinDistanceSq && DistanceSq <= MaxDistanceSq && (Island == INDEX_NONE || Nodes[NodeIndex].Island == Island))
+		{
+			return NodeIndex;
+		}
+	}
+
+	// Sparse graph - fall back to reservoir sampling over the nodes of the hash cells that overlap the range
+	int32 ChosenNode = INDEX_NONE;
+	int32 NumCandidates = 0;
+	auto SampleCell = [&](const FIntVector& Cell, const TArray<int32>& CellNodes)
+	{
+		// Skip cells entirely outside the range, or entirely inside the minimum distance
+		const FBox CellBox(FVector(Cell) * NodeSpacing, FVector(Cell + FIntVector(1)) * NodeSpacing);
+		const FVector FarthestOffset(
+			FMath::Max(FMath::Abs(Origin.X - CellBox.Min.X), FMath::Abs(Origin.X - CellBox.Max.X)),
+			FMath::Max(FMath::Abs(Origin.Y - CellBox.Min.Y), FMath::Abs(Origin.Y - CellBox.Max.Y)),
+			FMath::Max(FMath::Abs(Origin.Z - CellBox.Min.Z), FMath::Abs(Origin.Z - CellBox.Max.Z)));
+		if (CellBox.ComputeSquaredDistanceToPoint(Origin) > MaxDistanceSq || FarthestOffset.SizeSquared() < MinDistanceSq)
+		{
+			return;
+		}
+
+		for (int32 NodeIndex : CellNodes)
+		{
+			const float DistanceSq = FVector::DistSquared(Nodes[NodeIndex].Location, Origin);
+			if (DistanceSq >= MinDistanceSq && DistanceSq <= MaxDistanceSq && (Island == INDEX_NONE || Nodes[NodeIndex].Island == Island))
+			{
+				++NumCandidates;
+				if (RandomStream.RandHelper(NumCandidates) == 0)
+				{
+					ChosenNode = NodeIndex;
+				}
+			}
+		}
+	};
+
+	// Walk whichever is fewer: the cells the range covers, or the occupied cells
+	const FIntVector MinCell = GetCell(Origin - FVector(MaxDistance));
+	const FIntVector MaxCell = GetCell(Origin + FVector(MaxDistance));
+	const int64 NumRangeCells = static_cast<int64>(MaxCell.X - MinCell.X + 1) * (MaxCell.Y - MinCell.Y + 1) * (MaxCell.Z - MinCell.Z + 1);
+	if (NumRangeCells <= NodeHash.Num())
+	{
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+				{
+					const FIntVector Cell(X, Y, Z);
+					if (const TArray<int32>* CellNodes = NodeHash.Find(Cell))
+					{
+						SampleCell(Cell, *CellNodes);
+					}
+				}
+			}
+		}
+	}
+	else
+	{
+		for (const TPair<FIntVector, TArray<int32>>& CellNodes : NodeHash)
+		{
+			const FIntVector& Cell = CellNodes.Key;
+			if (Cell.X >= MinCell.X && Cell.X <= MaxCell.X && Cell.Y >= MinCell.Y && Cell.Y <= MaxCell.Y && Cell.Z >= MinCell.Z && Cell.Z <= MaxCell.Z)
+			{
+				SampleCell(Cell, CellNodes.Value);
+			}
+		}
+	}
+
+	return ChosenNode;
+}
+
+bool ASurfaceNavGraph::FindPath(int32 StartNode, int32 GoalNode, TArray<int32>& OutNodePath) const
+{
+	OutNodePath.Reset();
+
+	if (!Nodes.IsValidIndex(StartNode) || !Nodes.IsValidIndex(GoalNode))
+	{
+		return false;
+	}
+
+	if (StartNode == GoalNode)
+	{
+		OutNodePath.Add(StartNode);
+		return true;
+	}
+
+	struct FOpenEntry
+	{
+		int32 Node;
+		float EstimatedCost;
+
+		bool operator<(const FOpenEntry& Other) const { return EstimatedCost < Other.EstimatedCost; }
+	};
+
+	const FVector GoalLocation = Nodes[GoalNode].Location;
+
+	TArray<float> CostSoFar;
+	CostSoFar.Init(MAX_FLT, Nodes.Num());
+	TArray<int32> CameFrom;
+	CameFrom.Init(INDEX_NONE, Nodes.Num());
+	TBitArray<> Closed(false, Nodes.Num());
+
+	TArray<FOpenEntry> OpenSet;
+	CostSoFar[StartNode] = 0.0f;
+	OpenSet.HeapPush({ StartNode, FVector::Dist(Nodes[StartNode].Location, GoalLocation) });
+
+	while (OpenSet.Num() > 0)
+	{
+		FOpenEntry Current;
+		OpenSet.HeapPop(Current, false);
+
+		if (Current.Node == GoalNode)
+		{
+			for (int32 Node = GoalNode; Node != INDEX_NONE; Node = CameFrom[Node])
+			{
+				OutNodePath.Add(Node);
+			}
+			Algo::Reverse(OutNodePath);
+			return true;
+		}
+
+		// Stale heap entries are skipped instead of being removed on cost updates
+		if (Closed[Current.Node])
+		{
+			continue;
+		}
+		Closed[Current.Node] = true;
+
+		const FSurfaceNavNode& Node = Nodes[Current.Node];
+		for (int32 EdgeIndex = Node.FirstEdge; EdgeIndex < Node.FirstEdge + Node.NumEdges; ++EdgeIndex)
+		{
+			const FSurfaceNavEdge& Edge = Edges[EdgeIndex];
+			if (Closed[Edge.TargetNode])
+			{
+				continue;
+			}
+
+			const float NewCost = CostSoFar[Current.Node] + Edge.Cost;
+			if (NewCost < CostSoFar[Edge.TargetNode])
+			{
+				CostSoFar[Edge.TargetNode] = NewCost;
+				CameFrom[Edge.TargetNode] = Current.Node;
+				OpenSet.HeapPush({ Edge.TargetNode, NewCost + FVector::Dist(Nodes[Edge.TargetNode].Location, GoalLocation) });
+			}
+		}
+	}
+
+	return false;
+}
+
+bool ASurfaceNavGraph::ContainsLocation(const FVector& Location) const
+{
+	return Bounds && Bounds->Bounds.GetBox().IsInsideOrOn(Location);
+}
+
+ASurfaceNavGraph* ASurfaceNavGraph::FindGraphForLocation(UWorld* World, const FVector& Location)
+{
+	if (!World)
+	{
+		return nullptr;
+	}
+
+	for (TActorIterator<ASurfaceNavGraph> It(World); It; ++It)
+	{
+		if (It->HasGraphData() && It->ContainsLocation(Location))
+		{
+			return *It;
+		}
+	}
+
+	return nullptr;
+}
+
+void ASurfaceNavGraph::RebuildSpatialHash()
+{
+	NodeHash.Reset();
+	for (int32 NodeIndex = 0; NodeIndex < Nodes.Num(); ++NodeIndex)
+	{
+		NodeHash.FindOrAdd(GetCell(Nodes[NodeIndex].Location)).Add(NodeIndex);
+	}
+}
+
+void ASurfaceNavGraph::RebuildIslands()
+{
+	for (FSurfaceNavNode& Node : Nodes)
+	{
+		Node.Island = INDEX_NONE;
+	}
+
+	// Flood fill over the edges from every node not reached yet
+	int32 NumIslands = 0;
+	TArray<int32> OpenNodes;
+	for (int32 SeedNode = 0; SeedNode < Nodes.Num(); ++SeedNode)
+	{
+		if (Nodes[SeedNode].Island != INDEX_NONE)
+		{
+			continue;
+		}
+
+		const int32 Island = NumIslands++;
+		Nodes[SeedNode].Island = Island;
+		OpenNodes.Add(SeedNode);
+
+		while (OpenNodes.Num() > 0)
+		{
+			const FSurfaceNavNode& Node = Nodes[OpenNodes.Pop(false)];
+			for (int32 EdgeIndex = Node.FirstEdge; EdgeIndex < Node.FirstEdge + Node.NumEdges; ++EdgeIndex)
+			{
+				FSurfaceNavNode& Neighbor = Nodes[Edges[EdgeIndex].TargetNode];
+				if (Neighbor.Island == INDEX_NONE)
+				{
+					Neighbor.Island = Island;
+					OpenNodes.Add(Edges[EdgeIndex].TargetNode);
+				}
+			}
+		}
+	}
+}
+
+FIntVector ASurfaceNavGraph::GetCell(const FVector& Location) const
+{
+	return FIntVector(
+		FMath::FloorToInt(Location.X / NodeSpacing),
+		FMath::FloorToInt(Location.Y / NodeSpacing),
+		FMath::FloorToInt(Location.Z / NodeSpacing));
+}
+
+bool ASurfaceNavGraph::CanConnectNodes(const FSurfaceNavNode& From, const FSurfaceNavNode& To) const
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return false;
+	}
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SurfaceNavGraphBuild), false, this);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	return !World->LineTraceTestByChannel(From.Location, To.Location, ECC_Visibility, QueryParams);
+}
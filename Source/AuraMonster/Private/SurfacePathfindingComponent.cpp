@@ -1,10 +1,23 @@
 // Copyright Epic Games, Inc. All Rights Reserved.
 
 #include "SurfacePathfindingComponent.h"
+#include "SurfaceNavGraph.h"
+#include "SurfaceQuerySubsystem.h"
+#include "SurfaceDistanceFieldSubsystem.h"
+#include "SurfacePointCloudSubsystem.h"
+#include "SurfaceTraceUtils.h"
+#include "MonsterCharacter.h"
+#include "MonsterMovementComponent.h"
+#include "MonsterBudgetSubsystem.h"
+#include "AuraMonsterStats.h"
+#include "Components/PrimitiveComponent.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/Pawn.h"
 #include "GameFramework/Actor.h"
 #include "Engine/World.h"
 #include "DrawDebugHelpers.h"
 #include "Kismet/KismetMathLibrary.h"
+#include "Misc/Crc.h"
 
 USurfacePathfindingComponent::USurfacePathfindingComponent()
 {
@@ -16,10 +29,46 @@ USurfacePathfindingComponent::USurfacePathfindingComponent()
 	SurfaceAlignmentSpeed = 5.0f;
 	MinTransitionAngle = 45.0f;
 	AcceptanceRadius = 100.0f;
+	bUseSurfaceNavGraph = true;
+	bUseSurfacePointCloud = true;
+	TraceMode = ESurfaceTraceMode::Synchronous;
+	bUseDistanceField = false;
+	bUseSurfaceContactCache = true;
+	SurfaceCacheMoveThreshold = 2.0f;
+	SurfaceCacheRotationThreshold = 2.0f;
+	SurfaceCacheMaxAge = 1.0f;
+	SurfaceTraceInterval = 0.0f;
+	bAlignToSurface = true;
 
 	CurrentSurfaceNormal = FVector::UpVector;
 	bIsOnSurface = false;
 	CachedOwner = nullptr;
+	CachedMonsterOwner = nullptr;
+	CrawlMovement = nullptr;
+
+	SurfaceNavGraph = nullptr;
+	SurfacePathIndex = 0;
+	SurfacePathGoal = FVector::ZeroVector;
+	bHasSurfacePathGoal = false;
+	bIsFollowingSurfacePath = false;
+	LastSurfacePathTime = 0.0f;
+
+	LastSurfaceTraceTime = -MAX_flt;
+	PendingSurfaceTraceOrigin = FVector::ZeroVector;
+	PendingSurfaceTraceFrame = 0;
+	PendingForwardTraceFrame = 0;
+	SurfaceQueryService = nullptr;
+	SurfacePointCloud = nullptr;
+	DistanceField = nullptr;
+	bHasControllerBatchPrerequisite = false;
+	bHasKnownSurface = false;
+	bIsRandomLocationPending = false;
+	bSurfaceTrackingActive = true;
+	bIsTickManaged = false;
+	RandomLocationDeferredFrame = 0;
+	BudgetSubsystem = nullptr;
+	CrawlStepFrame = 0;
+	bHasControllerTickPrerequisite = false;
 }
 
 void USurfacePathfindingComponent::BeginPlay()
@@ -27,7 +76,28 @@ void USurfacePathfindingComponent::BeginPlay()
 	Super::BeginPlay();
 
 	CachedOwner = GetOwner();
+	CachedMonsterOwner = Cast<AMonsterCharacter>(CachedOwner);
+	CrawlMovement = CachedMonsterOwner ? Cast<UMonsterMovementComponent>(CachedMonsterOwner->GetCharacterMovement()) : nullptr;
+	BudgetSubsystem = GetWorld()->GetSubsystem<UMonsterBudgetSubsystem>();
+	if (!CachedMonsterOwner && CachedOwner)
+	{
+		OwnRandomStream.Initialize(AMonsterCharacter::MakeRandomSeed(EMonsterRandomSeedPolicy::Random, 0, FCrc::StrCrc32(*CachedOwner->GetName())));
+	}
 	
+	// Pick up a baked surface graph if the owner starts inside one
+	if (CachedOwner && bUseSurfaceNavGraph)
+	{
+		SurfaceNavGraph = ASurfaceNavGraph::FindGraphForLocation(GetWorld(), CachedOwner->GetActorLocation());
+	}
+
+	// Monsters start tracking once their behavior state needs it (AMonsterCharacter::BeginPlay runs after us)
+	if (CachedMonsterOwner)
+	{
+		bSurfaceTrackingActive = false;
+		UpdateComponentTickEnabled();
+		return;
+	}
+
 	// Initialize current surface by detecting ground
 	if (CachedOwner)
 	{
@@ -36,6 +106,11 @@ void USurfacePathfindingComponent::BeginPlay()
 		{
 			CurrentSurfaceNormal = HitNormal;
 			bIsOnSurface = true;
+
+			LastContact.Location = HitLocation;
+			LastContact.Normal = HitNormal;
+			LastContact.bIsValid = true;
+			bHasKnownSurface = true;
 		}
 	}
 }
@@ -44,67 +119,327 @@ void USurfacePathfindingComponent::TickComponent(float DeltaTime, ELevelTick Tic
 {
 	Super::TickComponent(DeltaTime, TickType, ThisTickFunction);
 
+	// Managed monsters are measured by UMonsterTickManager instead
+	const double StartTime = FPlatformTime::Seconds();
+	UpdateSurfaceTracking(DeltaTime);
+	if (BudgetSubsystem)
+	{
+		BudgetSubsystem->ReportTime(FPlatformTime::Seconds() - StartTime);
+	}
+}
+
+void USurfacePathfindingComponent::UpdateSurfaceTracking(float DeltaTime)
+{
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_UpdateSurfaceTracking);
+
+	if (!bSurfaceTrackingActive)
+	{
+		return;
+	}
+
+	// The controller stopped moving us along the graph route (reached, retargeted or left the crawl state).
+	// Compared in time rather than frames, as both may tick at a reduced LOD rate.
+	if (bIsFollowingSurfacePath && GetWorld()->GetTimeSeconds() - LastSurfacePathTime > DeltaTime + KINDA_SMALL_NUMBER)
+	{
+		ClearSurfacePath();
+	}
+
+	// The crawl mode keeps the owner on its surface with the movement's own sweeps; just mirror its result
+	if (IsCrawlMovementActive())
+	{
+		bIsOnSurface = CrawlMovement->HasCrawlSurface();
+		if (bIsOnSurface)
+		{
+			CurrentSurfaceNormal = CrawlMovement->GetCrawlSurfaceNormal();
+			LastContact.Location = CrawlMovement->GetCrawlSurfaceLocation();
+			LastContact.Normal = CurrentSurfaceNormal;
+			LastContact.bIsValid = true;
+			bHasKnownSurface = true;
+		}
+		return;
+	}
+
+	// The controller's crawl step already traced, placed and aligned the owner this frame
+	if (CrawlStepFrame == GFrameCounter)
+	{
+		return;
+	}
+
 	// Continuously update surface attachment
-	if (CachedOwner && bIsOnSurface)
+	// While following a graph route the baked node normals already drive alignment, so no traces are needed
+	if (CachedOwner && bIsOnSurface && !bIsFollowingSurfacePath)
 	{
+		const FVector Location = CachedOwner->GetActorLocation();
+
+		// The distance field answers without any physics queries wherever it has been built
+		bool bFoundSurface = false;
 		FVector HitLocation, HitNormal;
-		if (DetectSurface(CachedOwner->GetActorLocation(), HitLocation, HitNormal))
+		const bool bFieldAnswered = bUseDistanceField && SampleDistanceFieldSurface(Location, bFoundSurface, HitLocation, HitNormal);
+
+		if (!bFieldAnswered)
+		{
+			if (TraceMode != ESurfaceTraceMode::Synchronous)
+			{
+				UpdateSurfaceDeferred(DeltaTime);
+				return;
+			}
+
+			// Out of trace budget for now: keep following the last contact's plane
+			if (LastContact.bIsValid && !IsSurfaceTraceDue())
+			{
+				AlignToSurface(LastContact.Normal, DeltaTime);
+				return;
+			}
+
+			LastSurfaceTraceTime = GetWorld()->GetTimeSeconds();
+			bFoundSurface = DetectSurface(Location, HitLocation, HitNormal);
+		}
+
+		if (bFoundSurface)
 		{
 			CurrentSurfaceNormal = HitNormal;
 			AlignToSurface(HitNormal, DeltaTime);
+
+			LastContact.Location = HitLocation;
+			LastContact.Normal = HitNormal;
+			LastContact.bIsValid = true;
+			bHasKnownSurface = true;
 		}
 		else
 		{
 			bIsOnSurface = false;
+			LastContact.bIsValid = false;
 		}
 	}
 }
 
+void USurfacePathfindingComponent::SetSurfaceTrackingActive(bool bActive)
+{
+	if (bSurfaceTrackingActive == bActive)
+	{
+		return;
+	}
+
+	bSurfaceTrackingActive = bActive;
+	UpdateComponentTickEnabled();
+
+	if (bActive)
+	{
+		AddControllerTickPrerequisite();
+		WarmStartSurfaceTracking();
+	}
+	else
+	{
+		// Drop work in flight, but keep the last contact and the contact cache to start from next time
+		ClearSurfacePath();
+		PendingSurfaceTraces.Reset();
+		PendingForwardTrace = FTraceHandle();
+	}
+}
+
+void USurfacePathfindingComponent::SetTickManaged(bool bManaged)
+{
+	bIsTickManaged = bManaged;
+	UpdateComponentTickEnabled();
+}
+
+void USurfacePathfindingComponent::UpdateComponentTickEnabled()
+{
+	SetComponentTickEnabled(bSurfaceTrackingActive && !bIsTickManaged);
+}
+
+void USurfacePathfindingComponent::WarmStartSurfaceTracking()
+{
+	if (!CachedOwner)
+	{
+		return;
+	}
+
+	const FVector Location = CachedOwner->GetActorLocation();
+
+	// A monster that walked here stands on the floor its movement component already found, so that is the surface
+	if (!IsSurfaceContactCacheValid(Location))
+	{
+		const UCharacterMovementComponent* Movement = CachedMonsterOwner ? CachedMonsterOwner->GetCharacterMovement() : nullptr;
+		if (Movement && Movement->IsMovingOnGround() && Movement->CurrentFloor.bBlockingHit)
+		{
+			const FHitResult& FloorHit = Movement->CurrentFloor.HitResult;
+
+			FSurfaceContact Contact;
+			Contact.Location = FloorHit.ImpactPoint + FloorHit.ImpactNormal * SurfaceTraceUtils::SurfaceOffset;
+			Contact.Normal = FloorHit.ImpactNormal;
+			Contact.bIsValid = true;
+			Contact.Distance = FVector::Dist(Location, FloorHit.ImpactPoint);
+			Contact.HitComponent = FloorHit.GetComponent();
+
+			CurrentSurfaceNormal = Contact.Normal;
+			LastContact = Contact;
+			CacheSurfaceContact(Location, Contact);
+		}
+		else
+		{
+			// Moved off the remembered contact some other way; the deferred modes must not extrapolate it
+			LastContact.bIsValid = false;
+		}
+	}
+
+	// Answered by the cache (or the distance field) when one of the above holds, traced otherwise
+	FVector HitLocation, HitNormal;
+	if (DetectSurface(Location, HitLocation, HitNormal))
+	{
+		CurrentSurfaceNormal = HitNormal;
+		bIsOnSurface = true;
+
+		LastContact.Location = HitLocation;
+		LastContact.Normal = HitNormal;
+		LastContact.bIsValid = true;
+		bHasKnownSurface = true;
+	}
+	else
+	{
+		bIsOnSurface = false;
+	}
+}
+
 bool USurfacePathfindingComponent::GetRandomSurfaceLocation(const FVector& OriginLocation, float Range, FVector& OutLocation, FVector& OutNormal)
 {
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_GetRandomSurfaceLocation);
+
 	if (!CachedOwner || !GetWorld())
 	{
 		return false;
 	}
 
-	// Try multiple random directions to find a valid surface location
+	// A baked graph answers this without any traces, with a node the route can reach from the nearest one
+	const int32 StartNode = SurfaceNavGraph && bUseSurfaceNavGraph ? SurfaceNavGraph->FindNearestNode(OriginLocation, SurfaceDetectionRange) : INDEX_NONE;
+	if (StartNode != INDEX_NONE)
+	{
+		// Same distance band as the trace search: at least half the range away
+		const int32 NodeIndex = SurfaceNavGraph->FindRandomNodeInRange(OriginLocation, Range * 0.5f, Range, GetRandomStream(), SurfaceNavGraph->GetNode(StartNode).Island);
+		if (NodeIndex != INDEX_NONE)
+		{
+			const FSurfaceNavNode& Node = SurfaceNavGraph->GetNode(NodeIndex);
+			OutLocation = Node.Location;
+			OutNormal = Node.Normal;
+			return true;
+		}
+	}
+
+	// So does the level's surface point cloud, with one trace per candidate to keep targets in line of sight
+	// like the random rays do; if none of a few candidates is visible, the ray search below takes over
+	if (bUseSurfacePointCloud)
+	{
+		if (!SurfacePointCloud)
+		{
+			SurfacePointCloud = GetWorld()->GetSubsystem<USurfacePointCloudSubsystem>();
+		}
+
+		// The first search starts the cloud's build; until it is ready the ray search answers
+		if (SurfacePointCloud)
+		{
+			const int32 MaxCandidates = 4;
+			const FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SurfacePointCloudVisibility), false, CachedOwner);
+			int32 NumTraces = 0;
+			const bool bFound = SurfacePointCloud->FindVisiblePointInRange(OriginLocation, Range * 0.5f, Range, QueryParams, MaxCandidates, OutLocation, OutNormal, GetRandomStream(), &NumTraces);
+
+			ReportTraces(NumTraces);
+			INC_DWORD_STAT_BY(STAT_AuraMonster_TracesRandomSurfaceLocation, NumTraces);
+			if (bFound)
+			{
+				return true;
+			}
+		}
+	}
+
 	const int32 MaxAttempts = 30;
-	
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(CachedOwner);
-	
-	for (int32 Attempt = 0; Attempt < MaxAttempts; ++Attempt)
+
+	// The trace search is what stacks up when many crawlers look for targets at once, so it waits for
+	// the frame's trace budget; IsRandomSurfaceLocationPending tells the caller to ask again later
+	if (BudgetSubsystem && !bIsRandomLocationPending && LatestRandomLocationResult.Frame == 0
+		&& !BudgetSubsystem->TryReserveTraces(this, OriginLocation, MaxAttempts))
 	{
-		// Generate a random direction
-		FVector RandomDirection = FMath::VRand();
-		RandomDirection.Normalize();
-		
-		// Scale by range - use full range to reach distant surfaces
-		float RandomDistance = FMath::RandRange(Range * 0.5f, Range);
-		
-		// Cast a ray from origin in the random direction to find surfaces
-		FVector TraceStart = OriginLocation;
-		FVector TraceEnd = OriginLocation + RandomDirection * RandomDistance;
-		
-		FHitResult HitResult;
-		if (GetWorld()->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECC_Visibility, QueryParams))
+		RandomLocationDeferredFrame = GFrameCounter;
+		return false;
+	}
+
+	// Batched mode: hand back the answer to the previously submitted request, or queue a new one.
+	// Callers already retry on failure, so returning false while the request is in flight is safe;
+	// IsRandomSurfaceLocationPending tells them apart from a search that found nothing.
+	if (TraceMode == ESurfaceTraceMode::Batched)
+	{
+		if (bIsRandomLocationPending)
 		{
-			// Found a surface along this ray
-			OutLocation = HitResult.Location;
-			OutNormal = HitResult.Normal;
-			
-			// Move the location slightly away from the surface to avoid being embedded
-			OutLocation += OutNormal * 10.0f;
-			
+			return false;
+		}
+
+		if (LatestRandomLocationResult.Frame != 0)
+		{
+			LatestRandomLocationResult.Frame = 0;
+
+			// Hand back the traces reserved at submit time that the search didn't need
+			ReportTraces(LatestRandomLocationResult.NumTraces - MaxAttempts);
+			INC_DWORD_STAT_BY(STAT_AuraMonster_TracesRandomSurfaceLocation, LatestRandomLocationResult.NumTraces);
+			if (!LatestRandomLocationResult.Contact.bIsValid)
+			{
+				return false;
+			}
+
+			OutLocation = LatestRandomLocationResult.Contact.Location;
+			OutNormal = LatestRandomLocationResult.Contact.Normal;
 			return true;
 		}
+
+		FSurfaceQueryRequest Request;
+		Request.Type = ESurfaceQueryType::RandomLocation;
+		Request.Origin = OriginLocation;
+		Request.Range = Range;
+		Request.MaxAttempts = MaxAttempts;
+		Request.RandomSeed = static_cast<int32>(GetRandomStream().GetUnsignedInt());
+		if (SubmitSurfaceQuery(Request))
+		{
+			bIsRandomLocationPending = true;
+			return false;
+		}
+	}
+
+	// Try multiple random directions to find a valid surface location
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(CachedOwner);
+
+	FSurfaceContact Contact;
+	int32 NumTraces = MaxAttempts;
+	const bool bFound = SurfaceTraceUtils::TraceRandomSurfaceLocation(GetWorld(), OriginLocation, Range, MaxAttempts, QueryParams, GetRandomStream(), Contact, &NumTraces);
+
+	// Hand back the reserved traces the search didn't need
+	ReportTraces(NumTraces - MaxAttempts);
+	INC_DWORD_STAT_BY(STAT_AuraMonster_TracesRandomSurfaceLocation, NumTraces);
+
+	if (bFound)
+	{
+		OutLocation = Contact.Location;
+		OutNormal = Contact.Normal;
+		return true;
 	}
 
 	return false;
 }
 
+bool USurfacePathfindingComponent::GetLastKnownSurface(FVector& OutLocation, FVector& OutNormal) const
+{
+	if (!bHasKnownSurface)
+	{
+		return false;
+	}
+
+	OutLocation = LastContact.Location;
+	OutNormal = LastContact.Normal;
+	return true;
+}
+
 bool USurfacePathfindingComponent::MoveTowardsSurfaceLocation(const FVector& TargetLocation, float DeltaTime, float Speed)
 {
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_MoveTowardsSurfaceLocation);
+
 	if (!CachedOwner || !GetWorld())
 	{
 		return false;
@@ -114,12 +449,58 @@ bool USurfacePathfindingComponent::MoveTowardsSurfaceLocation(const FVector& Tar
 	FVector DirectionToTarget = TargetLocation - CurrentLocation;
 	float DistanceToTarget = DirectionToTarget.Size();
 
+	// Surface tracking runs after us and skips frames we already stepped
+	AddControllerTickPrerequisite();
+
 	// Check if we've reached the target
 	if (DistanceToTarget <= AcceptanceRadius)
 	{
+		ClearSurfacePath();
+		if (CrawlMovement)
+		{
+			CrawlMovement->StopCrawlMove();
+		}
 		return false; // Reached target
 	}
 
+	// Everything this step does to the owner's transform reaches its components and overlaps once, at the end
+	FScopedMovementUpdate ScopedMovement(CachedOwner->GetRootComponent(), EScopedUpdate::DeferredUpdates);
+
+	// Crawl in the movement component's crawl mode once it can take over (not while falling); from then on
+	// it does the swept, surface-relative moves and the surface checks below are skipped
+	if (CrawlMovement && !CrawlMovement->IsCrawling() && !CrawlMovement->IsFalling())
+	{
+		CrawlMovement->SetCrawling(true);
+	}
+
+	// Prefer a precomputed route over the baked surface graph - this needs no traces at all
+	if (SurfaceNavGraph && bUseSurfaceNavGraph)
+	{
+		// Only search once per target; a failed search falls through to trace-based movement
+		if (!bHasSurfacePathGoal || !SurfacePathGoal.Equals(TargetLocation, 1.0f))
+		{
+			BuildSurfacePathTo(TargetLocation);
+		}
+
+		if (bIsFollowingSurfacePath)
+		{
+			FollowSurfacePath(TargetLocation, DeltaTime, Speed);
+			return true; // Still moving
+		}
+	}
+
+	if (IsCrawlMovementActive())
+	{
+		CrawlMovement->RequestCrawlMove(TargetLocation, Speed, AcceptanceRadius, bAlignToSurface ? SurfaceAlignmentSpeed : 0.0f);
+		return true; // Still moving
+	}
+
+	// Falling into the crawl mode: wait for the landing
+	if (CrawlMovement && CrawlMovement->IsFalling())
+	{
+		return true;
+	}
+
 	// Normalize direction
 	DirectionToTarget.Normalize();
 
@@ -129,22 +510,16 @@ bool USurfacePathfindingComponent::MoveTowardsSurfaceLocation(const FVector& Tar
 
 	// Instead of using DetectSurface which finds closest, do a directional trace
 	// toward the target to find surfaces along the path
-	FCollisionQueryParams QueryParams;
-	QueryParams.AddIgnoredActor(CachedOwner);
-	
 	// Start trace from slightly in front to avoid hitting the current surface immediately
 	FVector TraceStart = CurrentLocation + DirectionToTarget * 5.0f;
 	FVector TraceEnd = DesiredLocation + DirectionToTarget * SurfaceDetectionRange;
 	
 	// First, try tracing toward the desired location
 	FHitResult ForwardHit;
-	bool bHitForward = GetWorld()->LineTraceSingleByChannel(
-		ForwardHit, 
-		TraceStart, 
-		TraceEnd,
-		ECC_Visibility, 
-		QueryParams
-	);
+	bool bHitForward = TraceForward(TraceStart, TraceEnd, ForwardHit);
+
+	// Resolve where the step ends once, then commit it in one transform update
+	FVector SurfaceLocation, SurfaceNormal;
 	
 	if (bHitForward && ForwardHit.bBlockingHit)
 	{
@@ -163,13 +538,9 @@ bool USurfacePathfindingComponent::MoveTowardsSurfaceLocation(const FVector& Tar
 			{
 				// This is an obstacle - don't move toward it
 				// Instead, try to find a surface at our current position to stay grounded
-				FVector NearestSurfaceLocation, NearestSurfaceNormal;
-				if (DetectSurface(CurrentLocation, NearestSurfaceLocation, NearestSurfaceNormal))
+				if (DetectSurface(CurrentLocation, SurfaceLocation, SurfaceNormal))
 				{
-					CachedOwner->SetActorLocation(NearestSurfaceLocation);
-					CurrentSurfaceNormal = NearestSurfaceNormal;
-					bIsOnSurface = true;
-					AlignToSurface(NearestSurfaceNormal, DeltaTime);
+					CommitCrawlStep(SurfaceLocation, SurfaceNormal, DeltaTime);
 				}
 				// Return true to indicate still trying (stuck detection in AI controller will handle this)
 				return true;
@@ -177,39 +548,172 @@ bool USurfacePathfindingComponent::MoveTowardsSurfaceLocation(const FVector& Tar
 		}
 		
 		// Hit a surface we can move onto (like floor or ceiling)
-		FVector SurfaceLocation = ForwardHit.Location + ForwardHit.Normal * 10.0f;
-		FVector SurfaceNormal = ForwardHit.Normal;
-		
-		CachedOwner->SetActorLocation(SurfaceLocation);
-		CurrentSurfaceNormal = SurfaceNormal;
-		bIsOnSurface = true;
-		
-		// Align to new surface
-		AlignToSurface(SurfaceNormal, DeltaTime);
+		CommitCrawlStep(ForwardHit.Location + ForwardHit.Normal * SurfaceTraceUtils::SurfaceOffset, ForwardHit.Normal, DeltaTime);
+	}
+	else if (DetectSurface(DesiredLocation, SurfaceLocation, SurfaceNormal))
+	{
+		// No surface hit forward, but one nearby: snap to it
+		CommitCrawlStep(SurfaceLocation, SurfaceNormal, DeltaTime);
 	}
 	else
 	{
-		// No surface hit forward, try detecting surface nearby
-		FVector NearestSurfaceLocation, NearestSurfaceNormal;
-		if (DetectSurface(DesiredLocation, NearestSurfaceLocation, NearestSurfaceNormal))
+		// No surface found, just move normally
+		CachedOwner->SetActorLocation(DesiredLocation);
+		bIsOnSurface = false;
+		CrawlStepFrame = GFrameCounter;
+	}
+
+	return true; // Still moving
+}
+
+bool USurfacePathfindingComponent::FindSurfacePath(const FVector& StartLocation, const FVector& EndLocation, TArray<FVector>& OutPathPoints) const
+{
+	OutPathPoints.Reset();
+
+	if (!SurfaceNavGraph)
+	{
+		return false;
+	}
+
+	const int32 StartNode = SurfaceNavGraph->FindNearestNode(StartLocation, SurfaceDetectionRange);
+	const int32 GoalNode = SurfaceNavGraph->FindNearestNode(EndLocation, SurfaceDetectionRange);
+
+	TArray<int32> NodePath;
+	if (!SurfaceNavGraph->FindPath(StartNode, GoalNode, NodePath))
+	{
+		return false;
+	}
+
+	OutPathPoints.Reserve(NodePath.Num() + 1);
+	for (int32 NodeIndex : NodePath)
+	{
+		OutPathPoints.Add(SurfaceNavGraph->GetNode(NodeIndex).Location);
+	}
+	OutPathPoints.Add(EndLocation);
+
+	return true;
+}
+
+bool USurfacePathfindingComponent::BuildSurfacePathTo(const FVector& TargetLocation)
+{
+	ClearSurfacePath();
+
+	SurfacePathGoal = TargetLocation;
+	bHasSurfacePathGoal = true;
+
+	if (!SurfaceNavGraph || !CachedOwner)
+	{
+		return false;
+	}
+
+	const FVector OwnerLocation = CachedOwner->GetActorLocation();
+	const int32 StartNode = SurfaceNavGraph->FindNearestNode(OwnerLocation, SurfaceDetectionRange);
+	const int32 GoalNode = SurfaceNavGraph->FindNearestNode(TargetLocation, SurfaceDetectionRange);
+
+	// The nearest node may lie behind geometry; the goal stays set, so this target is crawled to with traces instead
+	if (StartNode == INDEX_NONE || !IsSurfacePathSegmentClear(OwnerLocation, SurfaceNavGraph->GetNode(StartNode).Location))
+	{
+		return false;
+	}
+
+	if (!SurfaceNavGraph->FindPath(StartNode, GoalNode, SurfacePathNodes))
+	{
+		SurfacePathNodes.Reset();
+		return false;
+	}
+
+	SurfacePathIndex = 0;
+	bIsFollowingSurfacePath = true;
+	LastSurfacePathTime = GetWorld()->GetTimeSeconds();
+	return true;
+}
+
+void USurfacePathfindingComponent::FollowSurfacePath(const FVector& TargetLocation, float DeltaTime, float Speed)
+{
+	LastSurfacePathTime = GetWorld()->GetTimeSeconds();
+
+	FVector Location = CachedOwner->GetActorLocation();
+	FVector Normal = CurrentSurfaceNormal;
+	float RemainingDistance = Speed * DeltaTime;
+	bool bBlocked = false;
+
+	// Consume this frame's movement budget across as many route segments as it covers
+	while (RemainingDistance > KINDA_SMALL_NUMBER)
+	{
+		const bool bFinalSegment = SurfacePathIndex >= SurfacePathNodes.Num();
+		const FVector WaypointLocation = bFinalSegment ? TargetLocation : SurfaceNavGraph->GetNode(SurfacePathNodes[SurfacePathIndex]).Location;
+		const FVector WaypointNormal = bFinalSegment ? Normal : SurfaceNavGraph->GetNode(SurfacePathNodes[SurfacePathIndex]).Normal;
+
+		const FVector ToWaypoint = WaypointLocation - Location;
+		const float SegmentLength = ToWaypoint.Size();
+		const bool bPartialSegment = SegmentLength > RemainingDistance;
+		const float Alpha = bPartialSegment ? RemainingDistance / SegmentLength : 1.0f;
+
+		// The bake only saw static geometry; stop where something blocks the leg
+		if (!IsSurfacePathSegmentClear(Location, Location + ToWaypoint * Alpha))
 		{
-			// Snap to detected surface
-			CachedOwner->SetActorLocation(NearestSurfaceLocation);
-			CurrentSurfaceNormal = NearestSurfaceNormal;
-			bIsOnSurface = true;
-			
-			// Align to new surface
-			AlignToSurface(NearestSurfaceNormal, DeltaTime);
+			bBlocked = true;
+			break;
 		}
-		else
+
+		if (bPartialSegment)
 		{
-			// No surface found, just move normally
-			CachedOwner->SetActorLocation(DesiredLocation);
-			bIsOnSurface = false;
+			// Partway along the segment: blend the normal so surface transitions turn smoothly
+			Location += ToWaypoint * Alpha;
+			Normal = FMath::Lerp(Normal, WaypointNormal, Alpha).GetSafeNormal();
+			break;
+		}
+
+		Location = WaypointLocation;
+		Normal = WaypointNormal;
+		RemainingDistance -= SegmentLength;
+
+		if (bFinalSegment)
+		{
+			break;
 		}
+		++SurfacePathIndex;
 	}
 
-	return true; // Still moving
+	CommitCrawlStep(Location, Normal, DeltaTime);
+
+	// The route places the owner itself; the crawl mode only has to hold on to where it ends up
+	if (IsCrawlMovementActive())
+	{
+		CrawlMovement->StopCrawlMove();
+		CrawlMovement->SetCrawlSurface(Location, Normal);
+	}
+
+	// Leave the route but keep its goal, so the rest of the way to this target is crawled with traces
+	if (bBlocked)
+	{
+		SurfacePathNodes.Reset();
+		SurfacePathIndex = 0;
+		bIsFollowingSurfacePath = false;
+	}
+}
+
+bool USurfacePathfindingComponent::IsSurfacePathSegmentClear(const FVector& Start, const FVector& End)
+{
+	ReportTraces(1);
+	INC_DWORD_STAT(STAT_AuraMonster_TracesSurfacePath);
+
+	// Route points are SurfaceOffset off their surface, so a sphere of half that doesn't touch the surface being crawled on
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SurfacePathSweep), false, CachedOwner);
+	return !GetWorld()->SweepTestByChannel(Start, End, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeSphere(SurfaceTraceUtils::SurfaceOffset * 0.5f), QueryParams);
+}
+
+void USurfacePathfindingComponent::ClearSurfacePath()
+{
+	SurfacePathNodes.Reset();
+	SurfacePathIndex = 0;
+	bHasSurfacePathGoal = false;
+	bIsFollowingSurfacePath = false;
+}
+
+bool USurfacePathfindingComponent::IsCrawlMovementActive() const
+{
+	return CrawlMovement && CrawlMovement->IsCrawling();
 }
 
 bool USurfacePathfindingComponent::IsOnValidSurface() const
@@ -219,78 +723,465 @@ bool USurfacePathfindingComponent::IsOnValidSurface() const
 
 bool USurfacePathfindingComponent::DetectSurface(const FVector& Location, FVector& OutHitLocation, FVector& OutHitNormal)
 {
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_DetectSurface);
+
 	if (!GetWorld())
 	{
 		return false;
 	}
 
+	// Static geometry: distance and normal come from a trilinear lookup, no traces
+	bool bFieldFoundSurface = false;
+	if (bUseDistanceField && SampleDistanceFieldSurface(Location, bFieldFoundSurface, OutHitLocation, OutHitNormal))
+	{
+		return bFieldFoundSurface;
+	}
+
+	// In the deferred trace modes, answer from the latest contact instead of blocking on new traces;
+	// UpdateSurfaceDeferred keeps the contact fresh one frame behind
+	if (TraceMode != ESurfaceTraceMode::Synchronous && LastContact.bIsValid)
+	{
+		OutHitLocation = LastContact.ProjectOntoPlane(Location);
+		OutHitNormal = LastContact.Normal;
+		return FVector::DistSquared(OutHitLocation, Location) <= FMath::Square(SurfaceDetectionRange);
+	}
+
+	// Nothing has changed since the last trace (idle, stopped at a patrol point), so the same rays would hit the same surface
+	if (IsSurfaceContactCacheValid(Location))
+	{
+		OutHitLocation = SurfaceContactCache.Contact.ProjectOntoPlane(Location);
+		OutHitNormal = SurfaceContactCache.Contact.Normal;
+		return true;
+	}
+
 	// Perform multi-directional traces to detect surfaces in all directions
 	// This allows detection of floors, walls, and ceilings
-	
-	const FVector TraceDirections[] = {
-		FVector(0, 0, -1),  // Down (floor)
-		FVector(0, 0, 1),   // Up (ceiling)
-		FVector(1, 0, 0),   // Right (wall)
-		FVector(-1, 0, 0),  // Left (wall)
-		FVector(0, 1, 0),   // Forward (wall)
-		FVector(0, -1, 0)   // Backward (wall)
-	};
-
 	FCollisionQueryParams QueryParams;
 	QueryParams.AddIgnoredActor(CachedOwner);
 
 	// Find surfaces and score them based on distance and alignment with current normal
-	float BestScore = -1.0f;
+	ReportTraces(UE_ARRAY_COUNT(SurfaceTraceUtils::TraceDirections));
+	INC_DWORD_STAT_BY(STAT_AuraMonster_TracesDetectSurface, UE_ARRAY_COUNT(SurfaceTraceUtils::TraceDirections));
+	FSurfaceContact Contact;
+	if (SurfaceTraceUtils::TraceNearestSurface(GetWorld(), Location, SurfaceDetectionRange, QueryParams, bIsOnSurface, CurrentSurfaceNormal, Contact))
+	{
+		CacheSurfaceContact(Location, Contact);
+
+		OutHitLocation = Contact.Location;
+		OutHitNormal = Contact.Normal;
+		return true;
+	}
+
+	return false;
+}
+
+bool USurfacePathfindingComponent::SampleDistanceFieldSurface(const FVector& Location, bool& bOutFoundSurface, FVector& OutHitLocation, FVector& OutHitNormal)
+{
+	if (!DistanceField)
+	{
+		UWorld* World = GetWorld();
+		DistanceField = World ? World->GetSubsystem<USurfaceDistanceFieldSubsystem>() : nullptr;
+		if (!DistanceField)
+		{
+			return false;
+		}
+	}
+
+	float Distance = 0.0f;
+	FVector Gradient;
+	if (!DistanceField->SampleDistance(Location, Distance, Gradient))
+	{
+		return false;
+	}
+
+	// The field only stores distances up to its max; beyond that it can only rule out surfaces within that max
+	if (Distance >= DistanceField->GetMaxDistance() - KINDA_SMALL_NUMBER)
+	{
+		if (SurfaceDetectionRange > DistanceField->GetMaxDistance())
+		{
+			return false;
+		}
+
+		bOutFoundSurface = false;
+		return true;
+	}
+
+	if (Distance > SurfaceDetectionRange)
+	{
+		bOutFoundSurface = false;
+		return true;
+	}
+
+	// A flat gradient (e.g. exactly halfway between two parallel walls) gives no usable normal
+	if (Gradient.SizeSquared() < KINDA_SMALL_NUMBER)
+	{
+		return false;
+	}
+
+	// The gradient points away from the nearest surface, i.e. it is the surface normal
+	OutHitNormal = Gradient.GetSafeNormal();
+	OutHitLocation = Location - OutHitNormal * Distance + OutHitNormal * SurfaceTraceUtils::SurfaceOffset;
+	bOutFoundSurface = true;
+	return true;
+}
+
+void USurfacePathfindingComponent::InvalidateSurfaceContactCache()
+{
+	SurfaceContactCache.Contact.bIsValid = false;
+}
+
+bool USurfacePathfindingComponent::IsSurfaceContactCacheValid(const FVector& Location) const
+{
+	const FSurfaceContact& Contact = SurfaceContactCache.Contact;
+	if (!bUseSurfaceContactCache || !Contact.bIsValid || !CachedOwner)
+	{
+		return false;
+	}
+
+	// The owner moved or turned
+	if (FVector::DistSquared(Location, SurfaceContactCache.QueryLocation) > FMath::Square(SurfaceCacheMoveThreshold))
+	{
+		return false;
+	}
+
+	const float RotationThreshold = FMath::DegreesToRadians(SurfaceCacheRotationThreshold);
+	if (CachedOwner->GetActorQuat().AngularDistance(SurfaceContactCache.QueryRotation) > RotationThreshold)
+	{
+		return false;
+	}
+
+	// Hits are scored against the current surface, so a different current surface could pick a different winner
+	if (FVector::DotProduct(CurrentSurfaceNormal, SurfaceContactCache.QueryNormal) < FMath::Cos(RotationThreshold))
+	{
+		return false;
+	}
+
+	if (SurfaceCacheMaxAge > 0.0f && GetWorld()->GetTimeSeconds() - SurfaceContactCache.Time > SurfaceCacheMaxAge)
+	{
+		return false;
+	}
+
+	// The surface itself moved (physics, animation, a moving platform) or no longer blocks traces
+	const UPrimitiveComponent* HitComponent = Contact.HitComponent.Get();
+	if (!HitComponent
+		|| !HitComponent->IsQueryCollisionEnabled()
+		|| HitComponent->GetCollisionResponseToChannel(ECC_Visibility) != ECR_Block
+		|| !HitComponent->GetComponentTransform().Equals(SurfaceContactCache.HitComponentTransform))
+	{
+		return false;
+	}
+
+	return true;
+}
+
+bool USurfacePathfindingComponent::IsSurfaceTraceDue() const
+{
+	return SurfaceTraceInterval <= 0.0f || GetWorld()->GetTimeSeconds() - LastSurfaceTraceTime >= SurfaceTraceInterval;
+}
+
+void USurfacePathfindingComponent::ReportTraces(int32 NumTraces)
+{
+	if (BudgetSubsystem)
+	{
+		BudgetSubsystem->ReportTraces(NumTraces);
+	}
+}
+
+void USurfacePathfindingComponent::CacheSurfaceContact(const FVector& QueryLocation, const FSurfaceContact& Contact)
+{
+	const UPrimitiveComponent* HitComponent = Contact.HitComponent.Get();
+	if (!bUseSurfaceContactCache || !Contact.bIsValid || !HitComponent || !CachedOwner)
+	{
+		InvalidateSurfaceContactCache();
+		return;
+	}
+
+	SurfaceContactCache.Contact = Contact;
+	SurfaceContactCache.QueryLocation = QueryLocation;
+	SurfaceContactCache.QueryRotation = CachedOwner->GetActorQuat();
+	SurfaceContactCache.QueryNormal = CurrentSurfaceNormal;
+	SurfaceContactCache.HitComponentTransform = HitComponent->GetComponentTransform();
+	SurfaceContactCache.Time = GetWorld()->GetTimeSeconds();
+}
+
+float USurfacePathfindingComponent::ScoreSurfaceHit(const FVector& Origin, const FHitResult& HitResult) const
+{
+	return SurfaceTraceUtils::ScoreSurfaceHit(Origin, HitResult, SurfaceDetectionRange, bIsOnSurface, CurrentSurfaceNormal);
+}
+
+bool USurfacePathfindingComponent::TraceForward(const FVector& TraceStart, const FVector& TraceEnd, FHitResult& OutHit)
+{
+	UWorld* World = GetWorld();
+	ReportTraces(1);
+	INC_DWORD_STAT(STAT_AuraMonster_TracesForward);
+
+	FCollisionQueryParams QueryParams;
+	QueryParams.AddIgnoredActor(CachedOwner);
+
+	if (TraceMode == ESurfaceTraceMode::Batched)
+	{
+		// Use the answer to the previous request, then queue this one. Results are kept until consumed,
+		// since at a reduced LOD tick rate the previous request may be several frames old.
+		bool bHit = false;
+		if (LatestForwardResult.Frame != 0 && LatestForwardResult.Contact.bIsValid)
+		{
+			OutHit = FHitResult();
+			OutHit.Location = OutHit.ImpactPoint = LatestForwardResult.Contact.Location;
+			OutHit.Normal = OutHit.ImpactNormal = LatestForwardResult.Contact.Normal;
+			OutHit.bBlockingHit = true;
+			bHit = true;
+		}
+		LatestForwardResult.Frame = 0;
+
+		FSurfaceQueryRequest Request;
+		Request.Type = ESurfaceQueryType::ForwardTrace;
+		Request.Origin = TraceStart;
+		Request.End = TraceEnd;
+		if (SubmitSurfaceQuery(Request))
+		{
+			return bHit;
+		}
+	}
+
+	if (TraceMode != ESurfaceTraceMode::Async)
+	{
+		return World->LineTraceSingleByChannel(OutHit, TraceStart, TraceEnd, ECC_Visibility, QueryParams);
+	}
+
+	// Async trace data is only kept for one frame; when we tick at a reduced LOD rate it is gone, so trace now
+	if (PendingForwardTrace.IsValid() && GFrameCounter > PendingForwardTraceFrame + 1)
+	{
+		PendingForwardTrace = FTraceHandle();
+		return World->LineTraceSingleByChannel(OutHit, TraceStart, TraceEnd, ECC_Visibility, QueryParams);
+	}
+
+	// Use last frame's result - the owner has moved at most one step since it was queued
+	bool bHit = false;
+	FTraceDatum TraceData;
+	if (PendingForwardTrace.IsValid() && World->QueryTraceData(PendingForwardTrace, TraceData) && TraceData.OutHits.Num() > 0)
+	{
+		OutHit = TraceData.OutHits[0];
+		bHit = OutHit.bBlockingHit;
+	}
+
+	PendingForwardTrace = World->AsyncLineTraceByChannel(EAsyncTraceType::Single, TraceStart, TraceEnd, ECC_Visibility, QueryParams);
+	PendingForwardTraceFrame = GFrameCounter;
+	return bHit;
+}
+
+void USurfacePathfindingComponent::UpdateSurfaceDeferred(float DeltaTime)
+{
+	UWorld* World = GetWorld();
+
+	// Consume the results of the queries issued on our previous update. Batched results are kept until consumed;
+	// async trace data only for one frame, so if none of it can be read we keep extrapolating the previous contact.
+	bool bHasResults = false;
 	bool bFoundSurface = false;
+	bool bTracedNow = false;
+	FSurfaceContact NewContact;
+	FVector NewContactOrigin = PendingSurfaceTraceOrigin;
+
+	if (TraceMode == ESurfaceTraceMode::Batched)
+	{
+		if (LatestDetectResult.Frame != 0)
+		{
+			bHasResults = true;
+			bFoundSurface = LatestDetectResult.Contact.bIsValid;
+			NewContact = LatestDetectResult.Contact;
+			NewContactOrigin = LatestDetectResult.Origin;
+			LatestDetectResult.Frame = 0;
+		}
+	}
 
-	for (const FVector& Direction : TraceDirections)
+	// Ticking at a reduced LOD rate, the async trace data expired before we got to read it: trace now instead
+	if (PendingSurfaceTraces.Num() > 0 && GFrameCounter > PendingSurfaceTraceFrame + 1)
 	{
-		FVector TraceStart = Location;
-		FVector TraceEnd = Location + Direction * SurfaceDetectionRange;
+		FCollisionQueryParams QueryParams;
+		QueryParams.AddIgnoredActor(CachedOwner);
 
-		FHitResult HitResult;
-		if (GetWorld()->LineTraceSingleByChannel(HitResult, TraceStart, TraceEnd, ECC_Visibility, QueryParams))
+		PendingSurfaceTraces.Reset();
+		NewContactOrigin = CachedOwner->GetActorLocation();
+		ReportTraces(UE_ARRAY_COUNT(SurfaceTraceUtils::TraceDirections));
+		INC_DWORD_STAT_BY(STAT_AuraMonster_TracesDetectSurface, UE_ARRAY_COUNT(SurfaceTraceUtils::TraceDirections));
+		bFoundSurface = SurfaceTraceUtils::TraceNearestSurface(World, NewContactOrigin, SurfaceDetectionRange, QueryParams, bIsOnSurface, CurrentSurfaceNormal, NewContact);
+		bHasResults = true;
+		bTracedNow = true;
+		LastSurfaceTraceTime = World->GetTimeSeconds();
+	}
+
+	// Async traces (also the fallback when the query service is unavailable)
+	{
+		float BestScore = -1.0f;
+		for (const FTraceHandle& Handle : PendingSurfaceTraces)
 		{
-			float HitDistance = (HitResult.Location - Location).Size();
-			
-			// Score based on distance (closer is better) and alignment with current surface
-			// This helps maintain continuity when moving along surfaces
-			float DistanceScore = 1.0f - (HitDistance / SurfaceDetectionRange);
-			
-			// If we're on a surface, prefer surfaces that are similar to current orientation
-			float AlignmentScore = 0.5f; // Neutral score if no current surface
-			if (bIsOnSurface)
+			FTraceDatum TraceData;
+			if (!World->QueryTraceData(Handle, TraceData))
 			{
-				float DotProduct = FVector::DotProduct(CurrentSurfaceNormal, HitResult.Normal);
-				// Positive dot = similar orientation, negative = opposite
-				AlignmentScore = (DotProduct + 1.0f) * 0.5f; // Map [-1,1] to [0,1]
+				continue;
 			}
-			
-			// Combined score: 70% distance, 30% alignment
-			float Score = (DistanceScore * 0.7f) + (AlignmentScore * 0.3f);
-			
-			if (Score > BestScore)
+
+			bHasResults = true;
+			for (const FHitResult& HitResult : TraceData.OutHits)
+			{
+				if (!HitResult.bBlockingHit)
+				{
+					continue;
+				}
+
+				const float Score = ScoreSurfaceHit(PendingSurfaceTraceOrigin, HitResult);
+				if (Score > BestScore)
+				{
+					BestScore = Score;
+					NewContact.Location = HitResult.Location + HitResult.Normal * SurfaceTraceUtils::SurfaceOffset;
+					NewContact.Normal = HitResult.Normal;
+					NewContact.bIsValid = true;
+					NewContact.Distance = HitResult.Distance;
+					NewContact.HitComponent = HitResult.GetComponent();
+					bFoundSurface = true;
+				}
+			}
+		}
+	}
+
+	if (bHasResults)
+	{
+		if (bFoundSurface)
+		{
+			LastContact = NewContact;
+			bHasKnownSurface = true;
+			CacheSurfaceContact(NewContactOrigin, NewContact);
+		}
+		else
+		{
+			LastContact.bIsValid = false;
+			InvalidateSurfaceContactCache();
+		}
+	}
+
+	// Queue this frame's queries; results arrive next frame
+	const FVector Location = CachedOwner->GetActorLocation();
+
+	// Skip them while the owner stays put - the answer would be the contact we already have -
+	// and while the trace budget has nothing left, extrapolating the last contact instead
+	if (bTracedNow || IsSurfaceContactCacheValid(Location) || (LastContact.bIsValid && !IsSurfaceTraceDue()))
+	{
+		PendingSurfaceTraces.Reset();
+	}
+	else
+	{
+		LastSurfaceTraceTime = World->GetTimeSeconds();
+		ReportTraces(UE_ARRAY_COUNT(SurfaceTraceUtils::TraceDirections));
+		INC_DWORD_STAT_BY(STAT_AuraMonster_TracesDetectSurface, UE_ARRAY_COUNT(SurfaceTraceUtils::TraceDirections));
+
+		FSurfaceQueryRequest Request;
+		Request.Type = ESurfaceQueryType::DetectSurface;
+		Request.Origin = Location;
+		Request.Range = SurfaceDetectionRange;
+		Request.bHasCurrentSurface = bIsOnSurface;
+		Request.CurrentNormal = CurrentSurfaceNormal;
+
+		if (TraceMode != ESurfaceTraceMode::Batched || !SubmitSurfaceQuery(Request))
+		{
+			FCollisionQueryParams QueryParams;
+			QueryParams.AddIgnoredActor(CachedOwner);
+
+			PendingSurfaceTraces.Reset();
+			PendingSurfaceTraceOrigin = Location;
+			PendingSurfaceTraceFrame = GFrameCounter;
+			for (const FVector& Direction : SurfaceTraceUtils::TraceDirections)
 			{
-				BestScore = Score;
-				OutHitLocation = HitResult.Location + HitResult.Normal * 10.0f; // Offset from surface
-				OutHitNormal = HitResult.Normal;
-				bFoundSurface = true;
+				PendingSurfaceTraces.Add(World->AsyncLineTraceByChannel(EAsyncTraceType::Single, Location, Location + Direction * SurfaceDetectionRange, ECC_Visibility, QueryParams));
 			}
 		}
 	}
 
-	return bFoundSurface;
+	// Align to the extrapolated contact
+	FVector HitLocation, HitNormal;
+	if (LastContact.bIsValid && DetectSurface(Location, HitLocation, HitNormal))
+	{
+		CurrentSurfaceNormal = HitNormal;
+		AlignToSurface(HitNormal, DeltaTime);
+	}
+	else if (bHasResults)
+	{
+		// Fresh results found nothing in range, same as a synchronous miss
+		bIsOnSurface = false;
+	}
+}
+
+bool USurfacePathfindingComponent::SubmitSurfaceQuery(FSurfaceQueryRequest& Request)
+{
+	if (!SurfaceQueryService)
+	{
+		UWorld* World = GetWorld();
+		SurfaceQueryService = World ? World->GetSubsystem<USurfaceQuerySubsystem>() : nullptr;
+		if (!SurfaceQueryService)
+		{
+			return false;
+		}
+
+		// Our own tick reads the detection results
+		SurfaceQueryService->AddBatchPrerequisite(PrimaryComponentTick);
+	}
+
+	// The controller drives movement and random target searches, so it has to run after the batch too.
+	// It may possess the owner after BeginPlay, hence the lazy check.
+	if (!bHasControllerBatchPrerequisite)
+	{
+		if (APawn* OwnerPawn = Cast<APawn>(CachedOwner))
+		{
+			if (AController* Controller = OwnerPawn->GetController())
+			{
+				SurfaceQueryService->AddBatchPrerequisite(Controller->PrimaryActorTick);
+				bHasControllerBatchPrerequisite = true;
+			}
+		}
+	}
+
+	Request.Requester = this;
+	Request.QueryParams = FCollisionQueryParams(SCENE_QUERY_STAT(SurfaceQueryBatch), false, CachedOwner);
+	SurfaceQueryService->SubmitQuery(Request);
+	return true;
+}
+
+void USurfacePathfindingComponent::ReceiveSurfaceQueryResult(const FSurfaceQueryResult& Result)
+{
+	switch (Result.Type)
+	{
+		case ESurfaceQueryType::DetectSurface:
+			LatestDetectResult = Result;
+			break;
+
+		case ESurfaceQueryType::RandomLocation:
+			LatestRandomLocationResult = Result;
+			bIsRandomLocationPending = false;
+			break;
+
+		case ESurfaceQueryType::ForwardTrace:
+			LatestForwardResult = Result;
+			break;
+	}
 }
 
 void USurfacePathfindingComponent::AlignToSurface(const FVector& TargetNormal, float DeltaTime)
 {
-	if (!CachedOwner)
+	if (!CachedOwner || !bAlignToSurface)
 	{
 		return;
 	}
 
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_AlignToSurface);
+	CachedOwner->SetActorRotation(GetAlignedRotation(TargetNormal, DeltaTime));
+}
+
+FRotator USurfacePathfindingComponent::GetAlignedRotation(const FVector& TargetNormal, float DeltaTime) const
+{
 	// Calculate the target rotation that aligns the actor's up vector with the surface normal
 	FRotator CurrentRotation = CachedOwner->GetActorRotation();
+	if (!bAlignToSurface)
+	{
+		return CurrentRotation;
+	}
 	
 	// Get current forward direction and ensure it's normalized
 	FVector CurrentForward = CachedOwner->GetActorForwardVector();
@@ -315,13 +1206,48 @@ void USurfacePathfindingComponent::AlignToSurface(const FVector& TargetNormal, f
 	FRotator TargetRotation = UKismetMathLibrary::MakeRotationFromAxes(ForwardVector, RightVector, TargetNormal);
 
 	// Smoothly interpolate to the target rotation
-	FRotator NewRotation = FMath::RInterpTo(CurrentRotation, TargetRotation, DeltaTime, SurfaceAlignmentSpeed);
-	
-	CachedOwner->SetActorRotation(NewRotation);
+	return FMath::RInterpTo(CurrentRotation, TargetRotation, DeltaTime, SurfaceAlignmentSpeed);
 }
 
-bool USurfacePathfindingComponent::ShouldAttemptSurfaceTransition() const
+void USurfacePathfindingComponent::CommitCrawlStep(const FVector& Location, const FVector& Normal, float DeltaTime)
+{
+	CachedOwner->SetActorLocationAndRotation(Location, GetAlignedRotation(Normal, DeltaTime));
+
+	CurrentSurfaceNormal = Normal;
+	bIsOnSurface = true;
+
+	// Remember the new surface so async extrapolation follows it until fresh results arrive
+	LastContact.Location = Location;
+	LastContact.Normal = Normal;
+	LastContact.bIsValid = true;
+	bHasKnownSurface = true;
+
+	CrawlStepFrame = GFrameCounter;
+}
+
+void USurfacePathfindingComponent::AddControllerTickPrerequisite()
+{
+	if (bHasControllerTickPrerequisite)
+	{
+		return;
+	}
+
+	// The controller may possess the owner after BeginPlay, hence the lazy check
+	const APawn* OwnerPawn = Cast<APawn>(CachedOwner);
+	if (AController* Controller = OwnerPawn ? OwnerPawn->GetController() : nullptr)
+	{
+		PrimaryComponentTick.AddPrerequisite(Controller, Controller->PrimaryActorTick);
+		bHasControllerTickPrerequisite = true;
+	}
+}
+
+bool USurfacePathfindingComponent::ShouldAttemptSurfaceTransition()
 {
 	// Use randomness to create unpredictable surface transitions
-	return FMath::FRand() < SurfaceTransitionChance;
+	return GetRandomStream().FRand() < SurfaceTransitionChance;
+}
+
+FRandomStream& USurfacePathfindingComponent::GetRandomStream()
+{
+	return CachedMonsterOwner ? CachedMonsterOwner->GetRandomStream() : OwnRandomStream;
 }
@@ -0,0 +1,327 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SurfacePointCloudSubsystem.h"
+#include "SurfaceSampling.h"
+#include "Async/Async.h"
+#include "Components/PrimitiveComponent.h"
+#include "EngineUtils.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<float> CVarSurfacePointCloudSpacing(
+	TEXT("AuraMonster.PointCloud.Spacing"),
+	100.0f,
+	TEXT("Grid spacing used to sample the level's static collision into the surface point cloud."),
+	ECVF_Default);
+
+static TAutoConsoleVariable<int32> CVarSurfacePointCloudMaxGridPoints(
+	TEXT("AuraMonster.PointCloud.MaxGridPoints"),
+	1000000,
+	TEXT("Maximum number of sampling grid points; the spacing grows on large levels to stay under it."),
+	ECVF_Default);
+
+namespace
+{
+	/** Index cells span this many sampling grid steps */
+	constexpr float CellSizeInSpacings = 4.0f;
+}
+
+USurfacePointCloudSubsystem::USurfacePointCloudSubsystem()
+{
+	bBuildRequested = false;
+}
+
+bool USurfacePointCloudSubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Only game worlds have monsters looking for crawl targets
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void USurfacePointCloudSubsystem::Deinitialize()
+{
+	// The build traces against this world, it must not outlive it
+	CancelBuild();
+	PointCloud.Reset();
+
+	Super::Deinitialize();
+}
+
+void USurfacePointCloudSubsystem::EnsureBuildStarted()
+{
+	// Static collision isn't in place until the level's actors are initialized
+	const UWorld* World = GetWorld();
+	if (!bBuildRequested && World && World->AreActorsInitialized())
+	{
+		RebuildPointCloud();
+	}
+}
+
+void USurfacePointCloudSubsystem::RebuildPointCloud()
+{
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return;
+	}
+
+	bBuildRequested = true;
+	CancelBuild();
+
+	// Sample the box around all static geometry that blocks surface traces
+	FBox LevelBounds(ForceInit);
+	for (TActorIterator<AActor> It(World); It; ++It)
+	{
+		TInlineComponentArray<UPrimitiveComponent*> Primitives(*It);
+		for (const UPrimitiveComponent* Primitive : Primitives)
+		{
+			if (Primitive->Mobility == EComponentMobility::Static
+				&& Primitive->IsQueryCollisionEnabled()
+				&& Primitive->GetCollisionResponseToChannel(ECC_Visibility) == ECR_Block)
+			{
+				LevelBounds += Primitive->Bounds.GetBox();
+			}
+		}
+	}
+
+	if (!LevelBounds.IsValid)
+	{
+		return;
+	}
+
+	// Coarsen the grid on large levels so the build stays bounded
+	const float MaxGridPoints = FMath::Max(1, CVarSurfacePointCloudMaxGridPoints.GetValueOnGameThread());
+	const FVector Size = LevelBounds.GetSize();
+	const float MinSpacing = FMath::Pow(FMath::Max(Size.X * Size.Y * Size.Z, 1.0f) / MaxGridPoints, 1.0f / 3.0f);
+	const float Spacing = FMath::Max3(CVarSurfacePointCloudSpacing.GetValueOnGameThread(), MinSpacing, 10.0f);
+
+	FCollisionQueryParams QueryParams(SCENE_QUERY_STAT(SurfacePointCloudBuild), false);
+	QueryParams.MobilityType = EQueryMobilityType::Static;
+
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> CancelFlag = MakeShared<FThreadSafeBool, ESPMode::ThreadSafe>(false);
+	BuildCancelFlag = CancelFlag;
+
+	// Scene queries only read the physics scene, so the whole build can run on a worker thread;
+	// Deinitialize waits for it before the world goes away
+	BuildTask = Async(EAsyncExecution::ThreadPool, [World, LevelBounds, Spacing, QueryParams, CancelFlag]()
+	{
+		TArray<FSurfaceSample> Samples;
+		SurfaceSampling::SampleSurfacesInBox(World, LevelBounds, Spacing, QueryParams, Samples, CancelFlag.Get());
+
+		TSharedPtr<FSurfacePointCloud, ESPMode::ThreadSafe> Cloud = MakeShared<FSurfacePointCloud, ESPMode::ThreadSafe>();
+		if (*CancelFlag)
+		{
+			return Cloud;
+		}
+
+		Cloud->CellSize = Spacing * CellSizeInSpacings;
+		Cloud->Locations.Reserve(Samples.Num());
+		Cloud->Normals.Reserve(Samples.Num());
+		for (const FSurfaceSample& Sample : Samples)
+		{
+			const int32 PointIndex = Cloud->Locations.Add(Sample.Location);
+			Cloud->Normals.Add(Sample.Normal);
+			Cloud->CellPoints.FindOrAdd(Cloud->GetCell(Sample.Location)).Add(PointIndex);
+		}
+
+		return Cloud;
+	});
+}
+
+bool USurfacePointCloudSubsystem::IsPointCloudReady()
+{
+	ConsumeFinishedBuild();
+	return PointCloud.IsValid() && PointCloud->Locations.Num() > 0;
+}
+
+void USurfacePointCloudSubsystem::ConsumeFinishedBuild()
+{
+	if (BuildTask.IsValid() && BuildTask.IsReady())
+	{
+		PointCloud = BuildTask.Get();
+		BuildTask = TFuture<TSharedPtr<FSurfacePointCloud, ESPMode::ThreadSafe>>();
+		BuildCancelFlag.Reset();
+	}
+}
+
+void USurfacePointCloudSubsystem::CancelBuild()
+{
+	if (BuildTask.IsValid())
+	{
+		if (BuildCancelFlag.IsValid())
+		{
+			*BuildCancelFlag = true;
+		}
+
+		BuildTask.Wait();
+		BuildTask = TFuture<TSharedPtr<FSurfacePointCloud, ESPMode::ThreadSafe>>();
+	}
+
+	BuildCancelFlag.Reset();
+}
+
+bool USurfacePointCloudSubsystem::FindRandomPointInRange(const FVector& Origin, float MinDistance, float MaxDistance, FVector& OutLocation, FVector& OutNormal, FRandomStream& RandomStream)
+{
+	EnsureBuildStarted();
+	if (!IsPointCloudReady())
+	{
+		return false;
+	}
+
+	const FSurfacePointCloud& Cloud = *PointCloud;
+	const float MinDistanceSq = FMath::Square(MinDistance);
+	const float MaxDistanceSq = FMath::Square(MaxDistance);
+
+	int32 ChosenPoint = INDEX_NONE;
+
+	// Probe a few random cells first - this is constant time and succeeds almost always on populated levels
+	const int32 MaxProbes = 16;
+	for (int32 Probe = 0; Probe < MaxProbes && ChosenPoint == INDEX_NONE; ++Probe)
+	{
+		const FVector ProbeLocation = Origin + RandomStream.VRand() * RandomStream.FRandRange(MinDistance, MaxDistance);
+		const TArray<int32>* CellPoints = Cloud.CellPoints.Find(Cloud.GetCell(ProbeLocation));
+		if (!CellPoints || CellPoints->Num() == 0)
+		{
+			continue;
+		}
+
+		const int32 PointIndex = (*CellPoints)[RandomStream.RandHelper(CellPoints->Num())];
+		const float DistanceSq = FVector::DistSquared(Cloud.Locations[PointIndex], Origin);
+		if (DistanceSq >= MinDistanceSq && DistanceSq <= MaxDistanceSq)
+		{
+			ChosenPoint = PointIndex;
+		}
+	}
+
+	// Sparse surroundings - reservoir sample every point in range, visiting only the cells the range overlaps
+	if (ChosenPoint == INDEX_NONE)
+	{
+		const FIntVector MinCell = Cloud.GetCell(Origin - FVector(MaxDistance));
+		const FIntVector MaxCell = Cloud.GetCell(Origin + FVector(MaxDistance));
+
+		int32 NumCandidates = 0;
+		for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+		{
+			for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+			{
+				for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+				{
+					const TArray<int32>* CellPoints = Cloud.CellPoints.Find(FIntVector(X, Y, Z));
+					if (!CellPoints)
+					{
+						continue;
+					}
+
+					for (int32 PointIndex : *CellPoints)
+					{
+						const float DistanceSq = FVector::DistSquared(Cloud.Locations[PointIndex], Origin);
+						if (DistanceSq >= MinDistanceSq && DistanceSq <= MaxDistanceSq)
+						{
+							++NumCandidates;
+							if (RandomStream.RandHelper(NumCandidates) == 0)
+							{
+								ChosenPoint = PointIndex;
+							}
+						}
+					}
+				}
+			}
+		}
+	}
+
+	if (ChosenPoint == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutLocation = Cloud.Locations[ChosenPoint];
+	OutNormal = Cloud.Normals[ChosenPoint];
+	return true;
+}
+
+bool USurfacePointCloudSubsystem::FindVisiblePointInRange(const FVector& Origin, float MinDistance, float MaxDistance, const FCollisionQueryParams& QueryParams, int32 MaxCandidates,
+	FVector& OutLocation, FVector& OutNormal, FRandomStream& RandomStream, int32* OutNumTraces)
+{
+	if (OutNumTraces)
+	{
+		*OutNumTraces = 0;
+	}
+
+	UWorld* World = GetWorld();
+	if (!World)
+	{
+		return false;
+	}
+
+	for (int32 Candidate = 0; Candidate < MaxCandidates; ++Candidate)
+	{
+		FVector Location, Normal;
+		if (!FindRandomPointInRange(Origin, MinDistance, MaxDistance, Location, Normal, RandomStream))
+		{
+			return false;
+		}
+
+		if (OutNumTraces)
+		{
+			++*OutNumTraces;
+		}
+
+		// Points sit slightly off their surface, so the trace only hits geometry in between
+		if (!World->LineTraceTestByChannel(Origin, Location, ECC_Visibility, QueryParams))
+		{
+			OutLocation = Location;
+			OutNormal = Normal;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool USurfacePointCloudSubsystem::FindNearestPoint(const FVector& Location, float MaxDistance, FVector& OutLocation, FVector& OutNormal)
+{
+	EnsureBuildStarted();
+	if (!IsPointCloudReady())
+	{
+		return false;
+	}
+
+	const FSurfacePointCloud& Cloud = *PointCloud;
+	const FIntVector MinCell = Cloud.GetCell(Location - FVector(MaxDistance));
+	const FIntVector MaxCell = Cloud.GetCell(Location + FVector(MaxDistance));
+
+	int32 NearestPoint = INDEX_NONE;
+	float NearestDistanceSq = FMath::Square(MaxDistance);
+	for (int32 X = MinCell.X; X <= MaxCell.X; ++X)
+	{
+		for (int32 Y = MinCell.Y; Y <= MaxCell.Y; ++Y)
+		{
+			for (int32 Z = MinCell.Z; Z <= MaxCell.Z; ++Z)
+			{
+				const TArray<int32>* CellPoints = Cloud.CellPoints.Find(FIntVector(X, Y, Z));
+				if (!CellPoints)
+				{
+					continue;
+				}
+
+				for (int32 PointIndex : *CellPoints)
+				{
+					const float DistanceSq = FVector::DistSquared(Cloud.Locations[PointIndex], Location);
+					if (DistanceSq <= NearestDistanceSq)
+					{
+						NearestDistanceSq = DistanceSq;
+						NearestPoint = PointIndex;
+					}
+				}
+			}
+		}
+	}
+
+	if (NearestPoint == INDEX_NONE)
+	{
+		return false;
+	}
+
+	OutLocation = Cloud.Locations[NearestPoint];
+	OutNormal = Cloud.Normals[NearestPoint];
+	return true;
+}
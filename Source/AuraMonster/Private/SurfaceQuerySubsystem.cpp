@@ -0,0 +1,199 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SurfaceQuerySubsystem.h"
+#include "SurfacePathfindingComponent.h"
+#include "SurfaceTraceUtils.h"
+#include "AuraMonsterStats.h"
+#include "Engine/World.h"
+#include "Engine/Level.h"
+#include "Async/ParallelFor.h"
+#include "HAL/IConsoleManager.h"
+
+static TAutoConsoleVariable<int32> CVarSurfaceQueryParallelBatchSize(
+	TEXT("AuraMonster.SurfaceQuery.ParallelBatchSize"),
+	32,
+	TEXT("Minimum number of queued surface queries before a batch is spread across worker threads. 0 disables parallel execution."),
+	ECVF_Default);
+
+namespace
+{
+	/** Spread the low 21 bits of a value so two zero bits separate each of them */
+	uint64 SpreadBits(uint64 Value)
+	{
+		Value &= 0x1fffff;
+		Value = (Value | Value << 32) & 0x1f00000000ffff;
+		Value = (Value | Value << 16) & 0x1f0000ff0000ff;
+		Value = (Value | Value << 8) & 0x100f00f00f00f00f;
+		Value = (Value | Value << 4) & 0x10c30c30c30c30c3;
+		Value = (Value | Value << 2) & 0x1249249249249249;
+		return Value;
+	}
+
+	/** Morton (Z-order) key of a location, so queries close in space are executed next to each other */
+	uint64 GetMortonKey(const FVector& Location)
+	{
+		const float CellSize = 256.0f;
+		const int32 Bias = 1 << 20;
+
+		auto Quantize = [CellSize, Bias](float Value) -> uint64
+		{
+			return static_cast<uint64>(FMath::Clamp(FMath::FloorToInt(Value / CellSize) + Bias, 0, (Bias << 1) - 1));
+		};
+
+		return SpreadBits(Quantize(Location.X)) | (SpreadBits(Quantize(Location.Y)) << 1) | (SpreadBits(Quantize(Location.Z)) << 2);
+	}
+}
+
+void FSurfaceQueryBatchTickFunction::ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent)
+{
+	if (Target)
+	{
+		Target->ExecuteBatch();
+	}
+}
+
+FString FSurfaceQueryBatchTickFunction::DiagnosticMessage()
+{
+	return TEXT("FSurfaceQueryBatchTickFunction");
+}
+
+USurfaceQuerySubsystem::USurfaceQuerySubsystem()
+{
+	BatchTickFunction.bCanEverTick = true;
+	BatchTickFunction.bStartWithTickEnabled = true;
+	BatchTickFunction.bRunOnAnyThread = false;
+	BatchTickFunction.TickGroup = TG_PrePhysics;
+	BatchTickFunction.Target = this;
+
+	LastBatchSize = 0;
+}
+
+bool USurfaceQuerySubsystem::ShouldCreateSubsystem(UObject* Outer) const
+{
+	// Only game worlds have monsters ticking
+	const UWorld* World = Cast<UWorld>(Outer);
+	return World && World->IsGameWorld();
+}
+
+void USurfaceQuerySubsystem::Deinitialize()
+{
+	if (BatchTickFunction.IsTickFunctionRegistered())
+	{
+		BatchTickFunction.UnRegisterTickFunction();
+	}
+
+	PendingRequests.Reset();
+
+	Super::Deinitialize();
+}
+
+void USurfaceQuerySubsystem::SubmitQuery(const FSurfaceQueryRequest& Request)
+{
+	RegisterBatchTickFunction();
+	PendingRequests.Add(Request);
+}
+
+void USurfaceQuerySubsystem::AddBatchPrerequisite(FTickFunction& TickFunction)
+{
+	RegisterBatchTickFunction();
+	TickFunction.AddPrerequisite(this, BatchTickFunction);
+}
+
+void USurfaceQuerySubsystem::RegisterBatchTickFunction()
+{
+	if (BatchTickFunction.IsTickFunctionRegistered())
+	{
+		return;
+	}
+
+	UWorld* World = GetWorld();
+	if (World && World->PersistentLevel)
+	{
+		BatchTickFunction.RegisterTickFunction(World->PersistentLevel);
+	}
+}
+
+void USurfaceQuerySubsystem::ExecuteBatch()
+{
+	AURAMONSTER_SCOPE_CYCLE_COUNTER(STAT_AuraMonster_SurfaceQueryBatch);
+
+	UWorld* World = GetWorld();
+
+	// Take ownership of the queue - anything submitted while results are delivered goes to the next batch
+	TArray<FSurfaceQueryRequest> Batch = MoveTemp(PendingRequests);
+	PendingRequests.Reset();
+
+	LastBatchSize = Batch.Num();
+	if (!World || Batch.Num() == 0)
+	{
+		return;
+	}
+
+	// Spatial ordering keeps neighbouring queries together, which helps the physics broadphase caches
+	TArray<TPair<uint64, int32>> Order;
+	Order.Reserve(Batch.Num());
+	for (int32 Index = 0; Index < Batch.Num(); ++Index)
+	{
+		Order.Emplace(GetMortonKey(Batch[Index].Origin), Index);
+	}
+	Order.Sort([](const TPair<uint64, int32>& A, const TPair<uint64, int32>& B)
+	{
+		return A.Key < B.Key;
+	});
+
+	TArray<FSurfaceQueryResult> Results;
+	Results.SetNum(Batch.Num());
+
+	const uint64 Frame = GFrameCounter;
+	const int32 ParallelBatchSize = CVarSurfaceQueryParallelBatchSize.GetValueOnGameThread();
+	const bool bForceSingleThread = ParallelBatchSize <= 0 || Batch.Num() < ParallelBatchSize;
+
+	// Scene queries only read the physics scene, so they can run on worker threads
+	// (the world's own async trace tasks do the same). Each iteration writes only its own result slot.
+	ParallelFor(Order.Num(), [&Batch, &Order, &Results, World, Frame](int32 OrderIndex)
+	{
+		const FSurfaceQueryRequest& Request = Batch[Order[OrderIndex].Value];
+		FSurfaceQueryResult& Result = Results[OrderIndex];
+
+		Result.Type = Request.Type;
+		Result.Origin = Request.Origin;
+		Result.Frame = Frame;
+
+		switch (Request.Type)
+		{
+			case ESurfaceQueryType::DetectSurface:
+				SurfaceTraceUtils::TraceNearestSurface(World, Request.Origin, Request.Range, Request.QueryParams, Request.bHasCurrentSurface, Request.CurrentNormal, Result.Contact);
+				break;
+
+			case ESurfaceQueryType::RandomLocation:
+			{
+				FRandomStream RandomStream(Request.RandomSeed);
+				Result.NumTraces = Request.MaxAttempts;
+				SurfaceTraceUtils::TraceRandomSurfaceLocation(World, Request.Origin, Request.Range, Request.MaxAttempts, Request.QueryParams, RandomStream, Result.Contact, &Result.NumTraces);
+				break;
+			}
+
+			case ESurfaceQueryType::ForwardTrace:
+			{
+				// Forward results carry the raw hit point, MoveTowardsSurfaceLocation applies its own offset
+				FHitResult HitResult;
+				if (World->LineTraceSingleByChannel(HitResult, Request.Origin, Request.End, ECC_Visibility, Request.QueryParams))
+				{
+					Result.Contact.Location = HitResult.Location;
+					Result.Contact.Normal = HitResult.Normal;
+					Result.Contact.bIsValid = true;
+				}
+				break;
+			}
+		}
+	}, bForceSingleThread);
+
+	// Hand results back on the game thread, before any requester ticks this frame
+	for (int32 OrderIndex = 0; OrderIndex < Order.Num(); ++OrderIndex)
+	{
+		if (USurfacePathfindingComponent* Requester = Batch[Order[OrderIndex].Value].Requester.Get())
+		{
+			Requester->ReceiveSurfaceQueryResult(Results[OrderIndex]);
+		}
+	}
+}
@@ -0,0 +1,90 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SurfaceSampling.h"
+#include "Engine/World.h"
+
+namespace SurfaceSampling
+{
+	/** Map a normal to one of six buckets (dominant axis and sign) so opposite faces of a thin wall stay distinct */
+	static int32 GetNormalBucket(const FVector& Normal)
+	{
+		const FVector Abs = Normal.GetAbs();
+		if (Abs.X >= Abs.Y && Abs.X >= Abs.Z)
+		{
+			return Normal.X >= 0.0f ? 0 : 1;
+		}
+		if (Abs.Y >= Abs.Z)
+		{
+			return Normal.Y >= 0.0f ? 2 : 3;
+		}
+		return Normal.Z >= 0.0f ? 4 : 5;
+	}
+
+	void SampleSurfacesInBox(const UWorld* World, const FBox& Box, float Spacing, const FCollisionQueryParams& QueryParams, TArray<FSurfaceSample>& OutSamples, const FThreadSafeBool* CancelFlag)
+	{
+		if (!World || !Box.IsValid || Spacing <= KINDA_SMALL_NUMBER)
+		{
+			return;
+		}
+
+		const FVector TraceDirections[] = {
+			FVector(0, 0, -1),
+			FVector(0, 0, 1),
+			FVector(1, 0, 0),
+			FVector(-1, 0, 0),
+			FVector(0, 1, 0),
+			FVector(0, -1, 0)
+		};
+
+		const FVector Size = Box.GetSize();
+		const int32 CountX = FMath::Max(1, FMath::CeilToInt(Size.X / Spacing) + 1);
+		const int32 CountY = FMath::Max(1, FMath::CeilToInt(Size.Y / Spacing) + 1);
+		const int32 CountZ = FMath::Max(1, FMath::CeilToInt(Size.Z / Spacing) + 1);
+
+		// Key: quantized hit cell + normal bucket, so neighbouring grid points that hit the same patch collapse
+		TSet<TPair<FIntVector, int32>> SeenCells;
+
+		for (int32 X = 0; X < CountX; ++X)
+		{
+			for (int32 Y = 0; Y < CountY; ++Y)
+			{
+				if (CancelFlag && *CancelFlag)
+				{
+					return;
+				}
+
+				for (int32 Z = 0; Z < CountZ; ++Z)
+				{
+					const FVector GridPoint = Box.Min + FVector(X, Y, Z) * Spacing;
+
+					// Grid points embedded in geometry would produce back-face hits, skip them
+					if (World->OverlapBlockingTestByChannel(GridPoint, FQuat::Identity, ECC_Visibility, FCollisionShape::MakeSphere(1.0f), QueryParams))
+					{
+						continue;
+					}
+
+					for (const FVector& Direction : TraceDirections)
+					{
+						FHitResult HitResult;
+						if (!World->LineTraceSingleByChannel(HitResult, GridPoint, GridPoint + Direction * Spacing, ECC_Visibility, QueryParams))
+						{
+							continue;
+						}
+
+						const FIntVector Cell(
+							FMath::FloorToInt(HitResult.Location.X / Spacing),
+							FMath::FloorToInt(HitResult.Location.Y / Spacing),
+							FMath::FloorToInt(HitResult.Location.Z / Spacing));
+
+						bool bAlreadySeen = false;
+						SeenCells.Add(TPair<FIntVector, int32>(Cell, GetNormalBucket(HitResult.Normal)), &bAlreadySeen);
+						if (!bAlreadySeen)
+						{
+							OutSamples.Emplace(HitResult.Location + HitResult.Normal * SurfaceOffset, HitResult.Normal);
+						}
+					}
+				}
+			}
+		}
+	}
+}
@@ -0,0 +1,56 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "HAL/ThreadSafeBool.h"
+
+class UWorld;
+
+/**
+ * A single crawlable surface sample (floor, wall or ceiling point)
+ */
+struct FSurfaceSample
+{
+	/** Sample location, already offset away from the surface */
+	FVector Location;
+
+	/** Surface normal at the sample */
+	FVector Normal;
+
+	FSurfaceSample()
+		: Location(FVector::ZeroVector)
+		, Normal(FVector::UpVector)
+	{
+	}
+
+	FSurfaceSample(const FVector& InLocation, const FVector& InNormal)
+		: Location(InLocation)
+		, Normal(InNormal)
+	{
+	}
+};
+
+/**
+ * Offline/load-time helpers for discovering crawlable surfaces in a region of the level.
+ * These are meant for baking and background builds, never for per-frame movement.
+ */
+namespace SurfaceSampling
+{
+	/** Distance samples are pushed away from the surface, matches the runtime surface offset */
+	constexpr float SurfaceOffset = 10.0f;
+
+	/**
+	 * Sample surfaces inside a box by tracing the six axis directions from a regular grid.
+	 * Samples are deduplicated per grid cell and dominant normal axis, so each surface patch
+	 * produces at most one sample per cell.
+	 * @param World World to trace against
+	 * @param Box Region to sample
+	 * @param Spacing Grid spacing, also used as the trace length
+	 * @param QueryParams Collision params used for every trace
+	 * @param OutSamples Receives the discovered samples
+	 * @param CancelFlag Optional flag checked between grid rows, so background builds can be abandoned
+	 */
+	void SampleSurfacesInBox(const UWorld* World, const FBox& Box, float Spacing, const FCollisionQueryParams& QueryParams, TArray<FSurfaceSample>& OutSamples, const FThreadSafeBool* CancelFlag = nullptr);
+}
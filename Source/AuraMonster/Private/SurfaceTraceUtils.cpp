@@ -0,0 +1,96 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SurfaceTraceUtils.h"
+#include "Engine/World.h"
+
+namespace SurfaceTraceUtils
+{
+	const FVector TraceDirections[6] = {
+		FVector(0, 0, -1),  // Down (floor)
+		FVector(0, 0, 1),   // Up (ceiling)
+		FVector(1, 0, 0),   // Right (wall)
+		FVector(-1, 0, 0),  // Left (wall)
+		FVector(0, 1, 0),   // Forward (wall)
+		FVector(0, -1, 0)   // Backward (wall)
+	};
+
+	float ScoreSurfaceHit(const FVector& Origin, const FHitResult& HitResult, float DetectionRange, bool bHasCurrentSurface, const FVector& CurrentNormal)
+	{
+		float HitDistance = (HitResult.Location - Origin).Size();
+
+		// Score based on distance (closer is better) and alignment with current surface
+		// This helps maintain continuity when moving along surfaces
+		float DistanceScore = 1.0f - (HitDistance / DetectionRange);
+
+		// If we're on a surface, prefer surfaces that are similar to current orientation
+		float AlignmentScore = 0.5f; // Neutral score if no current surface
+		if (bHasCurrentSurface)
+		{
+			float DotProduct = FVector::DotProduct(CurrentNormal, HitResult.Normal);
+			// Positive dot = similar orientation, negative = opposite
+			AlignmentScore = (DotProduct + 1.0f) * 0.5f; // Map [-1,1] to [0,1]
+		}
+
+		// Combined score: 70% distance, 30% alignment
+		return (DistanceScore * 0.7f) + (AlignmentScore * 0.3f);
+	}
+
+	bool TraceNearestSurface(const UWorld* World, const FVector& Location, float DetectionRange, const FCollisionQueryParams& QueryParams, bool bHasCurrentSurface, const FVector& CurrentNormal, FSurfaceContact& OutContact)
+	{
+		float BestScore = -1.0f;
+		bool bFoundSurface = false;
+
+		for (const FVector& Direction : TraceDirections)
+		{
+			FHitResult HitResult;
+			if (World->LineTraceSingleByChannel(HitResult, Location, Location + Direction * DetectionRange, ECC_Visibility, QueryParams))
+			{
+				const float Score = ScoreSurfaceHit(Location, HitResult, DetectionRange, bHasCurrentSurface, CurrentNormal);
+				if (Score > BestScore)
+				{
+					BestScore = Score;
+					OutContact.Location = HitResult.Location + HitResult.Normal * SurfaceOffset;
+					OutContact.Normal = HitResult.Normal;
+					OutContact.bIsValid = true;
+					OutContact.Distance = HitResult.Distance;
+					OutContact.HitComponent = HitResult.GetComponent();
+					bFoundSurface = true;
+				}
+			}
+		}
+
+		return bFoundSurface;
+	}
+
+	bool TraceRandomSurfaceLocation(const UWorld* World, const FVector& Origin, float Range, int32 MaxAttempts, const FCollisionQueryParams& QueryParams, FRandomStream& RandomStream, FSurfaceContact& OutContact, int32* OutNumTraces)
+	{
+		for (int32 Attempt = 0; Attempt < MaxAttempts; ++Attempt)
+		{
+			if (OutNumTraces)
+			{
+				*OutNumTraces = Attempt + 1;
+			}
+
+			// Generate a random direction
+			const FVector RandomDirection = RandomStream.VRand();
+
+			// Scale by range - use full range to reach distant surfaces
+			const float RandomDistance = RandomStream.FRandRange(Range * 0.5f, Range);
+
+			// Cast a ray from origin in the random direction to find surfaces
+			FHitResult HitResult;
+			if (World->LineTraceSingleByChannel(HitResult, Origin, Origin + RandomDirection * RandomDistance, ECC_Visibility, QueryParams))
+			{
+				// Move the location slightly away from the surface to avoid being embedded
+				OutContact.Location = HitResult.Location + HitResult.Normal * SurfaceOffset;
+				OutContact.Normal = HitResult.Normal;
+				OutContact.bIsValid = true;
+				OutContact.Distance = HitResult.Distance;
+				OutContact.HitComponent = HitResult.GetComponent();
+				return true;
+			}
+		}
+
+		return false;
+	}
+}
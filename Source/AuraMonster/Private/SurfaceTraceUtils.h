@@ -0,0 +1,49 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "CollisionQueryParams.h"
+#include "SurfaceQueryTypes.h"
+
+class UWorld;
+struct FHitResult;
+
+/**
+ * Trace routines shared by USurfacePathfindingComponent and USurfaceQuerySubsystem.
+ * They only read their arguments, so the query subsystem can run them on worker threads.
+ */
+namespace SurfaceTraceUtils
+{
+	/** Axis-aligned directions traced to find floors, walls and ceilings */
+	extern const FVector TraceDirections[6];
+
+	/** Distance contacts are pushed away from the surface to avoid being embedded */
+	constexpr float SurfaceOffset = 10.0f;
+
+	/**
+	 * Score a surface hit: closer surfaces and surfaces aligned with the current one score higher
+	 * @param Origin Point the trace started from
+	 * @param HitResult The surface hit
+	 * @param DetectionRange Trace length used to normalize the distance
+	 * @param bHasCurrentSurface Whether CurrentNormal is meaningful
+	 * @param CurrentNormal Normal of the surface the monster is currently on
+	 * @return Score in [0, 1]
+	 */
+	float ScoreSurfaceHit(const FVector& Origin, const FHitResult& HitResult, float DetectionRange, bool bHasCurrentSurface, const FVector& CurrentNormal);
+
+	/**
+	 * Trace the six axis directions and keep the best scoring surface
+	 * @return True if a surface was found
+	 */
+	bool TraceNearestSurface(const UWorld* World, const FVector& Location, float DetectionRange, const FCollisionQueryParams& QueryParams, bool bHasCurrentSurface, const FVector& CurrentNormal, FSurfaceContact& OutContact);
+
+	/**
+	 * Cast random rays from an origin until one hits a surface
+	 * @param MaxAttempts Maximum number of rays
+	 * @param RandomStream Stream the ray directions and lengths are drawn from
+	 * @param OutNumTraces If set, receives the number of rays cast
+	 * @return True if a surface was found
+	 */
+	bool TraceRandomSurfaceLocation(const UWorld* World, const FVector& Origin, float Range, int32 MaxAttempts, const FCollisionQueryParams& QueryParams, FRandomStream& RandomStream, FSurfaceContact& OutContact, int32* OutNumTraces = nullptr);
+}
@@ -0,0 +1,216 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "MonsterBenchmark.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+#include "Interfaces/IPluginManager.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Misc/Parse.h"
+#include "Dom/JsonObject.h"
+#include "Serialization/JsonReader.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+/**
+ * Performance regression tests: fixed-seed monster scenarios run through MonsterBenchmark, with the game thread time
+ * of monster AI (controllers and surface pathfinding) and the surface traces per frame compared against the baselines
+ * in the plugin's Resources/PerfBaselines. Run them headless with
+ * UE4Editor-Cmd <Project>.uproject -ExecCmds="Automation RunTests AuraMonster.Performance; Quit" -nullrhi -unattended
+ */
+namespace MonsterPerformanceTests
+{
+	/**
+	 * The baseline files only hold tolerances until the measurements are recorded with -UpdateMonsterPerfBaselines on
+	 * the reference machine, and the tests fail without them, so they stay out of the perf filter until then.
+	 * Switch StressFilter back to PerfFilter in the commit that adds the recorded baselines.
+	 */
+	constexpr uint32 ScenarioFlags = EAutomationTestFlags::EditorContext | EAutomationTestFlags::ClientContext | EAutomationTestFlags::StressFilter;
+
+	/** Allowed increase over a baseline, as a share of it, when a baseline file doesn't say */
+	constexpr float DefaultTimeTolerance = 0.25f;
+	constexpr float DefaultTraceTolerance = 0.1f;
+
+	/** Allowed increase on top of the share, so near-zero baselines don't fail on noise */
+	constexpr float TimeSlackMs = 0.05f;
+	constexpr float TraceSlack = 1.0f;
+
+	/**
+	 * Fixed-seed settings the scenarios share; only the state mix differs. Idle monsters stay idle instead of going
+	 * on patrol, and the navmesh is only built over the generated level when there are standing patrollers to use it.
+	 */
+	FMonsterBenchmarkSettings MakeScenarioSettings(float IdleWeight, float PatrolStandingWeight, float PatrolCrawlingWeight)
+	{
+		FMonsterBenchmarkSettings Settings;
+		Settings.Level.NumRooms = 4;
+		Settings.bBuildNavigation = PatrolStandingWeight > 0.0f;
+		Settings.NumMonsters = 64;
+		Settings.IdleWeight = IdleWeight;
+		Settings.PatrolStandingWeight = PatrolStandingWeight;
+		Settings.PatrolCrawlingWeight = PatrolCrawlingWeight;
+		Settings.PatrolTransitionChance = 0.0f;
+		Settings.WarmupFrames = 30;
+		Settings.NumFrames = 300;
+		Settings.FixedDeltaTime = 1.0f / 30.0f;
+		Settings.Seed = 1337;
+		Settings.ForceLODTier = 0;
+		return Settings;
+	}
+
+	FString GetBaselinePath(const FString& ScenarioName)
+	{
+		const TSharedPtr<IPlugin> Plugin = IPluginManager::Get().FindPlugin(TEXT("AuraMonster"));
+		const FString BaseDir = Plugin.IsValid() ? Plugin->GetBaseDir() : FPaths::Combine(FPaths::ProjectPluginsDir(), TEXT("AuraMonster"));
+		return FPaths::Combine(BaseDir, TEXT("Resources"), TEXT("PerfBaselines"), ScenarioName + TEXT(".json"));
+	}
+
+	float GetMean(const TArray<int32>& Values)
+	{
+		int64 Sum = 0;
+		for (const int32 Value : Values)
+		{
+			Sum += Value;
+		}
+		return Values.Num() > 0 ? static_cast<float>(Sum) / Values.Num() : 0.0f;
+	}
+
+	/**
+	 * Run a scenario and check it against its baseline; a metric missing from the baseline fails the test. With
+	 * -UpdateMonsterPerfBaselines on the command line, the measurements are written to the baseline file instead, to be committed.
+	 */
+	bool RunScenario(FAutomationTestBase& Test, const FString& ScenarioName, const FMonsterBenchmarkSettings& Settings)
+	{
+		FMonsterBenchmarkResults Results;
+		if (!MonsterBenchmark::Run(Settings, Results))
+		{
+			Test.AddError(TEXT("The scenario's world couldn't be set up"));
+			return false;
+		}
+
+		if (!Test.TestEqual(TEXT("Spawned monsters"), Results.NumMonsters, Settings.NumMonsters))
+		{
+			return false;
+		}
+
+		// Without a navmesh standing patrols would only measure failed path requests
+		if (Settings.bBuildNavigation && !Results.bBuiltNavigation)
+		{
+			Test.AddError(TEXT("Couldn't build a navmesh over the generated level"));
+			return false;
+		}
+
+		TArray<float> FrameTraces;
+		for (const int32 Traces : Results.FrameTraces)
+		{
+			FrameTraces.Add(static_cast<float>(Traces));
+		}
+
+		struct FMetric
+		{
+			const TCHAR* Name;
+			float Value;
+			bool bIsTime;
+		};
+		const FMetric Metrics[] =
+		{
+			{ TEXT("MonsterMsP50"), FMonsterBenchmarkResults::GetPercentile(Results.MonsterTimesMs, 50.0f), true },
+			{ TEXT("MonsterMsP95"), FMonsterBenchmarkResults::GetPercentile(Results.MonsterTimesMs, 95.0f), true },
+			{ TEXT("TracesPerFrameMean"), GetMean(Results.FrameTraces), false },
+			{ TEXT("TracesPerFrameP95"), FMonsterBenchmarkResults::GetPercentile(FrameTraces, 95.0f), false },
+		};
+
+		const FString BaselinePath = GetBaselinePath(ScenarioName);
+		TSharedPtr<FJsonObject> Baseline;
+		FString BaselineJson;
+		if (FFileHelper::LoadFileToString(BaselineJson, *BaselinePath))
+		{
+			FJsonSerializer::Deserialize(TJsonReaderFactory<>::Create(BaselineJson), Baseline);
+		}
+		if (!Baseline.IsValid())
+		{
+			Baseline = MakeShared<FJsonObject>();
+		}
+
+		double TimeTolerance = DefaultTimeTolerance;
+		double TraceTolerance = DefaultTraceTolerance;
+		Baseline->TryGetNumberField(TEXT("TimeTolerance"), TimeTolerance);
+		Baseline->TryGetNumberField(TEXT("TraceTolerance"), TraceTolerance);
+
+		if (FParse::Param(FCommandLine::Get(), TEXT("UpdateMonsterPerfBaselines")))
+		{
+			for (const FMetric& Metric : Metrics)
+			{
+				Baseline->SetNumberField(Metric.Name, Metric.Value);
+			}
+			Baseline->SetNumberField(TEXT("TimeTolerance"), TimeTolerance);
+			Baseline->SetNumberField(TEXT("TraceTolerance"), TraceTolerance);
+
+			FString UpdatedJson;
+			FJsonSerializer::Serialize(Baseline.ToSharedRef(), TJsonWriterFactory<>::Create(&UpdatedJson));
+			if (FFileHelper::SaveStringToFile(UpdatedJson, *BaselinePath))
+			{
+				Test.AddWarning(FString::Printf(TEXT("Recorded the measurements as the baseline in %s; commit it"), *BaselinePath));
+			}
+			else
+			{
+				Test.AddError(FString::Printf(TEXT("Couldn't write the baseline %s"), *BaselinePath));
+			}
+
+			return !Test.HasAnyErrors();
+		}
+
+		for (const FMetric& Metric : Metrics)
+		{
+			double BaselineValue = 0.0;
+			if (!Baseline->TryGetNumberField(Metric.Name, BaselineValue))
+			{
+				Test.AddError(FString::Printf(TEXT("%s has no baseline in %s; record one with -UpdateMonsterPerfBaselines on the reference machine"), Metric.Name, *BaselinePath));
+				continue;
+			}
+
+			const double Limit = Metric.bIsTime
+				? BaselineValue * (1.0 + TimeTolerance) + TimeSlackMs
+				: BaselineValue * (1.0 + TraceTolerance) + TraceSlack;
+			if (Metric.Value > Limit)
+			{
+				Test.AddError(FString::Printf(TEXT("%s regressed: %.3f against a baseline of %.3f (limit %.3f)"), Metric.Name, Metric.Value, BaselineValue, Limit));
+			}
+			else
+			{
+				Test.AddInfo(FString::Printf(TEXT("%s: %.3f (baseline %.3f)"), Metric.Name, Metric.Value, BaselineValue));
+			}
+		}
+
+		return !Test.HasAnyErrors();
+	}
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMonsterCrawlPerformanceTest, "AuraMonster.Performance.Crawl", MonsterPerformanceTests::ScenarioFlags)
+
+bool FMonsterCrawlPerformanceTest::RunTest(const FString& Parameters)
+{
+	// Every monster crawls, so the time and traces are mostly USurfacePathfindingComponent's
+	return MonsterPerformanceTests::RunScenario(*this, TEXT("CrawlScenario"), MonsterPerformanceTests::MakeScenarioSettings(0.0f, 0.0f, 1.0f));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMonsterIdlePerformanceTest, "AuraMonster.Performance.Idle", MonsterPerformanceTests::ScenarioFlags)
+
+bool FMonsterIdlePerformanceTest::RunTest(const FString& Parameters)
+{
+	// Every monster idles, so the time is AMonsterAIController's behavior updates and scheduling without movement
+	return MonsterPerformanceTests::RunScenario(*this, TEXT("IdleScenario"), MonsterPerformanceTests::MakeScenarioSettings(1.0f, 0.0f, 0.0f));
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FMonsterPatrolPerformanceTest, "AuraMonster.Performance.Patrol", MonsterPerformanceTests::ScenarioFlags)
+
+bool FMonsterPatrolPerformanceTest::RunTest(const FString& Parameters)
+{
+	// Every monster patrols standing on the navmesh built over the level, so the time is destination picks, path requests and move scheduling
+	return MonsterPerformanceTests::RunScenario(*this, TEXT("PatrolScenario"), MonsterPerformanceTests::MakeScenarioSettings(0.0f, 1.0f, 0.0f));
+}
+
+#endif // WITH_DEV_AUTOMATION_TESTS
@@ -5,11 +5,19 @@
 #include "CoreMinimal.h"
 #include "AIController.h"
 #include "MonsterBehaviorState.h"
+#include "MonsterAIRuntimeState.h"
+#include "MonsterAIIntent.h"
+#include "MonsterTimingWheel.h"
 #include "MonsterAIController.generated.h"
 
 class AMonsterCharacter;
 class UNavigationSystemV1;
 class UPathFollowingComponent;
+class UMonsterTickManager;
+class UMonsterTimerSubsystem;
+class UMonsterPatrolPointSubsystem;
+class UMonsterBudgetSubsystem;
+class USurfacePathfindingComponent;
 
 /**
  * AI Controller for managing monster behavior and state transitions
@@ -24,7 +32,10 @@ public:
 
 protected:
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+	virtual void OnPossess(APawn* InPawn) override;
 	virtual void Tick(float DeltaTime) override;
+	virtual void OnMoveCompleted(FAIRequestID RequestID, const FPathFollowingResult& Result) override;
 
 public:
 	/** Transition to a new behavior state */
@@ -35,6 +46,32 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Monster AI")
 	EMonsterBehaviorState GetCurrentState() const { return CurrentState; }
 
+	/**
+	 * Continue from state captured elsewhere, e.g. by UMonsterHordeSubsystem while the monster had no actor
+	 * @param State Behavior state to switch to
+	 * @param InRuntimeState Timers and patrol state to continue from
+	 */
+	void RestoreRuntimeState(EMonsterBehaviorState State, const FMonsterAIRuntimeState& InRuntimeState);
+
+	/**
+	 * Set how often the behavior runs, whether from this controller's tick or from UMonsterTickManager
+	 * @param TickInterval Seconds between behavior updates (0 = every frame)
+	 */
+	void SetBehaviorTickInterval(float TickInterval);
+
+	/**
+	 * Set the chance of going on patrol when an idle spell ends
+	 * @param Chance Chance from 0.0 (always stay idle) to 1.0
+	 */
+	void SetPatrolTransitionChance(float Chance);
+
+	/**
+	 * Current breathing intensity (0.0 to 1.0). With bUseScheduledTimers, OnBreathingUpdate only runs when
+	 * the monster wakes, so animation should poll this instead (or use UMonsterAnimInstance).
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Monster AI")
+	float GetBreathingIntensity();
+
 protected:
 	/** Execute behavior for the idle state */
 	UFUNCTION(BlueprintNativeEvent, Category = "Monster AI")
@@ -61,6 +98,14 @@ protected:
 	void OnExitState(EMonsterBehaviorState OldState);
 	virtual void OnExitState_Implementation(EMonsterBehaviorState OldState);
 
+	/**
+	 * Called when crawling patrol has failed to find a crawl target MaxCrawlSearchFailures times in a row.
+	 * Goes back to Idle by default.
+	 */
+	UFUNCTION(BlueprintNativeEvent, Category = "Monster AI")
+	void OnCrawlTargetSearchExhausted(int32 ConsecutiveFailures);
+	virtual void OnCrawlTargetSearchExhausted_Implementation(int32 ConsecutiveFailures);
+
 protected:
 	/** Minimum time in seconds to stay idle before potentially transitioning to patrol */
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster AI|Idle")
@@ -102,7 +147,45 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster AI|Patrol")
 	float PatrolAcceptanceRadius;
 
+	/** Seconds to wait before searching again after the first failed crawl target search; doubles with every further failure */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster AI|Patrol", meta = (ClampMin = "0.0"))
+	float CrawlSearchRetryDelay;
+
+	/** Longest wait between crawl target searches */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster AI|Patrol", meta = (ClampMin = "0.0"))
+	float MaxCrawlSearchRetryDelay;
+
+	/** Fraction (0.0 to 1.0) the retry wait is randomly lengthened or shortened by, so failing monsters don't search in lockstep */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster AI|Patrol", meta = (ClampMin = "0.0", ClampMax = "1.0"))
+	float CrawlSearchRetryJitter;
+
+	/** Consecutive failed crawl target searches that call OnCrawlTargetSearchExhausted (0 = keep searching) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster AI|Patrol", meta = (ClampMin = "0"))
+	int32 MaxCrawlSearchFailures;
+
+	/**
+	 * Let UMonsterTickManager update this monster from its single tick function instead of
+	 * separate controller, character and surface component ticks. Worth it with hundreds of monsters.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Monster AI|Performance")
+	bool bUseMonsterTickManager;
+
+	/**
+	 * Sleep while idle or stopped at a patrol destination and let UMonsterTimerSubsystem wake the monster when
+	 * the next subtle movement, idle end or stop end is due, instead of counting the timers every frame.
+	 * Only used with the native behaviors of this class. OnBreathingUpdate then only runs on wakes.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Monster AI|Performance")
+	bool bUseScheduledTimers;
+
+	/** Behavior timers and patrol state; lives in the tick manager's arrays while managed */
+	FMonsterAIRuntimeState& GetRuntimeState();
+
 private:
+	friend class UMonsterTickManager;
+	friend class UMonsterHordeSubsystem;
+	friend class UMonsterTimerSubsystem;
+
 	/** Current behavior state */
 	UPROPERTY(EditAnywhere, Category = "Monster AI")
 	EMonsterBehaviorState CurrentState;
@@ -111,50 +194,219 @@ private:
 	UPROPERTY()
 	AMonsterCharacter* ControlledMonster;
 
-	/** Time accumulated in current idle period */
-	float CurrentIdleTime;
+	/** Behavior timers and patrol state while not managed by UMonsterTickManager */
+	FMonsterAIRuntimeState RuntimeState;
 
-	/** Target idle duration for current idle period */
-	float TargetIdleDuration;
+	/** Tick manager updating this monster, if any */
+	UPROPERTY()
+	UMonsterTickManager* TickManager;
+
+	/** Index of this monster in the tick manager's arrays */
+	int32 TickManagerSlot;
 
-	/** Time accumulated since last subtle movement */
-	float TimeSinceLastSubtleMovement;
+	/** Whether the tick manager took over ticking (possibly still pending), so our own tick stays off */
+	bool bIsTickManaged;
 
-	/** Target time until next subtle movement */
-	float NextSubtleMovementTime;
+	/** Which behavior hooks a Blueprint overrides; all assumed overridden until BeginPlay looks them up */
+	uint8 bIdleBehaviorInScript : 1;
+	uint8 bPatrolStandingBehaviorInScript : 1;
+	uint8 bPatrolCrawlingBehaviorInScript : 1;
+	uint8 bOnEnterStateInScript : 1;
+	uint8 bOnExitStateInScript : 1;
 
-	/** Current time in breathing cycle */
-	float BreathingCycleTime;
+	/** Whether bUseScheduledTimers is in effect (it needs the native behaviors) */
+	uint8 bScheduledTimersInEffect : 1;
 
-	/** Time accumulated while stopped at current patrol destination */
-	float CurrentStopTime;
+	/**
+	 * Whether the standing patrol sleeps while walking and stopped, woken by OnMoveCompleted, OnPatrolPathFound
+	 * and the stop timer instead of polling path following every frame. Needs its native behavior.
+	 */
+	uint8 bPatrolStandingEventDriven : 1;
 
-	/** Target duration to stop at current patrol destination */
-	float TargetStopDuration;
+	/** Whether the behavior sleeps while the pawn walks a standing patrol move; it keeps facing the path meanwhile */
+	uint8 bWaitingWhileMoving : 1;
 
-	/** Whether the monster is currently stopped and listening/looking around */
-	bool bIsStoppedAtDestination;
+	/** Timing wheel waking this monster, if bUseScheduledTimers or the event-driven standing patrol is in effect */
+	UPROPERTY()
+	UMonsterTimerSubsystem* TimerSubsystem;
+
+	/** Pending wake */
+	FMonsterTimerHandle ScheduledWakeHandle;
+
+	/** World time the timers were last brought up to date while asleep */
+	float ScheduledTimersSyncTime;
+
+	/** BreathingCycleDuration last handed to the monster's UMonsterAnimInstance */
+	float PublishedBreathingCycleDuration;
+
+	/** Random stream of a controller without a monster; the monster's own stream is used otherwise */
+	FRandomStream UnpossessedRandomStream;
+
+	/** Async pathfinding query of the next patrol destination, 0 if none is in flight */
+	uint32 PatrolPathQueryId;
+
+	/** Path to the next patrol destination, found while stopped at the last one */
+	FNavPathSharedPtr PrefetchedPatrolPath;
+
+	/** Destination of PatrolPathQueryId or PrefetchedPatrolPath */
+	FVector PrefetchedPatrolDestination;
 
 	/** Cached reference to navigation system */
 	UPROPERTY()
 	UNavigationSystemV1* CachedNavSystem;
 
+	/** Shared pool of patrol destinations */
+	UPROPERTY()
+	UMonsterPatrolPointSubsystem* PatrolPointSubsystem;
+
+	/** Per-frame AI budget; self-ticking updates report their time to it and wait when it is spent */
+	UPROPERTY()
+	UMonsterBudgetSubsystem* BudgetSubsystem;
+
+	/** Time of the behavior updates skipped for the budget, passed on to the next one */
+	float DeferredBehaviorTime;
+
 	/** Cached reference to path following component */
 	UPROPERTY()
 	UPathFollowingComponent* CachedPathFollowingComp;
 
-	/** Current target location for surface-based crawling */
-	FVector CrawlingTargetLocation;
+	/** Sync the character with our state and start managing it; needs ControlledMonster */
+	void InitializeControlledMonster();
+
+	/** Hand the breathing phase and period to the monster's UMonsterAnimInstance, if it has one */
+	void PublishBreathingCycle();
+
+	/** Run the behavior of the current state */
+	void TickBehavior(float DeltaTime);
+
+	/** Look up which behavior hooks a Blueprint overrides, so the others skip the reflection thunk */
+	void CacheScriptOverriddenHooks();
+
+	/** Call OnEnterState, directly as OnEnterState_Implementation unless a Blueprint overrides it */
+	void CallOnEnterState(EMonsterBehaviorState NewState);
+
+	/** Call OnExitState, directly as OnExitState_Implementation unless a Blueprint overrides it */
+	void CallOnExitState(EMonsterBehaviorState OldState);
+
+	/** Go to sleep until the next timer is due if the behavior is only waiting for timers */
+	void UpdateScheduledWait();
+
+	/** Cancel the pending wake, bring the timers up to date and resume ticking */
+	void StopScheduledWait();
+
+	/** Advance the timers by the time spent asleep so far */
+	void SyncScheduledTimers();
+
+	/** Called by UMonsterTimerSubsystem when a scheduled wake is due */
+	void OnScheduledWake(const FMonsterTimerHandle& Handle);
+
+	/** Wake up, act on whatever the behavior was waiting for and go back to sleep if it is waiting again */
+	void WakeBehavior();
+
+	/**
+	 * Whether the standing patrol can run on move and path events: its behavior must be the native one of this class,
+	 * and the controller must have no Blueprint Tick that sleeping would stop
+	 */
+	bool CanDrivePatrolStandingByEvents() const;
+
+	/** Whether the current state is a standing patrol driven by events */
+	bool IsPatrolStandingEventDriven() const { return bPatrolStandingEventDriven && CurrentState == EMonsterBehaviorState::PatrolStanding; }
+
+	/** Per-frame update when driven by UMonsterTickManager, in place of Tick */
+	void TickManaged(float DeltaTime);
+
+	/** Per-frame update by UMonsterTickManager while the behavior sleeps: only face the path being walked, if any */
+	void TickManagedWaiting(float DeltaTime);
+
+	/**
+	 * Whether the behavior timers can be advanced by the tick manager's batch pass.
+	 * Only true when the behaviors are the native ones of this class, since overrides may use the timers differently.
+	 */
+	bool CanBatchBehaviorTimers() const;
+
+	/**
+	 * Per-frame update when driven by UMonsterTickManager whose behavior decision already ran on a worker thread
+	 * @param Intents Side effects of the decision, applied in order
+	 * @param NumIntents Number of intents
+	 * @param DecidedState Behavior state the decision ran in; the intents are dropped if the monster has left it since
+	 * @param DeltaTime Time since the monster's last update
+	 */
+	void TickManagedDecided(const FMonsterAIIntent* Intents, int32 NumIntents, EMonsterBehaviorState DecidedState, float DeltaTime);
+
+	/** Idle behavior once the idle timers are advanced */
+	void UpdateIdleBehavior(float DeltaTime);
+
+	/** Standing patrol behavior once the stop timer is advanced */
+	void UpdatePatrolStandingBehavior(float DeltaTime);
+
+	/** Crawling patrol behavior once the stop timer is advanced */
+	void UpdatePatrolCrawlingBehavior(float DeltaTime);
+
+	/** Read what the behavior decision of the current state needs from the world (game thread) */
+	void GatherDecisionInput(FMonsterAIDecisionInput& OutInput) const;
+
+	/**
+	 * Decide what the behavior of the current state does this update, once its timers are advanced.
+	 * Safe on worker threads: only reads this controller and writes State, the monster's random stream and OutIntents.
+	 * @param Input World state gathered by GatherDecisionInput
+	 * @param DeltaTime Time since the monster's last update
+	 * @param State Runtime state of this monster
+	 * @param OutIntents Receives the side effects to apply on the game thread
+	 */
+	void DecideBehavior(const FMonsterAIDecisionInput& Input, float DeltaTime, FMonsterAIRuntimeState& State, FMonsterAIIntentQueue& OutIntents);
+
+	/** Idle part of DecideBehavior */
+	void DecideIdleBehavior(const FMonsterAIDecisionInput& Input, float DeltaTime, FMonsterAIRuntimeState& State, FMonsterAIIntentQueue& OutIntents);
+
+	/** Standing patrol part of DecideBehavior */
+	void DecidePatrolStandingBehavior(const FMonsterAIDecisionInput& Input, float DeltaTime, FMonsterAIRuntimeState& State, FMonsterAIIntentQueue& OutIntents);
+
+	/**
+	 * Stop at the patrol destination just reached to listen/look around, finding the path to the next one meanwhile.
+	 * Safe on worker threads like DecideBehavior.
+	 */
+	void DecidePatrolStop(FMonsterAIRuntimeState& State, FMonsterAIIntentQueue& OutIntents);
+
+	/** Crawling patrol part of DecideBehavior */
+	void DecidePatrolCrawlingBehavior(const FMonsterAIDecisionInput& Input, float DeltaTime, FMonsterAIRuntimeState& State, FMonsterAIIntentQueue& OutIntents);
+
+	/**
+	 * Apply the side effects of a behavior decision, in order (game thread).
+	 * Stops as soon as the monster is no longer in the state the remaining intents were decided for, e.g. because a
+	 * Blueprint side effect of another monster or of an earlier intent changed it.
+	 */
+	void ApplyIntents(const FMonsterAIIntent* Intents, int32 NumIntents, EMonsterBehaviorState DecidedState, float DeltaTime);
+
+	/** Walk to the prefetched patrol destination, or start prefetching one if there is none yet */
+	void MoveToPatrolPoint();
+
+	/** Pick the next random reachable patrol destination and find the path to it asynchronously */
+	void PrefetchPatrolPath();
+
+	/** Abort a patrol path query in flight and drop a prefetched path */
+	void CancelPatrolPathPrefetch();
+
+	/** Async pathfinding callback of PrefetchPatrolPath */
+	void OnPatrolPathFound(uint32 QueryId, ENavigationQueryResult::Type Result, FNavPathSharedPtr Path);
+
+	/** Move request to a patrol destination, with the settings MoveToLocation would use */
+	FAIMoveRequest MakePatrolMoveRequest(const FVector& Destination) const;
 
-	/** Whether we have a valid crawling target */
-	bool bHasCrawlingTarget;
+	/** Crawl towards the crawling target, picking one first if there is none */
+	void CrawlTowardsTarget(float DeltaTime);
 
-	/** Previous location for stuck detection */
-	FVector PreviousCrawlingLocation;
+	/**
+	 * Search for a new crawl target; after failures, with a smaller range and from the last known surface
+	 * @return True if a target was found
+	 */
+	bool FindCrawlingTarget(USurfacePathfindingComponent* SurfacePathfinding, FMonsterAIRuntimeState& State);
 
-	/** Time spent with minimal movement (for stuck detection) */
-	float StuckTime;
+	/** Count a failed crawl target search and back off before the next one */
+	void HandleCrawlTargetSearchFailure(FMonsterAIRuntimeState& State);
+
+	/** Random stream of the controlled monster, behind every random behavior choice */
+	FRandomStream& GetRandomStream();
 
 	/** Helper function to get a random value within a validated range */
-	float GetValidatedRandomRange(float MinValue, float MaxValue) const;
+	float GetValidatedRandomRange(float MinValue, float MaxValue);
 };
@@ -0,0 +1,98 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MonsterBehaviorState.h"
+#include "Navigation/PathFollowingComponent.h"
+
+/**
+ * What a monster's behavior decided to do this update. Decisions only read the monster and write its
+ * FMonsterAIRuntimeState, so they can run on worker threads; everything touching the world is an intent
+ * that AMonsterAIController applies on the game thread afterwards.
+ */
+enum class EMonsterAIIntentType : uint8
+{
+	/** Switch to State */
+	TransitionToState,
+
+	/** Pick a random reachable point within patrol range and walk there */
+	MoveToPatrolPoint,
+
+	/** Stop path following */
+	StopMovement,
+
+	/** Start looking for the next patrol destination and its path in the background */
+	PrefetchPatrolPath,
+
+	/** Crawl towards the crawling target, picking one first if there is none */
+	CrawlTowardsTarget,
+
+	/** Cosmetic events of the monster character */
+	NeckTwitch,
+	FingerShift,
+
+	/** OnBreathingUpdate with Value as the intensity */
+	BreathingUpdate,
+
+	/** Hand the new breathing period to the monster's UMonsterAnimInstance */
+	PublishBreathingCycle
+};
+
+/**
+ * One deferred side effect of a behavior decision
+ */
+struct FMonsterAIIntent
+{
+	EMonsterAIIntentType Type;
+
+	/** State to switch to, for TransitionToState */
+	EMonsterBehaviorState State;
+
+	/** Breathing intensity, for BreathingUpdate */
+	float Value;
+
+	FMonsterAIIntent(EMonsterAIIntentType InType, EMonsterBehaviorState InState = EMonsterBehaviorState::Idle, float InValue = 0.0f)
+		: Type(InType)
+		, State(InState)
+		, Value(InValue)
+	{
+	}
+};
+
+/** Intents of one behavior decision, or of a batch of them; a single decision makes at most a few */
+typedef TArray<FMonsterAIIntent, TInlineAllocator<4>> FMonsterAIIntentQueue;
+
+/**
+ * World state a behavior decision reads, gathered on the game thread beforehand
+ */
+struct FMonsterAIDecisionInput
+{
+	/** Location of the monster */
+	FVector Location;
+
+	/** Status of the controller's path following */
+	EPathFollowingStatus::Type PathFollowingStatus;
+
+	/** Whether the controller has a path following component */
+	bool bHasPathFollowing;
+
+	/** Whether the move in progress reached its goal */
+	bool bDidMoveReachGoal;
+
+	/** Whether the monster has a surface pathfinding component */
+	bool bHasSurfacePathfinding;
+
+	/** Whether the monster's mesh runs a UMonsterAnimInstance */
+	bool bHasAnimInstance;
+
+	FMonsterAIDecisionInput()
+		: Location(FVector::ZeroVector)
+		, PathFollowingStatus(EPathFollowingStatus::Idle)
+		, bHasPathFollowing(false)
+		, bDidMoveReachGoal(false)
+		, bHasSurfacePathfinding(false)
+		, bHasAnimInstance(false)
+	{
+	}
+};
@@ -0,0 +1,122 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MonsterBehaviorState.h"
+
+/**
+ * Per-monster behavior timers and patrol bookkeeping of AMonsterAIController.
+ * Kept in one plain struct so UMonsterTickManager can store every managed monster's state contiguously.
+ */
+struct FMonsterAIRuntimeState
+{
+	/** Behavior state the timers belong to (mirrors AMonsterAIController::CurrentState) */
+	EMonsterBehaviorState BehaviorState;
+
+	/** Whether UMonsterTickManager advances the timers in its batch pass before the behavior update */
+	bool bAdvanceTimersInBatch;
+
+	/** Whether the behavior is asleep until UMonsterTimerSubsystem wakes it; the timers are advanced on waking */
+	bool bWaitingForScheduledWake;
+
+	/** Time accumulated in current idle period */
+	float CurrentIdleTime;
+
+	/** Target idle duration for current idle period */
+	float TargetIdleDuration;
+
+	/** Time accumulated since last subtle movement */
+	float TimeSinceLastSubtleMovement;
+
+	/** Target time until next subtle movement */
+	float NextSubtleMovementTime;
+
+	/** Current time in breathing cycle */
+	float BreathingCycleTime;
+
+	/** Time accumulated while stopped at current patrol destination */
+	float CurrentStopTime;
+
+	/** Target duration to stop at current patrol destination */
+	float TargetStopDuration;
+
+	/** Whether the monster is currently stopped and listening/looking around */
+	bool bIsStoppedAtDestination;
+
+	/** Current target location for surface-based crawling */
+	FVector CrawlingTargetLocation;
+
+	/** Whether we have a valid crawling target */
+	bool bHasCrawlingTarget;
+
+	/** Previous location for stuck detection */
+	FVector PreviousCrawlingLocation;
+
+	/** Time spent with minimal movement (for stuck detection) */
+	float StuckTime;
+
+	/** Crawl target searches that failed in a row */
+	int32 CrawlSearchFailures;
+
+	/** Seconds left before the next crawl target search, after a failed one */
+	float CrawlSearchBackoff;
+
+	FMonsterAIRuntimeState()
+		: BehaviorState(EMonsterBehaviorState::Idle)
+		, bAdvanceTimersInBatch(false)
+		, bWaitingForScheduledWake(false)
+		, CurrentIdleTime(0.0f)
+		, TargetIdleDuration(0.0f)
+		, TimeSinceLastSubtleMovement(0.0f)
+		, NextSubtleMovementTime(0.0f)
+		, BreathingCycleTime(0.0f)
+		, CurrentStopTime(0.0f)
+		, TargetStopDuration(0.0f)
+		, bIsStoppedAtDestination(false)
+		, CrawlingTargetLocation(FVector::ZeroVector)
+		, bHasCrawlingTarget(false)
+		, PreviousCrawlingLocation(FVector::ZeroVector)
+		, StuckTime(0.0f)
+		, CrawlSearchFailures(0)
+		, CrawlSearchBackoff(0.0f)
+	{
+	}
+
+	/** Advance the idle period and subtle movement timers */
+	void AdvanceIdleTimers(float DeltaTime)
+	{
+		CurrentIdleTime += DeltaTime;
+		TimeSinceLastSubtleMovement += DeltaTime;
+	}
+
+	/** Advance the patrol stop timer while stopped at a destination */
+	void AdvanceStopTimer(float DeltaTime)
+	{
+		if (bIsStoppedAtDestination)
+		{
+			CurrentStopTime += DeltaTime;
+		}
+	}
+
+	/** Advance the timers of the current behavior state */
+	void AdvanceTimers(float DeltaTime)
+	{
+		if (BehaviorState == EMonsterBehaviorState::Idle)
+		{
+			AdvanceIdleTimers(DeltaTime);
+		}
+		else
+		{
+			AdvanceStopTimer(DeltaTime);
+		}
+	}
+
+	/** Whether the behavior has anything to do this frame once the timers are advanced (a patrol stop still running has not) */
+	bool NeedsBehaviorUpdate() const
+	{
+		return BehaviorState == EMonsterBehaviorState::Idle
+			|| !bIsStoppedAtDestination
+			|| CurrentStopTime >= TargetStopDuration;
+	}
+};
@@ -0,0 +1,107 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimInstance.h"
+#include "Animation/AnimInstanceProxy.h"
+#include "MonsterAnimInstance.generated.h"
+
+class UMonsterAnimInstance;
+
+/**
+ * Animation proxy of UMonsterAnimInstance; advances the breathing cycle on the animation worker thread
+ */
+USTRUCT()
+struct AURAMONSTER_API FMonsterAnimInstanceProxy : public FAnimInstanceProxy
+{
+	GENERATED_BODY()
+
+	FMonsterAnimInstanceProxy()
+		: FAnimInstanceProxy()
+		, BreathingCycleTime(0.0f)
+		, BreathingCycleDuration(0.0f)
+		, bIsBreathing(false)
+		, BreathingIntensity(0.0f)
+	{
+	}
+
+	FMonsterAnimInstanceProxy(UAnimInstance* Instance)
+		: FAnimInstanceProxy(Instance)
+		, BreathingCycleTime(0.0f)
+		, BreathingCycleDuration(0.0f)
+		, bIsBreathing(false)
+		, BreathingIntensity(0.0f)
+	{
+	}
+
+protected:
+	/** Pick up a breathing cycle published since the last update (game thread) */
+	virtual void PreUpdate(UAnimInstance* InAnimInstance, float DeltaSeconds) override;
+
+	/** Advance the breathing cycle (worker thread) */
+	virtual void Update(float DeltaSeconds) override;
+
+	/** Hand the breathing intensity back to the anim instance (game thread) */
+	virtual void PostUpdate(UAnimInstance* InAnimInstance) const override;
+
+private:
+	/** Current time in the breathing cycle */
+	float BreathingCycleTime;
+
+	/** Breathing cycle duration in seconds */
+	float BreathingCycleDuration;
+
+	/** Whether the monster is breathing (idle) */
+	bool bIsBreathing;
+
+	/** Breathing intensity computed by the last update */
+	float BreathingIntensity;
+};
+
+/**
+ * Native anim instance for monsters. Breathing intensity is computed from the breathing phase and period
+ * during the (possibly multi-threaded) animation update, so idle monsters need no per-frame breathing
+ * events; the AI controller only publishes the cycle when it changes.
+ * Use it (or a Blueprint subclass of it) as the animation class of the monster's mesh.
+ */
+UCLASS(Transient, Blueprintable)
+class AURAMONSTER_API UMonsterAnimInstance : public UAnimInstance
+{
+	GENERATED_BODY()
+
+public:
+	UMonsterAnimInstance();
+
+	/**
+	 * Start, restart or stop the breathing cycle
+	 * @param CycleTime Current time in the cycle
+	 * @param CycleDuration Cycle duration in seconds
+	 * @param bBreathing Whether the monster is breathing; intensity is 0 otherwise
+	 */
+	void SetBreathingCycle(float CycleTime, float CycleDuration, bool bBreathing);
+
+	/** Breathing intensity computed by the last animation update */
+	float GetBreathingIntensity() const { return BreathingIntensity; }
+
+protected:
+	virtual FAnimInstanceProxy* CreateAnimInstanceProxy() override;
+	virtual void DestroyAnimInstanceProxy(FAnimInstanceProxy* InProxy) override;
+
+	/** Breathing intensity (0.0 to 1.0) for the animation graph */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Monster|Animation")
+	float BreathingIntensity;
+
+private:
+	friend struct FMonsterAnimInstanceProxy;
+
+	/** Proxy running the animation update */
+	UPROPERTY(Transient)
+	FMonsterAnimInstanceProxy Proxy;
+
+	/** Breathing cycle published by SetBreathingCycle, consumed by the proxy's next update */
+	float PendingBreathingCycleTime;
+	float PendingBreathingCycleDuration;
+	bool bPendingIsBreathing;
+	bool bHasPendingBreathingCycle;
+};
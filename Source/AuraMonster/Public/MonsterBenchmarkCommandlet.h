@@ -0,0 +1,27 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "MonsterBenchmarkCommandlet.generated.h"
+
+/**
+ * Headless monster scaling benchmark. Spawns monsters in a mix of behavior states into a generated level
+ * of rooms, corridors and shafts with a navmesh built over it (or a map), runs fixed-delta frames and writes ms/frame percentiles,
+ * traces per frame and state transition counts as JSON, with the per-frame numbers as CSV next to it.
+ *
+ * UE4Editor-Cmd <Project>.uproject -run=MonsterBenchmark -nullrhi [-Monsters=200] [-Idle=1 -Standing=1 -Crawling=2]
+ *     [-PatrolChance=0.3] [-Frames=600] [-Warmup=60] [-DeltaTime=0.0333] [-Seed=1] [-Rooms=8] [-NoLevel] [-NoNavigation] [-Map=/Game/Maps/Test]
+ *     [-LODTier=0] [-NoViewer] [-MonsterClass=/Game/BP_Monster.BP_Monster_C] [-ControllerClass=...] [-Output=Path/Without/Extension]
+ */
+UCLASS()
+class AURAMONSTER_API UMonsterBenchmarkCommandlet : public UCommandlet
+{
+	GENERATED_BODY()
+
+public:
+	UMonsterBenchmarkCommandlet();
+
+	virtual int32 Main(const FString& Params) override;
+};
@@ -0,0 +1,132 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MonsterBudgetSubsystem.generated.h"
+
+/**
+ * Per-frame budget of monster AI work: game thread milliseconds and surface traces.
+ * Monster updates and trace searches report what they cost; once a frame's budget is spent,
+ * deferrable work waits for a later frame, most important first. Importance grows with closeness
+ * to the nearest player viewpoint, time spent waiting and urgency (e.g. being stuck), so far-away
+ * monsters get staler AI rather than the frame getting longer. Both budgets are set with
+ * AuraMonster.Budget.* console variables (0 = unlimited).
+ */
+UCLASS()
+class AURAMONSTER_API UMonsterBudgetSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UMonsterBudgetSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/** Game thread milliseconds monster AI may spend per frame (0 = unlimited) */
+	static float GetFrameTimeBudgetMs();
+
+	/** Surface traces monster AI may issue per frame (0 = unlimited) */
+	static int32 GetFrameTraceBudget();
+
+	/** Add game thread time spent on monster AI this frame */
+	void ReportTime(double Seconds);
+
+	/** Add surface traces issued this frame; negative to hand back part of a reservation that went unused */
+	void ReportTraces(int32 NumTraces);
+
+	/** Milliseconds of this frame's budget not spent yet (MAX_flt when unlimited) */
+	float GetRemainingTimeMs();
+
+	/** Whether this frame's time budget is spent */
+	bool IsTimeBudgetSpent() { return GetRemainingTimeMs() <= 0.0f; }
+
+	/**
+	 * Priority of a monster update; updates with a higher one run first when the time budget is tight
+	 * @param Location Where the monster is
+	 * @param OverdueTime Seconds the update has waited past its tick interval
+	 * @param bUrgent Whether the monster needs attention (e.g. it is stuck)
+	 */
+	float GetUpdatePriority(const FVector& Location, float OverdueTime, bool bUrgent);
+
+	/**
+	 * Whether a self-ticking monster should skip its update this frame; it passes the skipped time on to its next update.
+	 * Once the time budget is spent, updates wait unless they are urgent or have waited long enough
+	 * to outrank a monster right next to a viewer.
+	 * @param Priority The update's priority from GetUpdatePriority
+	 */
+	bool ShouldDeferUpdate(float Priority);
+
+	/**
+	 * Reserve surface traces for work that may wait (e.g. a crawl target search). Within the budget the traces
+	 * are counted at once; otherwise the request queues, and the requester gets its traces on a later frame
+	 * by asking again, the closest and longest waiting requesters first.
+	 * @param Requester Object asking; one request per requester is queued
+	 * @param Location Where the traces start, for the priority
+	 * @param NumTraces Traces the work issues at most; hand back what went unused with ReportTraces
+	 * @param bUrgent Whether the work can't wait long (queued ahead of non-urgent work)
+	 * @return True if the work may run now
+	 */
+	bool TryReserveTraces(const UObject* Requester, const FVector& Location, int32 NumTraces, bool bUrgent = false);
+
+	/** Monster updates deferred this frame */
+	int32 GetNumDeferredUpdates() const { return NumDeferredUpdates; }
+
+	/** Add monster updates deferred this frame */
+	void AddDeferredUpdates(int32 NumUpdates) { NumDeferredUpdates += NumUpdates; }
+
+	/** Trace requests waiting for a later frame */
+	int32 GetNumQueuedTraceRequests() const { return TraceRequests.Num(); }
+
+	/** Game thread seconds of monster AI reported so far this frame */
+	double GetFrameSpentSeconds() const { return CurrentFrame == GFrameCounter ? SpentSeconds : 0.0; }
+
+	/** Surface traces issued or reserved so far this frame */
+	int32 GetFrameSpentTraces() const { return CurrentFrame == GFrameCounter ? SpentTraces : 0; }
+
+private:
+	/** A trace reservation waiting for budget */
+	struct FTraceRequest
+	{
+		TWeakObjectPtr<const UObject> Requester;
+		FVector Location;
+		int32 NumTraces;
+		bool bUrgent;
+
+		/** World time of the first and of the latest attempt */
+		float FirstTime;
+		float LastTime;
+	};
+
+	/** Reset the spent budget and grant queued trace requests when a new frame has started */
+	void BeginFrameIfNeeded();
+
+	/** Hand this frame's trace budget to the queued requests with the highest priority */
+	void GrantTraceRequests();
+
+	/** Distance from a location to the nearest player viewpoint (MAX_flt without any) */
+	float GetDistanceToNearestViewer(const FVector& Location) const;
+
+	/** Frame the spent budget belongs to */
+	uint64 CurrentFrame;
+
+	/** Game thread time spent this frame */
+	double SpentSeconds;
+
+	/** Traces issued or reserved this frame */
+	int32 SpentTraces;
+
+	/** Monster updates deferred this frame */
+	int32 NumDeferredUpdates;
+
+	/** Player viewpoints of this frame */
+	TArray<FVector, TInlineAllocator<4>> ViewLocations;
+
+	/** Trace requests waiting for budget */
+	TArray<FTraceRequest> TraceRequests;
+
+	/** Requesters granted traces that haven't asked again yet, with the world time of the grant */
+	TMap<TWeakObjectPtr<const UObject>, float> GrantedTraces;
+};
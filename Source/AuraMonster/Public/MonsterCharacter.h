@@ -5,9 +5,12 @@
 #include "CoreMinimal.h"
 #include "GameFramework/Character.h"
 #include "MonsterBehaviorState.h"
+#include "MonsterLODTypes.h"
+#include "MonsterRandomSeedPolicy.h"
 #include "MonsterCharacter.generated.h"
 
 class USurfacePathfindingComponent;
+class UMonsterAnimInstance;
 
 UCLASS()
 class AURAMONSTER_API AMonsterCharacter : public ACharacter
@@ -16,11 +19,14 @@ class AURAMONSTER_API AMonsterCharacter : public ACharacter
 
 public:
 	// Sets default values for this character's properties
-	AMonsterCharacter();
+	AMonsterCharacter(const FObjectInitializer& ObjectInitializer);
+
+	virtual void PostInitializeComponents() override;
 
 protected:
 	// Called when the game starts or when spawned
 	virtual void BeginPlay() override;
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
 
 public:
 	// Called every frame
@@ -29,6 +35,8 @@ public:
 	// Called to bind functionality to input
 	virtual void SetupPlayerInputComponent(class UInputComponent* PlayerInputComponent) override;
 
+	virtual void PossessedBy(AController* NewController) override;
+
 	/** Get the current behavior state */
 	UFUNCTION(BlueprintCallable, Category = "Monster")
 	EMonsterBehaviorState GetBehaviorState() const { return CurrentBehaviorState; }
@@ -45,6 +53,53 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Monster")
 	USurfacePathfindingComponent* GetSurfacePathfinding() const { return SurfacePathfinding; }
 
+	/** Get the mesh's anim instance if it is a UMonsterAnimInstance */
+	UMonsterAnimInstance* GetMonsterAnimInstance() const;
+
+	/** Get the current AI LOD tier */
+	UFUNCTION(BlueprintCallable, Category = "Monster|LOD")
+	EMonsterLODTier GetLODTier() const { return CurrentLODTier; }
+
+	/**
+	 * Switch to an LOD tier and apply its settings to the controller, character and surface pathfinding component.
+	 * Called by UMonsterLODSubsystem; with bUseAILOD set, it overrides manual changes on its next update.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Monster|LOD")
+	void SetLODTier(EMonsterLODTier NewTier);
+
+	/**
+	 * Pick the LOD tier for a distance to the nearest viewer; monsters not rendered recently drop one tier
+	 * @param DistanceToViewer Distance to the nearest player viewpoint
+	 */
+	EMonsterLODTier SelectLODTier(float DistanceToViewer) const;
+
+	/** Get the settings of an LOD tier */
+	const FMonsterLODSettings& GetLODSettings(EMonsterLODTier Tier) const;
+
+	/** Random stream behind every random choice of this monster (behavior timers, patrol and crawl targets, surface transitions) */
+	FRandomStream& GetRandomStream() { return RandomStream; }
+
+	/** Continue from a stream captured elsewhere, e.g. by UMonsterHordeSubsystem while the monster had no actor */
+	void SetRandomStream(const FRandomStream& InRandomStream) { RandomStream = InRandomStream; }
+
+	/** Seed the random stream started from */
+	UFUNCTION(BlueprintCallable, Category = "Monster|Random")
+	int32 GetInitialRandomSeed() const { return RandomStream.GetInitialSeed(); }
+
+	/**
+	 * Seed for a new random stream of this monster, following RandomSeedPolicy
+	 * @param MonsterKey Identifies the monster the same way across runs, e.g. a hash of its name
+	 */
+	int32 MakeSpawnRandomSeed(uint32 MonsterKey) const { return MakeRandomSeed(RandomSeedPolicy, RandomSeed, MonsterKey); }
+
+	/**
+	 * Resolve a seeding policy to a seed
+	 * @param Policy How to seed
+	 * @param BaseSeed Seed for the Fixed policies
+	 * @param MonsterKey Identifies the monster the same way across runs, e.g. a hash of its name
+	 */
+	static int32 MakeRandomSeed(EMonsterRandomSeedPolicy Policy, int32 BaseSeed, uint32 MonsterKey);
+
 protected:
 	/** 
 	 * Internal method to set behavior state without triggering AI Controller synchronization.
@@ -84,6 +139,44 @@ protected:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster|Movement")
 	float PatrolCrawlingSpeed;
 
+	/** Let UMonsterLODSubsystem lower the update rate of this monster with distance from the players */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Monster|LOD")
+	bool bUseAILOD;
+
+	/** Settings for monsters near a viewer */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster|LOD", meta = (EditCondition = "bUseAILOD"))
+	FMonsterLODSettings FullRateLOD;
+
+	/** Settings for monsters at medium distance, or near but not rendered */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster|LOD", meta = (EditCondition = "bUseAILOD"))
+	FMonsterLODSettings ReducedRateLOD;
+
+	/** Settings for everything beyond ReducedRateLOD.MaxDistance, or at medium distance but not rendered */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster|LOD", meta = (EditCondition = "bUseAILOD"))
+	FMonsterLODSettings SimulationOnlyLOD;
+
+	/** Seconds without being rendered after which the monster drops one LOD tier */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster|LOD", meta = (ClampMin = "0.0", EditCondition = "bUseAILOD"))
+	float RecentlyRenderedTolerance;
+
+	/** Current AI LOD tier */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Monster|LOD")
+	EMonsterLODTier CurrentLODTier;
+
+	/** Push the settings of the current LOD tier to the controller, character and surface pathfinding component */
+	void ApplyLODSettings();
+
+	/** Set up movement for a behavior state: the walk speed, leaving the crawl mode and stopping surface tracking outside crawling patrols */
+	void ApplyMovementForState(EMonsterBehaviorState State);
+
+	/** How the random stream is seeded when the monster spawns */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Monster|Random")
+	EMonsterRandomSeedPolicy RandomSeedPolicy;
+
+	/** Seed for the Fixed and Fixed Per Monster policies */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Monster|Random")
+	int32 RandomSeed;
+
 	/** Surface pathfinding component for crawling on walls and ceilings */
 	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Monster|Components")
 	USurfacePathfindingComponent* SurfacePathfinding;
@@ -92,4 +185,11 @@ protected:
 	UFUNCTION(BlueprintNativeEvent, Category = "Monster")
 	void OnBehaviorStateChanged(EMonsterBehaviorState OldState, EMonsterBehaviorState NewState);
 	virtual void OnBehaviorStateChanged_Implementation(EMonsterBehaviorState OldState, EMonsterBehaviorState NewState);
+
+private:
+	/** Random stream of this monster, seeded on spawn */
+	FRandomStream RandomStream;
+
+	/** Whether the behavior state is counted in the monster state stats (from BeginPlay to EndPlay) */
+	bool bCountedInStateStats;
 };
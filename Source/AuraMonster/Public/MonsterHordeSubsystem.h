@@ -0,0 +1,197 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "Templates/SubclassOf.h"
+#include "MonsterBehaviorState.h"
+#include "MonsterAIRuntimeState.h"
+#include "MonsterHordeSubsystem.generated.h"
+
+class UMonsterHordeSubsystem;
+class AMonsterCharacter;
+class AMonsterAIController;
+
+/**
+ * Behavior settings shared by every horde monster of one character class,
+ * read from the class defaults of the character and its AI controller
+ */
+struct FMonsterHordeArchetype
+{
+	/** Character spawned when a monster of this archetype is hydrated */
+	TSubclassOf<AMonsterCharacter> CharacterClass;
+
+	/** Copies of the AMonsterAIController and AMonsterCharacter properties of the same name */
+	float MinIdleDuration;
+	float MaxIdleDuration;
+	float MinSubtleMovementInterval;
+	float MaxSubtleMovementInterval;
+	float PatrolTransitionChance;
+	float PatrolRange;
+	float MinStopDuration;
+	float MaxStopDuration;
+	float PatrolAcceptanceRadius;
+	float PatrolStandingSpeed;
+	float PatrolCrawlingSpeed;
+
+	FMonsterHordeArchetype()
+		: MinIdleDuration(5.0f)
+		, MaxIdleDuration(15.0f)
+		, MinSubtleMovementInterval(2.0f)
+		, MaxSubtleMovementInterval(6.0f)
+		, PatrolTransitionChance(0.3f)
+		, PatrolRange(1000.0f)
+		, MinStopDuration(2.0f)
+		, MaxStopDuration(5.0f)
+		, PatrolAcceptanceRadius(100.0f)
+		, PatrolStandingSpeed(300.0f)
+		, PatrolCrawlingSpeed(150.0f)
+	{
+	}
+};
+
+/**
+ * Tick function that runs the horde processors
+ */
+USTRUCT()
+struct FMonsterHordeTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Subsystem that owns the horde */
+	UMonsterHordeSubsystem* Target;
+
+	FMonsterHordeTickFunction()
+		: Target(nullptr)
+	{
+	}
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMonsterHordeTickFunction> : public TStructOpsTypeTraitsBase2<FMonsterHordeTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Horde representation for thousands of monsters. Each monster is a row in a set of parallel arrays
+ * (position, surface normal, behavior runtime state, move target) instead of a character and controller actor.
+ * Lightweight processors reproduce the idle, standing patrol and crawling patrol behaviors on those rows
+ * at a reduced tick rate. Monsters near a player are hydrated into full AMonsterCharacter actors,
+ * continuing from their row's state, and dehydrated back into rows once the player moves away.
+ */
+UCLASS()
+class AURAMONSTER_API UMonsterHordeSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UMonsterHordeSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Add a monster to the horde; it stays a lightweight row until a player comes close
+	 * @param CharacterClass Character to spawn when the monster is hydrated
+	 * @param Transform Where the monster starts
+	 * @param InitialState Behavior state the monster starts in
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Monster Horde")
+	void AddHordeMonster(TSubclassOf<AMonsterCharacter> CharacterClass, const FTransform& Transform, EMonsterBehaviorState InitialState);
+
+	/** Number of monsters in the horde, hydrated or not */
+	UFUNCTION(BlueprintCallable, Category = "Monster Horde")
+	int32 GetNumHordeMonsters() const { return Locations.Num(); }
+
+	/** Number of horde monsters currently represented by actors */
+	UFUNCTION(BlueprintCallable, Category = "Monster Horde")
+	int32 GetNumHydratedMonsters() const;
+
+	/** Run hydration and the behavior processors */
+	void TickHorde(float DeltaTime);
+
+private:
+	/** Register the tick function with the world, once */
+	void RegisterTickFunction();
+
+	/** Get or create the archetype of a character class */
+	int32 FindOrAddArchetype(TSubclassOf<AMonsterCharacter> CharacterClass);
+
+	/** Hydrate monsters near players and dehydrate hydrated ones that are far from every player */
+	void UpdateHydration();
+
+	/** Spawn the actors of a monster and hand them its state */
+	bool HydrateMonster(int32 Index);
+
+	/**
+	 * Move a row back onto ground its actor can stand on: rows walk straight lines without collision, which can cut
+	 * over gaps and ledges or, for crawlers, through the air between surfaces
+	 * @param Index Monster row
+	 * @return False if no ground was found near the row, so it shouldn't be spawned yet
+	 */
+	bool PlaceRowForSpawn(int32 Index);
+
+	/** Capture the state of a hydrated monster and destroy its actors */
+	void DehydrateMonster(int32 Index);
+
+	/** Remove a monster row */
+	void RemoveMonster(int32 Index);
+
+	/** Reset a monster's runtime state for a new behavior state, like AMonsterAIController::OnEnterState */
+	void EnterState(int32 Index, EMonsterBehaviorState NewState);
+
+	/** Idle processor: idle timers and the transition to patrol */
+	void ProcessIdle(float DeltaTime);
+
+	/** Standing patrol processor: walk between random navigable points with stops */
+	void ProcessPatrolStanding(float DeltaTime);
+
+	/** Crawling patrol processor: crawl between random surface points with stops */
+	void ProcessPatrolCrawling(float DeltaTime);
+
+	/**
+	 * Move a monster toward its target; on arrival it stops to listen/look around
+	 * @param Index Monster row
+	 * @param Speed Movement speed in units per second
+	 * @param DeltaTime Time step
+	 */
+	void MoveTowardsTarget(int32 Index, float Speed, float DeltaTime);
+
+	/** Archetypes referenced by ArchetypeIndices */
+	TArray<FMonsterHordeArchetype> Archetypes;
+
+	/** Per-monster rows */
+	TArray<int32> ArchetypeIndices;
+	TArray<FVector> Locations;
+	TArray<FQuat> Rotations;
+	TArray<FVector> SurfaceNormals;
+	TArray<FMonsterAIRuntimeState> RuntimeStates;
+	TArray<FVector> MoveTargets;
+	TArray<FVector> MoveTargetNormals;
+	TArray<bool> HasMoveTargets;
+
+	/** Random stream of each monster; handed to its character while hydrated */
+	TArray<FRandomStream> RandomStreams;
+
+	/** Number of monsters ever added, which seeds the random stream of the next one */
+	uint32 NumMonstersAdded;
+
+	/** Whether each monster is currently represented by actors */
+	TArray<bool> IsHydrated;
+
+	/** Character of each hydrated monster; null while dehydrated, or once a hydrated monster was destroyed */
+	UPROPERTY()
+	TArray<AMonsterCharacter*> HydratedCharacters;
+
+	/** Tick function that runs TickHorde */
+	FMonsterHordeTickFunction TickFunction;
+};
@@ -0,0 +1,81 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MonsterLODSubsystem.generated.h"
+
+class UMonsterLODSubsystem;
+class AMonsterCharacter;
+
+/**
+ * Tick function that re-evaluates the monsters' LOD tiers
+ */
+USTRUCT()
+struct FMonsterLODTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Subsystem that owns the monsters */
+	UMonsterLODSubsystem* Target;
+
+	FMonsterLODTickFunction()
+		: Target(nullptr)
+	{
+	}
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMonsterLODTickFunction> : public TStructOpsTypeTraitsBase2<FMonsterLODTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * AI LOD policy: every few frames picks an LOD tier for each registered monster from its distance
+ * to the nearest player viewpoint and whether it was rendered recently, and applies the tier's
+ * tick intervals, surface trace budget and surface alignment when it changes.
+ * Monsters register themselves when AMonsterCharacter::bUseAILOD is set.
+ */
+UCLASS()
+class AURAMONSTER_API UMonsterLODSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UMonsterLODSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/** Start choosing LOD tiers for a monster */
+	void RegisterMonster(AMonsterCharacter* Monster);
+
+	/** Stop choosing LOD tiers for a monster; it keeps its current tier */
+	void UnregisterMonster(AMonsterCharacter* Monster);
+
+	/** Number of monsters with LOD */
+	int32 GetNumMonsters() const { return Monsters.Num(); }
+
+	/** Re-evaluate every monster's tier */
+	void UpdateLOD();
+
+private:
+	/** Register the tick function with the world, once */
+	void RegisterTickFunction();
+
+	/** Monsters with LOD */
+	UPROPERTY()
+	TArray<AMonsterCharacter*> Monsters;
+
+	/** Tick function that runs UpdateLOD */
+	FMonsterLODTickFunction TickFunction;
+};
@@ -0,0 +1,64 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MonsterLODTypes.generated.h"
+
+/**
+ * How much update work a monster gets, picked by UMonsterLODSubsystem from its distance to the nearest viewer
+ * and whether it was rendered recently
+ */
+UENUM(BlueprintType)
+enum class EMonsterLODTier : uint8
+{
+	/** Every frame, full surface tracking */
+	FullRate UMETA(DisplayName = "Full Rate"),
+
+	/** Lower tick rate and fewer surface traces */
+	ReducedRate UMETA(DisplayName = "Reduced Rate"),
+
+	/** Behavior and movement keep running, but nobody sees the monster so it doesn't rotate to follow surfaces */
+	SimulationOnly UMETA(DisplayName = "Simulation Only")
+};
+
+/**
+ * Update settings of one LOD tier
+ */
+USTRUCT(BlueprintType)
+struct AURAMONSTER_API FMonsterLODSettings
+{
+	GENERATED_BODY()
+
+	/** Monsters closer than this to the nearest viewer may use this tier (ignored for the last tier) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster|LOD", meta = (ClampMin = "0.0"))
+	float MaxDistance;
+
+	/** Tick interval of the controller, character and surface pathfinding component (0 = every frame) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster|LOD", meta = (ClampMin = "0.0"))
+	float TickInterval;
+
+	/** Minimum seconds between surface detection traces; the last contact is followed in between (0 = every tick) */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster|LOD", meta = (ClampMin = "0.0"))
+	float SurfaceTraceInterval;
+
+	/** Whether the monster's rotation follows the surface it is on */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster|LOD")
+	bool bAlignToSurface;
+
+	FMonsterLODSettings()
+		: MaxDistance(0.0f)
+		, TickInterval(0.0f)
+		, SurfaceTraceInterval(0.0f)
+		, bAlignToSurface(true)
+	{
+	}
+
+	FMonsterLODSettings(float InMaxDistance, float InTickInterval, float InSurfaceTraceInterval, bool bInAlignToSurface)
+		: MaxDistance(InMaxDistance)
+		, TickInterval(InTickInterval)
+		, SurfaceTraceInterval(InSurfaceTraceInterval)
+		, bAlignToSurface(bInAlignToSurface)
+	{
+	}
+};
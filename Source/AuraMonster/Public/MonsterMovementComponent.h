@@ -0,0 +1,161 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "MonsterMovementComponent.generated.h"
+
+/**
+ * Custom movement modes of UMonsterMovementComponent (CustomMovementMode while in MOVE_Custom)
+ */
+UENUM(BlueprintType)
+enum class EMonsterMovementMode : uint8
+{
+	/** Surface-relative crawling on floors, walls and ceilings */
+	Crawl UMETA(DisplayName = "Crawl")
+};
+
+/**
+ * Character movement of monsters. Adds a crawl mode that moves the capsule along any surface with swept moves,
+ * pulled into the surface it is on instead of down, so crawling patrols are simulated by the movement component
+ * rather than by teleporting the actor while walking or falling physics runs on top.
+ */
+UCLASS()
+class AURAMONSTER_API UMonsterMovementComponent : public UCharacterMovementComponent
+{
+	GENERATED_BODY()
+
+public:
+	UMonsterMovementComponent();
+
+	virtual float GetMaxSpeed() const override;
+
+	/**
+	 * Distance below the capsule, along the crawl surface normal, within which the surface is still held on to
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster Movement|Crawl", meta = (ClampMin = "0.0"))
+	float CrawlSurfaceCheckDistance;
+
+	/**
+	 * Angle (degrees) between a surface run into and the current one from which the crawler climbs onto it
+	 * instead of sliding along it
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster Movement|Crawl", meta = (ClampMin = "0.0", ClampMax = "180.0"))
+	float CrawlTransitionAngle;
+
+	/**
+	 * Pull towards the last crawl surface while off it, as a multiple of the world's gravity
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster Movement|Crawl", meta = (ClampMin = "0.0"))
+	float CrawlGravityScale;
+
+	/**
+	 * Seconds the crawler may be off any surface before it drops into falling
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Monster Movement|Crawl", meta = (ClampMin = "0.0"))
+	float MaxCrawlDetachTime;
+
+	/**
+	 * Enter or leave the crawl mode. Leaving it drops the monster upright into falling, which lands it in walking.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Monster Movement")
+	void SetCrawling(bool bCrawl);
+
+	/** Whether the crawl mode is active */
+	UFUNCTION(BlueprintCallable, Category = "Monster Movement")
+	bool IsCrawling() const;
+
+	/**
+	 * Crawl towards a destination until it is within the acceptance radius or another request replaces this one
+	 * @param Destination Where to crawl to
+	 * @param Speed Crawl speed in units per second
+	 * @param AcceptanceRadius Distance at which the destination counts as reached
+	 * @param AlignmentSpeed How quickly the monster turns to follow the surface (0 = don't)
+	 */
+	void RequestCrawlMove(const FVector& Destination, float Speed, float AcceptanceRadius, float AlignmentSpeed);
+
+	/** Stop crawling at the current location; stopped crawlers do no collision queries */
+	void StopCrawlMove();
+
+	/**
+	 * Take over a surface from movement that placed the monster itself (e.g. along a baked surface route)
+	 * @param Location Point on the surface
+	 * @param Normal Surface normal there
+	 */
+	void SetCrawlSurface(const FVector& Location, const FVector& Normal);
+
+	/** Whether the crawler is on a surface */
+	bool HasCrawlSurface() const { return bHasCrawlSurface; }
+
+	/** Last point found on the crawl surface */
+	const FVector& GetCrawlSurfaceLocation() const { return CrawlSurfaceLocation; }
+
+	/** Normal of the crawl surface */
+	const FVector& GetCrawlSurfaceNormal() const { return CrawlSurfaceNormal; }
+
+	/** Direction crawl gravity pulls in: into the crawl surface */
+	FVector GetCrawlGravityDirection() const { return -CrawlSurfaceNormal; }
+
+protected:
+	virtual void PhysCustom(float deltaTime, int32 Iterations) override;
+	virtual void OnMovementModeChanged(EMovementMode PreviousMovementMode, uint8 PreviousCustomMode) override;
+
+	/**
+	 * Crawl physics: sub-stepped swept moves along the surface plane, climbing onto surfaces run into,
+	 * wrapping around convex edges, and sticking to the surface below
+	 */
+	void PhysCrawl(float deltaTime, int32 Iterations);
+
+	/**
+	 * Sweep the capsule into the crawl surface
+	 * @param Location Capsule location to sweep from
+	 * @param Normal Surface normal to sweep against
+	 * @param OutHit The surface hit
+	 * @return True if a surface is within CrawlSurfaceCheckDistance
+	 */
+	bool FindCrawlSurface(const FVector& Location, const FVector& Normal, FHitResult& OutHit) const;
+
+	/**
+	 * Find the face below a convex edge the crawler has just moved over, by sweeping back under the edge
+	 * @param MoveDirection Direction of the move that left the surface
+	 * @param OutHit The face hit
+	 * @param OutLocation Capsule location against that face
+	 * @return True if the face was found
+	 */
+	bool FindSurfaceAroundEdge(const FVector& MoveDirection, FHitResult& OutHit, FVector& OutLocation) const;
+
+	/** Make a hit the crawl surface and close the gap to it */
+	void ApplyCrawlSurface(const FHitResult& Hit);
+
+	/** Turn the capsule towards the crawl surface normal, keeping its heading */
+	void AlignToCrawlSurface(float DeltaTime);
+
+private:
+	/** Destination of the current crawl move */
+	FVector CrawlDestination;
+
+	/** Speed of the current crawl move */
+	float CrawlSpeed;
+
+	/** Acceptance radius of the current crawl move */
+	float CrawlAcceptanceRadius;
+
+	/** Surface alignment speed of the current crawl move */
+	float CrawlAlignmentSpeed;
+
+	/** Whether a crawl move is under way */
+	bool bHasCrawlMove;
+
+	/** Last point found on the crawl surface */
+	FVector CrawlSurfaceLocation;
+
+	/** Normal of the crawl surface; crawl gravity pulls against it */
+	FVector CrawlSurfaceNormal;
+
+	/** Whether the crawler is on a surface */
+	bool bHasCrawlSurface;
+
+	/** Seconds spent off any surface while crawling */
+	float CrawlDetachTime;
+};
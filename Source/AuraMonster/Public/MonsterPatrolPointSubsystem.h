@@ -0,0 +1,115 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Engine/World.h"
+#include "HAL/ThreadSafeBool.h"
+#include "AI/Navigation/NavigationTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MonsterPatrolPointSubsystem.generated.h"
+
+class ANavigationData;
+
+/**
+ * Reachable points sampled from a navmesh, grouped by navmesh tile and connected island
+ */
+struct FMonsterPatrolPointPool
+{
+	/** Sampled points on the navmesh */
+	TArray<FVector> Locations;
+
+	/** Points of each tile and island: (tile X, tile Y, island) -> point indices */
+	TMap<FIntVector, TArray<int32>> TileIslandPoints;
+
+	/** Island of each navmesh polygon; polygons of one island are connected to each other */
+	TMap<NavNodeRef, int32> PolyIslands;
+
+	/** Edge length of a navmesh tile */
+	float TileSize;
+
+	FMonsterPatrolPointPool()
+		: TileSize(1.0f)
+	{
+	}
+
+	/** Get the group key of a location on an island */
+	FIntVector GetKey(const FVector& Location, int32 Island) const
+	{
+		return FIntVector(FMath::FloorToInt(Location.X / TileSize), FMath::FloorToInt(Location.Y / TileSize), Island);
+	}
+};
+
+/**
+ * World-wide pool of reachable patrol points, sampled from the default navmesh on a worker thread the first time
+ * a monster asks it for a point, and sampled again whenever navigation data is rebuilt after that. Monsters draw standing patrol destinations from it
+ * in constant time instead of each walking the navmesh around them with a radius search.
+ */
+UCLASS()
+class AURAMONSTER_API UMonsterPatrolPointSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UMonsterPatrolPointSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Pick a random pooled point on the navmesh island of Origin, within Range of it
+	 * @param Origin Point to search around, near the navmesh
+	 * @param Range Points further away than this are ignored
+	 * @param RandomStream Stream the choice is drawn from
+	 * @param OutLocation The chosen point
+	 * @return False if the pool isn't built yet (the first call starts the build), Origin isn't on a pooled island, or no probe found a point in range
+	 */
+	bool FindRandomPatrolPoint(const FVector& Origin, float Range, FRandomStream& RandomStream, FVector& OutLocation);
+
+	/**
+	 * Sample the navmesh again in the background.
+	 * The current pool keeps answering queries until the new one is ready.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Monster Patrol Points")
+	void RebuildPatrolPoints();
+
+	/** Whether a built pool is available */
+	UFUNCTION(BlueprintCallable, Category = "Monster Patrol Points")
+	bool IsPoolReady();
+
+	/** Number of points in the built pool */
+	int32 GetNumPoints() const { return Pool.IsValid() ? Pool->Locations.Num() : 0; }
+
+private:
+	/** Start the first build, once the world's actors are initialized and its navigation data is loaded */
+	void EnsureBuildStarted();
+
+	/** Called whenever navigation data finishes building */
+	UFUNCTION()
+	void HandleNavigationGenerationFinished(ANavigationData* NavData);
+
+	/** Pick up the background build result once it is finished */
+	void ConsumeFinishedBuild();
+
+	/** Stop a running background build and wait for it to return */
+	void CancelBuild();
+
+	/** Navmesh the pool was sampled from */
+	TWeakObjectPtr<ANavigationData> PoolNavData;
+
+	/** Navmesh the background build samples */
+	TWeakObjectPtr<ANavigationData> BuildNavData;
+
+	/** Built pool; replaced as a whole when a rebuild finishes */
+	TSharedPtr<FMonsterPatrolPointPool, ESPMode::ThreadSafe> Pool;
+
+	/** Background build in flight */
+	TFuture<TSharedPtr<FMonsterPatrolPointPool, ESPMode::ThreadSafe>> BuildTask;
+
+	/** Set to abandon the background build */
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> BuildCancelFlag;
+
+	/** Whether a build was ever started; worlds nobody asks for points never sample their navmesh */
+	bool bBuildRequested;
+};
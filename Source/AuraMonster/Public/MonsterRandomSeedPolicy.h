@@ -0,0 +1,22 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "MonsterRandomSeedPolicy.generated.h"
+
+/**
+ * How a monster's random stream is seeded when it spawns
+ */
+UENUM(BlueprintType)
+enum class EMonsterRandomSeedPolicy : uint8
+{
+	/** A different seed every spawn, unless AuraMonster.RandomSeed is set */
+	Random UMETA(DisplayName = "Random"),
+
+	/** RandomSeed as is; monsters sharing a seed make the same choices */
+	Fixed UMETA(DisplayName = "Fixed"),
+
+	/** RandomSeed combined with the monster's name, so monsters differ from each other but replay identically */
+	FixedPerMonster UMETA(DisplayName = "Fixed Per Monster")
+};
@@ -0,0 +1,170 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MonsterAIRuntimeState.h"
+#include "MonsterAIIntent.h"
+#include "MonsterTickManager.generated.h"
+
+class UMonsterTickManager;
+class AMonsterAIController;
+class USurfacePathfindingComponent;
+class UMonsterBudgetSubsystem;
+
+/**
+ * Tick function that updates every managed monster
+ */
+USTRUCT()
+struct FMonsterTickManagerTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Manager that owns the monsters */
+	UMonsterTickManager* Target;
+
+	FMonsterTickManagerTickFunction()
+		: Target(nullptr)
+	{
+	}
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMonsterTickManagerTickFunction> : public TStructOpsTypeTraitsBase2<FMonsterTickManagerTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Opt-in tick manager: updates every registered monster from a single tick function instead of
+ * separate controller, character and surface component ticks. The monsters' behavior timers are kept
+ * in contiguous arrays and advanced in one tight loop; only monsters with something to do this frame
+ * (e.g. not waiting out a patrol stop) get a behavior update afterwards. The behavior decisions of monsters
+ * with native behaviors run on worker threads, and their side effects are applied on the game thread in one pass.
+ * When UMonsterBudgetSubsystem has a time budget, the updates that don't fit in it wait for a later frame,
+ * the most important ones going first.
+ * Monsters opt in with AMonsterAIController::bUseMonsterTickManager.
+ */
+UCLASS()
+class AURAMONSTER_API UMonsterTickManager : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UMonsterTickManager();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Take over ticking of a monster: its runtime state moves into the manager's arrays
+	 * and the per-actor ticks of the controller, its pawn and surface component are turned off
+	 * @param Controller Controller of the monster
+	 * @return False if the monster can't be managed (e.g. a Blueprint implements Event Tick) and keeps ticking itself
+	 */
+	bool RegisterMonster(AMonsterAIController* Controller);
+
+	/**
+	 * Hand a monster back: its runtime state is copied back into the controller
+	 * @param Controller Controller of the monster
+	 */
+	void UnregisterMonster(AMonsterAIController* Controller);
+
+	/**
+	 * Update a managed monster less often than every frame; its behavior timers still advance every frame
+	 * @param Controller Controller of the monster
+	 * @param TickInterval Seconds between behavior and surface updates (0 = every frame)
+	 */
+	void SetMonsterTickInterval(AMonsterAIController* Controller, float TickInterval);
+
+	/** Runtime state of a managed monster */
+	FMonsterAIRuntimeState& GetRuntimeState(int32 Slot) { return RuntimeStates[Slot]; }
+
+	/** Number of managed monsters */
+	int32 GetNumMonsters() const { return Controllers.Num(); }
+
+	/** Update every managed monster */
+	void TickMonsters(float DeltaTime);
+
+private:
+	/** Register the tick function with the world, once */
+	void RegisterTickFunction();
+
+	/**
+	 * Keep the updates picked this frame within the time budget: if their estimated cost is over it,
+	 * only the ones with the highest priority run and the others wait, accumulating their time
+	 */
+	void ApplyUpdateBudget();
+
+	/** Run the behavior decisions of this frame's updates that can be decided off the game thread, in parallel batches */
+	void DecideInParallel();
+
+	/** Decisions per parallel batch */
+	static int32 GetDecisionBatchSize();
+
+	/** Behavior timers and patrol state, one per managed monster */
+	TArray<FMonsterAIRuntimeState> RuntimeStates;
+
+	/** Controllers of the managed monsters, parallel to RuntimeStates */
+	UPROPERTY()
+	TArray<AMonsterAIController*> Controllers;
+
+	/** Surface components of the managed monsters, parallel to RuntimeStates (may be null) */
+	UPROPERTY()
+	TArray<USurfacePathfindingComponent*> SurfaceComponents;
+
+	/** Seconds between updates of each managed monster, parallel to RuntimeStates */
+	TArray<float> TickIntervals;
+
+	/** Time accumulated since each managed monster's last update, parallel to RuntimeStates */
+	TArray<float> TimeSinceLastUpdate;
+
+	/** Smoothed game thread milliseconds of each managed monster's update (0 = not measured yet), parallel to RuntimeStates */
+	TArray<float> UpdateCostsMs;
+
+	/** Smoothed cost of an update across all monsters, assumed for the ones not measured yet */
+	float AverageUpdateCostMs;
+
+	/** Per-frame AI budget the updates are kept within */
+	UPROPERTY()
+	UMonsterBudgetSubsystem* BudgetSubsystem;
+
+	/** Slots of the monsters updated this frame, and the time since their last update (reused every frame) */
+	TArray<int32> UpdateSlots;
+	TArray<float> UpdateDeltaTimes;
+
+	/** Priorities of this frame's updates when they don't all fit in the budget (reused every frame) */
+	TArray<TPair<float, int32>> UpdatePriorities;
+
+	/** Which of this frame's updates (indices into UpdateSlots) decide on worker threads, and what they read */
+	TArray<int32> DecisionUpdateIndices;
+	TArray<FMonsterAIDecisionInput> DecisionInputs;
+
+	/** Where each decision's intents start in its batch queue, and how many it made, parallel to DecisionUpdateIndices */
+	TArray<int32> DecisionIntentStarts;
+	TArray<int32> DecisionIntentCounts;
+
+	/** Behavior state each decision ran in, parallel to DecisionUpdateIndices */
+	TArray<EMonsterBehaviorState> DecisionStates;
+
+	/** Intents of each batch of decisions; every worker task writes only its own queue */
+	TArray<FMonsterAIIntentQueue> BatchIntents;
+
+	/** Monsters registered while TickMonsters was updating, added once it is done */
+	UPROPERTY()
+	TArray<AMonsterAIController*> PendingRegistrations;
+
+	/** Tick function that runs TickMonsters */
+	FMonsterTickManagerTickFunction TickFunction;
+
+	/** Whether TickMonsters is running its update loop, during which the arrays must not move */
+	bool bIsTickingMonsters;
+};
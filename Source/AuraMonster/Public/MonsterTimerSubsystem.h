@@ -0,0 +1,95 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "MonsterTimingWheel.h"
+#include "MonsterTimerSubsystem.generated.h"
+
+class UMonsterTimerSubsystem;
+class AMonsterAIController;
+
+/**
+ * Tick function that advances the timing wheel
+ */
+USTRUCT()
+struct FMonsterTimerTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Subsystem that owns the timing wheel */
+	UMonsterTimerSubsystem* Target;
+
+	FMonsterTimerTickFunction()
+		: Target(nullptr)
+	{
+	}
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FMonsterTimerTickFunction> : public TStructOpsTypeTraitsBase2<FMonsterTimerTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Shared timing wheel that wakes monsters whose behavior is only waiting for a timer
+ * (idle period end, next subtle movement, patrol stop end), so they don't tick in between.
+ * Monsters opt in with AMonsterAIController::bUseScheduledTimers.
+ */
+UCLASS()
+class AURAMONSTER_API UMonsterTimerSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	UMonsterTimerSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Initialize(FSubsystemCollectionBase& Collection) override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Wake a monster after a delay
+	 * @param Controller Controller to wake
+	 * @param Delay Seconds from now; rounded up to the wheel's resolution
+	 * @return Handle to cancel the wake with
+	 */
+	FMonsterTimerHandle ScheduleWake(AMonsterAIController* Controller, float Delay);
+
+	/** Cancel a pending wake and invalidate the handle */
+	void CancelWake(FMonsterTimerHandle& Handle);
+
+	/** Number of pending wakes */
+	int32 GetNumScheduled() const { return TimingWheel.Num(); }
+
+	/** Fire every wake that is due */
+	void TickTimers();
+
+private:
+	/** Register the tick function with the world, once */
+	void RegisterTickFunction();
+
+	/** Wheel tick for a world time */
+	uint64 GetTickForTime(double TimeSeconds) const;
+
+	/** Controllers waiting for a wake */
+	TMonsterTimingWheel<TWeakObjectPtr<AMonsterAIController>> TimingWheel;
+
+	/** Wakes that fired this tick, kept to avoid reallocating */
+	TArray<TMonsterTimingWheel<TWeakObjectPtr<AMonsterAIController>>::FExpiredTimer> ExpiredTimers;
+
+	/** Seconds per wheel tick, fixed when the subsystem is created */
+	float Resolution;
+
+	/** Tick function that runs TickTimers */
+	FMonsterTimerTickFunction TickFunction;
+};
@@ -0,0 +1,311 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Handle to a timer scheduled in a TMonsterTimingWheel
+ */
+struct FMonsterTimerHandle
+{
+	/** Entry of the timer in the wheel */
+	int32 Index;
+
+	/** Generation of the entry when the timer was scheduled; entries are reused once a timer fires or is cancelled */
+	uint32 Generation;
+
+	FMonsterTimerHandle()
+		: Index(INDEX_NONE)
+		, Generation(0)
+	{
+	}
+
+	FMonsterTimerHandle(int32 InIndex, uint32 InGeneration)
+		: Index(InIndex)
+		, Generation(InGeneration)
+	{
+	}
+
+	/** Whether this handle was ever set; the timer may have fired since */
+	bool IsValid() const { return Index != INDEX_NONE; }
+
+	/** Forget the timer */
+	void Invalidate() { Index = INDEX_NONE; }
+
+	bool operator==(const FMonsterTimerHandle& Other) const { return Index == Other.Index && Generation == Other.Generation; }
+	bool operator!=(const FMonsterTimerHandle& Other) const { return !(*this == Other); }
+};
+
+/**
+ * Hierarchical timing wheel: schedules payloads to fire on a future tick with O(1) scheduling and cancelling,
+ * and advancing costs only the timers that fire (plus an occasional cascade), however many are pending.
+ *
+ * Level 0 has one slot per tick; each higher level has slots NumSlots times as wide. Timers due far away sit in
+ * a coarse slot and are moved down a level when the level below wraps around to their slot.
+ * Timers further away than the top level covers wait in its last slot and are re-filed on every cascade.
+ */
+template<typename PayloadType>
+class TMonsterTimingWheel
+{
+public:
+	static const int32 SlotBits = 6;
+	static const int32 NumSlots = 1 << SlotBits;
+	static const uint64 SlotMask = NumSlots - 1;
+	static const int32 NumLevels = 4;
+
+	/** A timer that fired */
+	struct FExpiredTimer
+	{
+		FMonsterTimerHandle Handle;
+		PayloadType Payload;
+	};
+
+	explicit TMonsterTimingWheel(uint64 StartTick = 0)
+	{
+		Reset(StartTick);
+	}
+
+	/** Drop every timer and restart at a tick */
+	void Reset(uint64 StartTick)
+	{
+		for (int32 SlotId = 0; SlotId < NumLevels * NumSlots; ++SlotId)
+		{
+			SlotHeads[SlotId] = INDEX_NONE;
+		}
+
+		// Keep the generations, so handles to dropped timers stay stale
+		FreeHead = INDEX_NONE;
+		for (int32 Index = Entries.Num() - 1; Index >= 0; --Index)
+		{
+			FreeEntry(Index);
+		}
+
+		CurrentTick = StartTick;
+		NumScheduled = 0;
+	}
+
+	/** Last tick processed by Advance */
+	uint64 GetCurrentTick() const { return CurrentTick; }
+
+	/** Number of pending timers */
+	int32 Num() const { return NumScheduled; }
+
+	/**
+	 * Schedule a payload
+	 * @param DueTick Tick to fire on; ticks already processed fire on the next one
+	 * @param Payload Data handed back when the timer fires
+	 * @return Handle to cancel the timer with
+	 */
+	FMonsterTimerHandle Schedule(uint64 DueTick, const PayloadType& Payload)
+	{
+		int32 Index = FreeHead;
+		if (Index != INDEX_NONE)
+		{
+			FreeHead = Entries[Index].Next;
+		}
+		else
+		{
+			Index = Entries.AddDefaulted();
+		}
+
+		FEntry& Entry = Entries[Index];
+		Entry.Payload = Payload;
+		Entry.DueTick = FMath::Max(DueTick, CurrentTick + 1);
+		Link(Index);
+
+		++NumScheduled;
+		return FMonsterTimerHandle(Index, Entry.Generation);
+	}
+
+	/**
+	 * Cancel a pending timer
+	 * @return False if the timer already fired or was cancelled
+	 */
+	bool Cancel(const FMonsterTimerHandle& Handle)
+	{
+		if (!IsScheduled(Handle))
+		{
+			return false;
+		}
+
+		Unlink(Handle.Index);
+		FreeEntry(Handle.Index);
+		--NumScheduled;
+		return true;
+	}
+
+	/** Whether a timer is still pending */
+	bool IsScheduled(const FMonsterTimerHandle& Handle) const
+	{
+		return Entries.IsValidIndex(Handle.Index)
+			&& Entries[Handle.Index].Generation == Handle.Generation
+			&& Entries[Handle.Index].SlotId != INDEX_NONE;
+	}
+
+	/** Tick a pending timer fires on, or 0 if it isn't pending */
+	uint64 GetDueTick(const FMonsterTimerHandle& Handle) const
+	{
+		return IsScheduled(Handle) ? Entries[Handle.Index].DueTick : 0;
+	}
+
+	/**
+	 * Process every tick up to and including TargetTick
+	 * @param TargetTick Tick to advance to
+	 * @param OutExpired Receives the timers that fired, in firing order; their handles are no longer scheduled
+	 */
+	void Advance(uint64 TargetTick, TArray<FExpiredTimer>& OutExpired)
+	{
+		while (CurrentTick < TargetTick)
+		{
+			++CurrentTick;
+
+			// Every level whose lower level just wrapped hands its current slot down, coarsest first
+			int32 TopLevel = 0;
+			while (TopLevel + 1 < NumLevels && (CurrentTick & ((uint64(1) << (SlotBits * (TopLevel + 1))) - 1)) == 0)
+			{
+				++TopLevel;
+			}
+			for (int32 Level = TopLevel; Level >= 1; --Level)
+			{
+				Cascade(GetSlotId(Level, (CurrentTick >> (SlotBits * Level)) & SlotMask));
+			}
+
+			// Everything left in this tick's slot is due
+			const int32 SlotId = GetSlotId(0, CurrentTick & SlotMask);
+			int32 Index = SlotHeads[SlotId];
+			SlotHeads[SlotId] = INDEX_NONE;
+
+			while (Index != INDEX_NONE)
+			{
+				FEntry& Entry = Entries[Index];
+				const int32 NextIndex = Entry.Next;
+
+				FExpiredTimer& Expired = OutExpired.AddDefaulted_GetRef();
+				Expired.Handle = FMonsterTimerHandle(Index, Entry.Generation);
+				Expired.Payload = MoveTemp(Entry.Payload);
+
+				FreeEntry(Index);
+				--NumScheduled;
+				Index = NextIndex;
+			}
+		}
+	}
+
+private:
+	struct FEntry
+	{
+		PayloadType Payload;
+		uint64 DueTick;
+		int32 Prev;
+		int32 Next;
+		int32 SlotId;
+		uint32 Generation;
+
+		FEntry()
+			: Payload()
+			, DueTick(0)
+			, Prev(INDEX_NONE)
+			, Next(INDEX_NONE)
+			, SlotId(INDEX_NONE)
+			, Generation(0)
+		{
+		}
+	};
+
+	static int32 GetSlotId(int32 Level, uint64 Slot)
+	{
+		return Level * NumSlots + static_cast<int32>(Slot);
+	}
+
+	/** File an entry into the slot of the finest level that reaches its due tick */
+	void Link(int32 Index)
+	{
+		FEntry& Entry = Entries[Index];
+
+		int32 SlotId = INDEX_NONE;
+		for (int32 Level = 0; Level < NumLevels; ++Level)
+		{
+			const int32 Shift = SlotBits * Level;
+			if ((Entry.DueTick >> Shift) - (CurrentTick >> Shift) < NumSlots)
+			{
+				SlotId = GetSlotId(Level, (Entry.DueTick >> Shift) & SlotMask);
+				break;
+			}
+		}
+
+		if (SlotId == INDEX_NONE)
+		{
+			// Beyond the top level: park in its furthest slot and re-file when that slot cascades
+			const int32 Shift = SlotBits * (NumLevels - 1);
+			SlotId = GetSlotId(NumLevels - 1, ((CurrentTick >> Shift) + SlotMask) & SlotMask);
+		}
+
+		Entry.SlotId = SlotId;
+		Entry.Prev = INDEX_NONE;
+		Entry.Next = SlotHeads[SlotId];
+		if (Entry.Next != INDEX_NONE)
+		{
+			Entries[Entry.Next].Prev = Index;
+		}
+		SlotHeads[SlotId] = Index;
+	}
+
+	void Unlink(int32 Index)
+	{
+		FEntry& Entry = Entries[Index];
+		if (Entry.Prev != INDEX_NONE)
+		{
+			Entries[Entry.Prev].Next = Entry.Next;
+		}
+		else
+		{
+			SlotHeads[Entry.SlotId] = Entry.Next;
+		}
+		if (Entry.Next != INDEX_NONE)
+		{
+			Entries[Entry.Next].Prev = Entry.Prev;
+		}
+		Entry.SlotId = INDEX_NONE;
+	}
+
+	/** Re-file every entry of a slot relative to the current tick */
+	void Cascade(int32 SlotId)
+	{
+		int32 Index = SlotHeads[SlotId];
+		SlotHeads[SlotId] = INDEX_NONE;
+
+		while (Index != INDEX_NONE)
+		{
+			const int32 NextIndex = Entries[Index].Next;
+			Link(Index);
+			Index = NextIndex;
+		}
+	}
+
+	void FreeEntry(int32 Index)
+	{
+		FEntry& Entry = Entries[Index];
+		Entry.Payload = PayloadType();
+		Entry.SlotId = INDEX_NONE;
+		Entry.Prev = INDEX_NONE;
+		Entry.Next = FreeHead;
+		++Entry.Generation;
+		FreeHead = Index;
+	}
+
+	/** Timer storage; free entries are chained through Next */
+	TArray<FEntry> Entries;
+
+	/** First entry of each slot, level by level */
+	int32 SlotHeads[NumLevels * NumSlots];
+
+	/** First free entry */
+	int32 FreeHead;
+
+	/** Last processed tick */
+	uint64 CurrentTick;
+
+	/** Number of pending timers */
+	int32 NumScheduled;
+};
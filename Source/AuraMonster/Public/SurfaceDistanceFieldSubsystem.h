@@ -0,0 +1,108 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SurfaceDistanceFieldSubsystem.generated.h"
+
+/**
+ * One brick of the sparse distance field: a small cube of distance samples around static geometry
+ */
+struct FSurfaceDistanceBrick
+{
+	/** Distances at the brick's corner samples (BrickResolution + 1 per axis); empty if no geometry is near the brick */
+	TArray<float> Distances;
+
+	/** False if geometry near the brick cannot answer distance queries (e.g. complex-only collision); callers must trace */
+	bool bIsQueryable;
+
+	/** Frame the brick was last looked up, for evicting the least recently used bricks */
+	uint64 LastUsedFrame;
+
+	FSurfaceDistanceBrick()
+		: bIsQueryable(true)
+		, LastUsedFrame(0)
+	{
+	}
+};
+
+/**
+ * Sparse distance field (brick map) of static level geometry.
+ * Bricks are built lazily around the points monsters query, or up front with PrewarmRegion,
+ * and answer nearest-surface distance and normal with a trilinear lookup instead of physics traces.
+ * The field is unsigned: points inside geometry read as 0, so lookups touching or inside geometry are refused.
+ * Only static geometry is captured; movable objects are ignored.
+ */
+UCLASS()
+class AURAMONSTER_API USurfaceDistanceFieldSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	USurfaceDistanceFieldSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Sample the distance field, building the containing brick if needed and the per-frame build budget allows
+	 * @param Location Point to sample
+	 * @param OutDistance Distance to the nearest static surface, clamped to GetMaxDistance()
+	 * @param OutGradient Distance gradient; points away from the nearest surface (its normal) near geometry
+	 * @return False if the field cannot answer for this point (not built yet, or touching or inside geometry) and the caller should trace instead
+	 */
+	bool SampleDistance(const FVector& Location, float& OutDistance, FVector& OutGradient);
+
+	/**
+	 * Build every brick overlapping a region now, e.g. at level start, so later lookups never wait for a build.
+	 * Prewarmed bricks count towards AuraMonster.DistanceField.MaxBricks like any other.
+	 * @param Region World-space box to cover
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Surface Distance Field")
+	void PrewarmRegion(const FBox& Region);
+
+	/**
+	 * Drop bricks overlapping a region, e.g. after static geometry was changed
+	 * @param Region World-space box to invalidate
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Surface Distance Field")
+	void InvalidateRegion(const FBox& Region);
+
+	/** Largest distance stored in the field; samples further from geometry read as this value */
+	float GetMaxDistance() const;
+
+	/** Number of bricks currently built */
+	int32 GetNumBricks() const { return Bricks.Num(); }
+
+private:
+	/** Pick up the voxel size console variable, dropping every brick if it changed */
+	void SyncVoxelSize();
+
+	/** Get the brick containing a location, building it if allowed */
+	const FSurfaceDistanceBrick* FindOrBuildBrick(const FIntVector& BrickCoord, bool bIgnoreBudget);
+
+	/** Drop the least recently used bricks until at most MaxBricks remain, keeping KeepCoord */
+	void EvictBricks(int32 MaxBricks, const FIntVector& KeepCoord);
+
+	/** Compute the samples of a brick from the static geometry around it */
+	void BuildBrick(const FIntVector& BrickCoord, FSurfaceDistanceBrick& OutBrick) const;
+
+	/** Brick coordinate containing a location */
+	FIntVector GetBrickCoord(const FVector& Location) const;
+
+	/** World size of one brick edge */
+	float GetBrickSize() const;
+
+	/** Built bricks by coordinate */
+	TMap<FIntVector, FSurfaceDistanceBrick> Bricks;
+
+	/** Frame the build budget was last reset */
+	uint64 BuildBudgetFrame;
+
+	/** Seconds spent building bricks during BuildBudgetFrame */
+	double BuildSecondsThisFrame;
+
+	/** Voxel size the current bricks were built with; bricks are dropped if the console variable changes */
+	float BuiltVoxelSize;
+};
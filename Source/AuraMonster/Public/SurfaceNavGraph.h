@@ -0,0 +1,177 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SurfaceNavGraph.generated.h"
+
+class UBoxComponent;
+
+/**
+ * A baked node of the surface navigation graph (a point on a floor, wall or ceiling)
+ */
+USTRUCT(BlueprintType)
+struct AURAMONSTER_API FSurfaceNavNode
+{
+	GENERATED_BODY()
+
+	/** Node location, offset slightly away from the surface */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Surface Navigation")
+	FVector Location;
+
+	/** Surface normal at the node */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Surface Navigation")
+	FVector Normal;
+
+	/** Index of this node's first edge in the graph edge array */
+	UPROPERTY()
+	int32 FirstEdge;
+
+	/** Number of edges leaving this node */
+	UPROPERTY()
+	int32 NumEdges;
+
+	/** Connected part of the graph the node belongs to; there is no route between nodes of different islands */
+	UPROPERTY()
+	int32 Island;
+
+	FSurfaceNavNode()
+		: Location(FVector::ZeroVector)
+		, Normal(FVector::UpVector)
+		, FirstEdge(0)
+		, NumEdges(0)
+		, Island(INDEX_NONE)
+	{
+	}
+};
+
+/**
+ * A baked edge of the surface navigation graph
+ */
+USTRUCT(BlueprintType)
+struct AURAMONSTER_API FSurfaceNavEdge
+{
+	GENERATED_BODY()
+
+	/** Node this edge leads to */
+	UPROPERTY()
+	int32 TargetNode;
+
+	/** Traversal cost (path length) */
+	UPROPERTY()
+	float Cost;
+
+	/** Whether this edge crosses between differently oriented surfaces (floor to wall, wall to ceiling...) */
+	UPROPERTY()
+	bool bIsTransition;
+
+	FSurfaceNavEdge()
+		: TargetNode(INDEX_NONE)
+		, Cost(0.0f)
+		, bIsTransition(false)
+	{
+	}
+};
+
+/**
+ * Offline-baked graph of crawlable surfaces (floors, walls and ceilings) with transition edges between them.
+ * Place one in the level, size its bounds around the crawlable area and press Build Graph.
+ * Crawling monsters inside the bounds follow A* routes over the graph instead of tracing every frame.
+ */
+UCLASS()
+class AURAMONSTER_API ASurfaceNavGraph : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASurfaceNavGraph();
+
+	virtual void PostLoad() override;
+
+	/** Sample the level geometry inside the bounds and rebuild nodes and edges */
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Surface Navigation")
+	void BuildGraph();
+
+	/** Remove all baked data */
+	UFUNCTION(CallInEditor, BlueprintCallable, Category = "Surface Navigation")
+	void ClearGraph();
+
+	/**
+	 * Find the node closest to a location
+	 * @param Location Point to search from
+	 * @param MaxDistance Nodes further away than this are ignored
+	 * @return Node index, or INDEX_NONE if there is no node in range
+	 */
+	int32 FindNearestNode(const FVector& Location, float MaxDistance) const;
+
+	/**
+	 * Pick a random node whose distance from Origin lies in [MinDistance, MaxDistance]
+	 * @param RandomStream Stream the choice is drawn from
+	 * @param Island Only pick nodes of this island, i.e. nodes reachable from a node of it (INDEX_NONE = any node)
+	 * @return Node index, or INDEX_NONE if there is no node in range
+	 */
+	int32 FindRandomNodeInRange(const FVector& Origin, float MinDistance, float MaxDistance, FRandomStream& RandomStream, int32 Island = INDEX_NONE) const;
+
+	/**
+	 * Run an A* search between two nodes
+	 * @param StartNode Node to start from
+	 * @param GoalNode Node to reach
+	 * @param OutNodePath Receives the node indices from start to goal (inclusive)
+	 * @return True if a route exists
+	 */
+	bool FindPath(int32 StartNode, int32 GoalNode, TArray<int32>& OutNodePath) const;
+
+	/** Whether a location lies inside the baked region */
+	bool ContainsLocation(const FVector& Location) const;
+
+	/** Whether the graph has any baked nodes */
+	bool HasGraphData() const { return Nodes.Num() > 0; }
+
+	/** Access a baked node */
+	const FSurfaceNavNode& GetNode(int32 NodeIndex) const { return Nodes[NodeIndex]; }
+
+	/** Find the graph whose bounds contain a location, if any */
+	static ASurfaceNavGraph* FindGraphForLocation(UWorld* World, const FVector& Location);
+
+protected:
+	/** Region of the level to bake */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Surface Navigation")
+	UBoxComponent* Bounds;
+
+	/** Distance between sampled nodes; smaller values give smoother routes at the cost of memory and bake time */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Navigation", meta = (ClampMin = "10.0"))
+	float NodeSpacing;
+
+	/** Minimum angle difference (degrees) between two node normals for an edge to be flagged as a surface transition */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Navigation")
+	float TransitionAngle;
+
+	/** Additional cost multiplier applied to transition edges, so routes prefer staying on one surface */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Navigation", meta = (ClampMin = "1.0"))
+	float TransitionCostMultiplier;
+
+	/** Baked nodes */
+	UPROPERTY(VisibleAnywhere, Category = "Surface Navigation")
+	TArray<FSurfaceNavNode> Nodes;
+
+	/** Baked edges, grouped per node (see FSurfaceNavNode::FirstEdge) */
+	UPROPERTY()
+	TArray<FSurfaceNavEdge> Edges;
+
+private:
+	/** Rebuild the transient spatial hash used for node lookups */
+	void RebuildSpatialHash();
+
+	/** Number the connected parts of the graph, see FSurfaceNavNode::Island */
+	void RebuildIslands();
+
+	/** Get the spatial hash cell for a location */
+	FIntVector GetCell(const FVector& Location) const;
+
+	/** Check whether two nodes can be connected without crossing geometry */
+	bool CanConnectNodes(const FSurfaceNavNode& From, const FSurfaceNavNode& To) const;
+
+	/** Transient spatial hash: cell -> node indices */
+	TMap<FIntVector, TArray<int32>> NodeHash;
+};
@@ -4,8 +4,51 @@
 
 #include "CoreMinimal.h"
 #include "Components/ActorComponent.h"
+#include "WorldCollision.h"
+#include "SurfaceQueryTypes.h"
+#include "SurfaceQuerySubsystem.h"
 #include "SurfacePathfindingComponent.generated.h"
 
+class ASurfaceNavGraph;
+class USurfaceDistanceFieldSubsystem;
+class USurfacePointCloudSubsystem;
+class AMonsterCharacter;
+class UMonsterMovementComponent;
+class UMonsterBudgetSubsystem;
+
+/**
+ * Surface contact kept across frames together with the pose it was found from,
+ * so a monster that hasn't moved reuses it instead of tracing again
+ */
+struct FSurfaceContactCache
+{
+	/** Cached contact, including the hit component */
+	FSurfaceContact Contact;
+
+	/** Location the contact was queried from */
+	FVector QueryLocation;
+
+	/** Owner rotation when the contact was queried */
+	FQuat QueryRotation;
+
+	/** Surface normal the hits were scored against */
+	FVector QueryNormal;
+
+	/** Transform of the hit component when the contact was queried */
+	FTransform HitComponentTransform;
+
+	/** World time the contact was queried at */
+	float Time;
+
+	FSurfaceContactCache()
+		: QueryLocation(FVector::ZeroVector)
+		, QueryRotation(FQuat::Identity)
+		, QueryNormal(FVector::UpVector)
+		, Time(0.0f)
+	{
+	}
+};
+
 /**
  * Component that enables monsters to crawl across any surface (floors, walls, ceilings)
  * with smooth transitions between surfaces.
@@ -24,6 +67,32 @@ protected:
 public:
 	virtual void TickComponent(float DeltaTime, ELevelTick TickType, FActorComponentTickFunction* ThisTickFunction) override;
 
+	/**
+	 * Keep the owner attached and aligned to its surface. Runs from TickComponent,
+	 * or from UMonsterTickManager when the monster is managed and the component tick is off.
+	 * @param DeltaTime Time step
+	 */
+	void UpdateSurfaceTracking(float DeltaTime);
+
+	/**
+	 * Start or stop surface tracking. Monsters only track their surface while crawling: AMonsterCharacter turns it on
+	 * when entering PatrolCrawling and off in every other state, which stops the component tick and its traces.
+	 * Starting again warm-starts from the cached contact or the character's floor instead of tracing where it can.
+	 * Components on actors other than monsters stay active.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Surface Pathfinding")
+	void SetSurfaceTrackingActive(bool bActive);
+
+	/** Whether surface tracking is running */
+	UFUNCTION(BlueprintCallable, Category = "Surface Pathfinding")
+	bool IsSurfaceTrackingActive() const { return bSurfaceTrackingActive; }
+
+	/**
+	 * Called by UMonsterTickManager when it takes over calling UpdateSurfaceTracking, or hands it back
+	 * @param bManaged Whether the manager updates the component instead of its tick
+	 */
+	void SetTickManaged(bool bManaged);
+
 	/**
 	 * Find a random valid surface location within the specified range
 	 * @param OriginLocation Starting point for the search
@@ -36,7 +105,9 @@ public:
 	bool GetRandomSurfaceLocation(const FVector& OriginLocation, float Range, FVector& OutLocation, FVector& OutNormal);
 
 	/**
-	 * Move the owner actor toward a target location while maintaining surface attachment
+	 * Move the owner actor toward a target location while maintaining surface attachment.
+	 * When a baked surface navigation graph covers the owner, the move follows an A* route over the graph
+	 * and needs no traces; otherwise it falls back to straight-line movement with surface traces.
 	 * @param TargetLocation The destination to move toward
 	 * @param DeltaTime Time step for this movement update
 	 * @param Speed Movement speed in units per second
@@ -45,12 +116,54 @@ public:
 	UFUNCTION(BlueprintCallable, Category = "Surface Pathfinding")
 	bool MoveTowardsSurfaceLocation(const FVector& TargetLocation, float DeltaTime, float Speed);
 
+	/**
+	 * Find a route over the baked surface navigation graph
+	 * @param StartLocation Where the route starts
+	 * @param EndLocation Where the route should end
+	 * @param OutPathPoints Route waypoints, ending at EndLocation
+	 * @return True if a graph covers both locations and a route was found
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Surface Pathfinding")
+	bool FindSurfacePath(const FVector& StartLocation, const FVector& EndLocation, TArray<FVector>& OutPathPoints) const;
+
+	/**
+	 * Check if the owner is currently following a route over the surface navigation graph
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Surface Pathfinding")
+	bool IsFollowingSurfacePath() const { return bIsFollowingSurfacePath; }
+
 	/**
 	 * Check if the owner is currently attached to a valid surface
 	 */
 	UFUNCTION(BlueprintCallable, Category = "Surface Pathfinding")
 	bool IsOnValidSurface() const;
 
+	/**
+	 * Drop the cached surface contact so the next surface detection traces again,
+	 * e.g. after moving geometry the cache can't see (a different component appearing closer)
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Surface Pathfinding")
+	void InvalidateSurfaceContactCache();
+
+	/**
+	 * Called by USurfaceQuerySubsystem to hand back the result of a batched query
+	 */
+	void ReceiveSurfaceQueryResult(const FSurfaceQueryResult& Result);
+
+	/**
+	 * Whether GetRandomSurfaceLocation returned false because its batched query is still in flight, or because
+	 * this frame's trace budget is spent, rather than because no surface was found; asking again later gets an answer
+	 */
+	bool IsRandomSurfaceLocationPending() const { return bIsRandomLocationPending || RandomLocationDeferredFrame == GFrameCounter; }
+
+	/**
+	 * Get the surface the owner was last in contact with, even if it has lost it since
+	 * @param OutLocation Where the surface was last found
+	 * @param OutNormal Its normal there
+	 * @return False if the owner has never found a surface
+	 */
+	bool GetLastKnownSurface(FVector& OutLocation, FVector& OutNormal) const;
+
 	/**
 	 * Get the current surface normal the actor is attached to
 	 */
@@ -87,6 +200,74 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding")
 	float AcceptanceRadius;
 
+	/**
+	 * Whether to route crawling moves over a baked ASurfaceNavGraph when one covers the owner
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding|Navigation Graph")
+	bool bUseSurfaceNavGraph;
+
+	/**
+	 * Pick random surface locations from the level's surface point cloud (USurfacePointCloudSubsystem)
+	 * instead of random rays, once the cloud is built. Each candidate point costs one line of sight trace.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding|Performance")
+	bool bUseSurfacePointCloud;
+
+	/**
+	 * How surface traces are issued. Async queues them through the world's async trace interface,
+	 * Batched hands them to USurfaceQuerySubsystem; both consume the results on the next frame
+	 * and extrapolate the last contact in between.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding|Performance")
+	ESurfaceTraceMode TraceMode;
+
+	/**
+	 * Answer surface detection from the sparse distance field of static geometry (USurfaceDistanceFieldSubsystem)
+	 * instead of traces. Falls back to TraceMode wherever the field is not built yet. Movable objects are not seen.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding|Performance")
+	bool bUseDistanceField;
+
+	/**
+	 * Reuse the last surface contact while the owner stays put, so idle and stopped monsters don't trace.
+	 * The contact is re-queried once the owner moves or rotates past the thresholds below,
+	 * or when the hit component moves or stops blocking traces.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding|Performance")
+	bool bUseSurfaceContactCache;
+
+	/**
+	 * Distance the owner can move before the cached contact is re-queried
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding|Performance", meta = (ClampMin = "0.0", EditCondition = "bUseSurfaceContactCache"))
+	float SurfaceCacheMoveThreshold;
+
+	/**
+	 * Angle (degrees) the owner can rotate before the cached contact is re-queried
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding|Performance", meta = (ClampMin = "0.0", EditCondition = "bUseSurfaceContactCache"))
+	float SurfaceCacheRotationThreshold;
+
+	/**
+	 * Seconds after which the cached contact is re-queried anyway, to pick up geometry the cache can't watch (0 = never)
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding|Performance", meta = (ClampMin = "0.0", EditCondition = "bUseSurfaceContactCache"))
+	float SurfaceCacheMaxAge;
+
+	/**
+	 * Minimum seconds between surface detection traces while tracking the current surface; in between, the owner
+	 * follows the plane of the last contact (0 = trace every tick). Set by the monster's AI LOD tier.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding|Performance", meta = (ClampMin = "0.0"))
+	float SurfaceTraceInterval;
+
+	/**
+	 * Whether the owner's rotation follows the surface. Turned off by the simulation-only AI LOD tier,
+	 * where nobody sees the monster; alignment catches up smoothly once it is back on.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Surface Pathfinding|Performance")
+	bool bAlignToSurface;
+
 protected:
 	/**
 	 * Detect the nearest surface below/around the given location
@@ -97,6 +278,70 @@ protected:
 	 */
 	bool DetectSurface(const FVector& Location, FVector& OutHitLocation, FVector& OutHitNormal);
 
+	/**
+	 * Score a surface hit for DetectSurface: closer surfaces and surfaces aligned with the current one score higher
+	 * @param Origin Point the trace started from
+	 * @param HitResult The surface hit
+	 * @return Score in [0, 1]
+	 */
+	float ScoreSurfaceHit(const FVector& Origin, const FHitResult& HitResult) const;
+
+	/**
+	 * Find the nearest static surface with a distance field lookup
+	 * @param Location Point to check from
+	 * @param bOutFoundSurface Whether a surface lies within SurfaceDetectionRange
+	 * @param OutHitLocation Where the surface is, offset like DetectSurface results
+	 * @param OutHitNormal Surface normal (distance gradient)
+	 * @return False if the field can't answer here and the caller should trace
+	 */
+	bool SampleDistanceFieldSurface(const FVector& Location, bool& bOutFoundSurface, FVector& OutHitLocation, FVector& OutHitNormal);
+
+	/**
+	 * Check whether the cached contact still describes the surface around a location
+	 * @param Location Point surface detection is run from
+	 * @return True if the cached contact can be used instead of tracing
+	 */
+	bool IsSurfaceContactCacheValid(const FVector& Location) const;
+
+	/**
+	 * Remember a traced contact for IsSurfaceContactCacheValid
+	 * @param QueryLocation Point the contact was traced from
+	 * @param Contact The traced contact
+	 */
+	void CacheSurfaceContact(const FVector& QueryLocation, const FSurfaceContact& Contact);
+
+	/** Whether SurfaceTraceInterval allows new surface detection traces */
+	bool IsSurfaceTraceDue() const;
+
+	/** Count traces against the per-frame AI budget */
+	void ReportTraces(int32 NumTraces);
+
+	/** Pick the surface up again on activation: from the contact cache, the character's floor, or one detection */
+	void WarmStartSurfaceTracking();
+
+	/** Tick only while tracking is active and UMonsterTickManager isn't updating us */
+	void UpdateComponentTickEnabled();
+
+	/**
+	 * Trace ahead of the owner along its movement direction.
+	 * In async mode this returns the result of the trace queued on the previous frame and queues a new one.
+	 * @return True if a blocking hit was found
+	 */
+	bool TraceForward(const FVector& TraceStart, const FVector& TraceEnd, FHitResult& OutHit);
+
+	/**
+	 * Async/Batched mode surface tracking: consume last frame's results, queue this frame's, and align to the latest contact
+	 * @param DeltaTime Time step
+	 */
+	void UpdateSurfaceDeferred(float DeltaTime);
+
+	/**
+	 * Queue a query with the surface query service
+	 * @param Request Query to submit; requester and collision params are filled in
+	 * @return False if the service is unavailable and the caller should trace itself
+	 */
+	bool SubmitSurfaceQuery(FSurfaceQueryRequest& Request);
+
 	/**
 	 * Smoothly align the actor's rotation to match the surface normal
 	 * @param TargetNormal The surface normal to align with
@@ -104,10 +349,61 @@ protected:
 	 */
 	void AlignToSurface(const FVector& TargetNormal, float DeltaTime);
 
+	/**
+	 * Rotation one alignment step towards a surface normal takes the owner to
+	 * @param TargetNormal The surface normal to align with
+	 * @param DeltaTime Time step
+	 * @return The owner's current rotation when alignment is off
+	 */
+	FRotator GetAlignedRotation(const FVector& TargetNormal, float DeltaTime) const;
+
+	/**
+	 * Finish a crawl step: place the owner on the surface it resolved and turn it towards the normal
+	 * in a single transform update, and remember the contact so this frame's surface tracking has nothing left to do
+	 * @param Location Where the owner ends up
+	 * @param Normal Normal of the surface there
+	 * @param DeltaTime Time step
+	 */
+	void CommitCrawlStep(const FVector& Location, const FVector& Normal, float DeltaTime);
+
+	/** Tick after the owner's controller, so surface tracking sees the controller's crawl step of the same frame */
+	void AddControllerTickPrerequisite();
+
 	/**
 	 * Check if should attempt a surface transition based on probability
 	 */
-	bool ShouldAttemptSurfaceTransition() const;
+	bool ShouldAttemptSurfaceTransition();
+
+	/** Random stream of the owning monster, or of this component if the owner isn't a monster */
+	FRandomStream& GetRandomStream();
+
+	/**
+	 * Compute a graph route from the owner's location to the target and start following it
+	 * @param TargetLocation Final destination of the route
+	 * @return True if a route was found
+	 */
+	bool BuildSurfacePathTo(const FVector& TargetLocation);
+
+	/**
+	 * Advance the owner along the current graph route, sweeping each leg it covers; a blocked leg
+	 * ends the route and the rest of the way is crawled with traces
+	 * @param TargetLocation Final destination of the route
+	 * @param DeltaTime Time step
+	 * @param Speed Movement speed in units per second
+	 */
+	void FollowSurfacePath(const FVector& TargetLocation, float DeltaTime, float Speed);
+
+	/**
+	 * Sweep a route leg against geometry the graph bake didn't see (dynamic blockers, later changes)
+	 * @return True if nothing blocks the leg
+	 */
+	bool IsSurfacePathSegmentClear(const FVector& Start, const FVector& End);
+
+	/** Drop the current graph route */
+	void ClearSurfacePath();
+
+	/** Whether the owner's UMonsterMovementComponent is crawling, so it moves the owner and tracks the surface */
+	bool IsCrawlMovementActive() const;
 
 private:
 	/** Currently tracked surface normal */
@@ -119,4 +415,106 @@ private:
 	/** Cached reference to the owner actor */
 	UPROPERTY()
 	AActor* CachedOwner;
+
+	/** Owner as a monster, whose random stream is used, if it is one */
+	UPROPERTY()
+	AMonsterCharacter* CachedMonsterOwner;
+
+	/** Movement component of the owner, if it has a crawl mode */
+	UPROPERTY()
+	UMonsterMovementComponent* CrawlMovement;
+
+	/** Random stream used when the owner isn't a monster */
+	FRandomStream OwnRandomStream;
+
+	/** Latest surface contact, used to extrapolate between async trace results */
+	FSurfaceContact LastContact;
+
+	/** Whether LastContact has ever been valid; its location and normal are kept when the surface is lost */
+	bool bHasKnownSurface;
+
+	/** Last traced contact, reused while the owner stays put (bUseSurfaceContactCache) */
+	FSurfaceContactCache SurfaceContactCache;
+
+	/** World time surface tracking last traced or queued surface detection */
+	float LastSurfaceTraceTime;
+
+	/** Surface detection traces queued last frame (async mode) */
+	TArray<FTraceHandle, TInlineAllocator<6>> PendingSurfaceTraces;
+
+	/** Origin of the queued surface detection traces (async mode) */
+	FVector PendingSurfaceTraceOrigin;
+
+	/** Frame the surface detection traces were queued on (async mode) */
+	uint64 PendingSurfaceTraceFrame;
+
+	/** Forward trace queued last frame (async mode) */
+	FTraceHandle PendingForwardTrace;
+
+	/** Frame the forward trace was queued on (async mode) */
+	uint64 PendingForwardTraceFrame;
+
+	/** Surface query service used in batched mode */
+	UPROPERTY()
+	USurfaceQuerySubsystem* SurfaceQueryService;
+
+	/** Point cloud used when bUseSurfacePointCloud is set */
+	UPROPERTY()
+	USurfacePointCloudSubsystem* SurfacePointCloud;
+
+	/** Distance field used when bUseDistanceField is set */
+	UPROPERTY()
+	USurfaceDistanceFieldSubsystem* DistanceField;
+
+	/** Whether the owner's controller has been ordered after the query batch */
+	bool bHasControllerBatchPrerequisite;
+
+	/** Latest batched results; FSurfaceQueryResult::Frame is reset to 0 once a result has been consumed */
+	FSurfaceQueryResult LatestDetectResult;
+	FSurfaceQueryResult LatestRandomLocationResult;
+	FSurfaceQueryResult LatestForwardResult;
+
+	/** Whether a batched random location query is in flight */
+	bool bIsRandomLocationPending;
+
+	/** Whether surface tracking is running (see SetSurfaceTrackingActive) */
+	bool bSurfaceTrackingActive;
+
+	/** Whether UMonsterTickManager calls UpdateSurfaceTracking instead of our tick */
+	bool bIsTickManaged;
+
+	/** Frame a random location search last waited for trace budget on */
+	uint64 RandomLocationDeferredFrame;
+
+	/** Per-frame AI budget the traces are counted against */
+	UPROPERTY()
+	UMonsterBudgetSubsystem* BudgetSubsystem;
+
+	/** Baked surface graph covering the owner, if any */
+	UPROPERTY()
+	ASurfaceNavGraph* SurfaceNavGraph;
+
+	/** Node indices of the route currently being followed */
+	TArray<int32> SurfacePathNodes;
+
+	/** Index of the next route node to reach (equal to SurfacePathNodes.Num() for the final target segment) */
+	int32 SurfacePathIndex;
+
+	/** Target the current route (or the last failed route request) was computed for */
+	FVector SurfacePathGoal;
+
+	/** Whether SurfacePathGoal holds a route request, successful or not */
+	bool bHasSurfacePathGoal;
+
+	/** Whether the owner is currently following a graph route */
+	bool bIsFollowingSurfacePath;
+
+	/** World time of the last graph route step, used to notice when the controller stops moving us */
+	float LastSurfacePathTime;
+
+	/** Frame the last crawl step was committed on; surface tracking skips that frame */
+	uint64 CrawlStepFrame;
+
+	/** Whether our tick has been ordered after the owner's controller */
+	bool bHasControllerTickPrerequisite;
 };
@@ -0,0 +1,128 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Async/Future.h"
+#include "Engine/World.h"
+#include "HAL/ThreadSafeBool.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SurfacePointCloudSubsystem.generated.h"
+
+/**
+ * Crawlable surface points of a level with a uniform grid index over them
+ */
+struct FSurfacePointCloud
+{
+	/** Sample locations, offset slightly away from the surface */
+	TArray<FVector> Locations;
+
+	/** Surface normal of each sample */
+	TArray<FVector> Normals;
+
+	/** Grid index: cell -> sample indices */
+	TMap<FIntVector, TArray<int32>> CellPoints;
+
+	/** Edge length of an index cell */
+	float CellSize;
+
+	FSurfacePointCloud()
+		: CellSize(1.0f)
+	{
+	}
+
+	/** Get the index cell containing a location */
+	FIntVector GetCell(const FVector& Location) const
+	{
+		return FIntVector(
+			FMath::FloorToInt(Location.X / CellSize),
+			FMath::FloorToInt(Location.Y / CellSize),
+			FMath::FloorToInt(Location.Z / CellSize));
+	}
+};
+
+/**
+ * Per-level cloud of crawlable surface points, built on a worker thread from the level's static collision
+ * the first time a monster asks it for a point. Random crawl targets are picked from the cloud with a grid lookup
+ * instead of firing random rays, so a target is found whenever any surface lies in range.
+ */
+UCLASS()
+class AURAMONSTER_API USurfacePointCloudSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	USurfacePointCloudSubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Pick a random surface point whose distance from Origin lies in [MinDistance, MaxDistance]
+	 * @param Origin Point to search around
+	 * @param MinDistance Points closer than this are ignored
+	 * @param MaxDistance Points further away than this are ignored
+	 * @param OutLocation The chosen point, offset from the surface like traced locations
+	 * @param OutNormal Surface normal at the chosen point
+	 * @param RandomStream Stream the choice is drawn from
+	 * @return False if the cloud isn't built yet (the first call starts the build) or has no point in range
+	 */
+	bool FindRandomPointInRange(const FVector& Origin, float MinDistance, float MaxDistance, FVector& OutLocation, FVector& OutNormal, FRandomStream& RandomStream);
+
+	/**
+	 * Pick a random surface point in [MinDistance, MaxDistance] that is in line of sight from Origin, so moving
+	 * straight towards it doesn't run into geometry. Points behind walls, floors and ceilings are skipped.
+	 * @param QueryParams Params of the line of sight traces, e.g. ignoring the monster itself
+	 * @param MaxCandidates Most points tried; each costs one trace
+	 * @param OutNumTraces If set, receives the number of traces issued
+	 * @return False if the cloud isn't built yet or none of the candidates was in line of sight
+	 */
+	bool FindVisiblePointInRange(const FVector& Origin, float MinDistance, float MaxDistance, const FCollisionQueryParams& QueryParams, int32 MaxCandidates,
+		FVector& OutLocation, FVector& OutNormal, FRandomStream& RandomStream, int32* OutNumTraces = nullptr);
+
+	/**
+	 * Find the surface point closest to a location
+	 * @param Location Point to search from
+	 * @param MaxDistance Points further away than this are ignored
+	 * @param OutLocation The closest point, offset from the surface like traced locations
+	 * @param OutNormal Surface normal at the closest point
+	 * @return False if the cloud isn't built yet (the first call starts the build) or has no point in range
+	 */
+	bool FindNearestPoint(const FVector& Location, float MaxDistance, FVector& OutLocation, FVector& OutNormal);
+
+	/**
+	 * Sample the level again in the background, e.g. after streaming in new static geometry.
+	 * The current cloud keeps answering queries until the new one is ready.
+	 */
+	UFUNCTION(BlueprintCallable, Category = "Surface Point Cloud")
+	void RebuildPointCloud();
+
+	/** Whether a built cloud is available */
+	UFUNCTION(BlueprintCallable, Category = "Surface Point Cloud")
+	bool IsPointCloudReady();
+
+	/** Number of points in the built cloud */
+	int32 GetNumPoints() const { return PointCloud.IsValid() ? PointCloud->Locations.Num() : 0; }
+
+private:
+	/** Start the first build, once the world's actors are initialized and its static collision is in place */
+	void EnsureBuildStarted();
+
+	/** Pick up the background build result once it is finished */
+	void ConsumeFinishedBuild();
+
+	/** Stop a running background build and wait for it to return */
+	void CancelBuild();
+
+	/** Built cloud; replaced as a whole when a rebuild finishes */
+	TSharedPtr<FSurfacePointCloud, ESPMode::ThreadSafe> PointCloud;
+
+	/** Background build in flight */
+	TFuture<TSharedPtr<FSurfacePointCloud, ESPMode::ThreadSafe>> BuildTask;
+
+	/** Set to abandon the background build */
+	TSharedPtr<FThreadSafeBool, ESPMode::ThreadSafe> BuildCancelFlag;
+
+	/** Whether a build was ever started; worlds nobody asks for points never sample their level */
+	bool bBuildRequested;
+};
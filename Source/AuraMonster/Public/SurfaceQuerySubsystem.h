@@ -0,0 +1,183 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/EngineBaseTypes.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "CollisionQueryParams.h"
+#include "SurfaceQueryTypes.h"
+#include "SurfaceQuerySubsystem.generated.h"
+
+class USurfaceQuerySubsystem;
+class USurfacePathfindingComponent;
+
+/**
+ * Kind of surface query a component can submit
+ */
+enum class ESurfaceQueryType : uint8
+{
+	/** Nearest surface around a point (DetectSurface) */
+	DetectSurface,
+
+	/** Random surface location within a range (GetRandomSurfaceLocation) */
+	RandomLocation,
+
+	/** Single trace ahead of the monster (MoveTowardsSurfaceLocation) */
+	ForwardTrace
+};
+
+/**
+ * A surface query waiting for the next batch
+ */
+struct FSurfaceQueryRequest
+{
+	/** Component the result is handed back to */
+	TWeakObjectPtr<USurfacePathfindingComponent> Requester;
+
+	/** What to trace */
+	ESurfaceQueryType Type;
+
+	/** Trace origin */
+	FVector Origin;
+
+	/** Trace end (ForwardTrace only) */
+	FVector End;
+
+	/** Detection range (DetectSurface) or search range (RandomLocation) */
+	float Range;
+
+	/** Maximum number of rays (RandomLocation only) */
+	int32 MaxAttempts;
+
+	/** Seed for the random rays (RandomLocation only) */
+	int32 RandomSeed;
+
+	/** Whether CurrentNormal is meaningful for scoring (DetectSurface only) */
+	bool bHasCurrentSurface;
+
+	/** Normal of the surface the requester is on (DetectSurface only) */
+	FVector CurrentNormal;
+
+	/** Collision params, built on the game thread at submit time */
+	FCollisionQueryParams QueryParams;
+
+	FSurfaceQueryRequest()
+		: Type(ESurfaceQueryType::DetectSurface)
+		, Origin(FVector::ZeroVector)
+		, End(FVector::ZeroVector)
+		, Range(0.0f)
+		, MaxAttempts(0)
+		, RandomSeed(0)
+		, bHasCurrentSurface(false)
+		, CurrentNormal(FVector::UpVector)
+	{
+	}
+};
+
+/**
+ * Result of a batched surface query
+ */
+struct FSurfaceQueryResult
+{
+	/** Query type this result answers */
+	ESurfaceQueryType Type;
+
+	/** Origin of the query, lets the requester judge how stale the answer is */
+	FVector Origin;
+
+	/** Found surface; bIsValid is false on a miss */
+	FSurfaceContact Contact;
+
+	/** Frame the batch ran on */
+	uint64 Frame;
+
+	/** Traces the query actually issued (RandomLocation stops at the first hit) */
+	int32 NumTraces;
+
+	FSurfaceQueryResult()
+		: Type(ESurfaceQueryType::DetectSurface)
+		, Origin(FVector::ZeroVector)
+		, Frame(0)
+		, NumTraces(0)
+	{
+	}
+};
+
+/**
+ * Tick function that runs the surface query batch at the start of the frame
+ */
+USTRUCT()
+struct FSurfaceQueryBatchTickFunction : public FTickFunction
+{
+	GENERATED_BODY()
+
+	/** Subsystem that owns the batch */
+	USurfaceQuerySubsystem* Target;
+
+	FSurfaceQueryBatchTickFunction()
+		: Target(nullptr)
+	{
+	}
+
+	virtual void ExecuteTick(float DeltaTime, ELevelTick TickType, ENamedThreads::Type CurrentThread, const FGraphEventRef& MyCompletionGraphEvent) override;
+	virtual FString DiagnosticMessage() override;
+};
+
+template<>
+struct TStructOpsTypeTraits<FSurfaceQueryBatchTickFunction> : public TStructOpsTypeTraitsBase2<FSurfaceQueryBatchTickFunction>
+{
+	enum
+	{
+		WithCopy = false
+	};
+};
+
+/**
+ * Surface query service: collects every surface trace request of the frame from all monsters,
+ * sorts them spatially and executes them as one batch (in parallel when worthwhile).
+ * The batch runs at the start of the next frame's pre-physics group; requesters and their
+ * controllers tick after it, so results are in place before any movement step.
+ */
+UCLASS()
+class AURAMONSTER_API USurfaceQuerySubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	USurfaceQuerySubsystem();
+
+	virtual bool ShouldCreateSubsystem(UObject* Outer) const override;
+	virtual void Deinitialize() override;
+
+	/**
+	 * Queue a query for the next batch
+	 * @param Request The query; the result is handed back to Request.Requester
+	 */
+	void SubmitQuery(const FSurfaceQueryRequest& Request);
+
+	/**
+	 * Make a tick function run after the batch, so it sees this frame's results
+	 * @param TickFunction Tick function of a requester or of whatever drives its movement
+	 */
+	void AddBatchPrerequisite(FTickFunction& TickFunction);
+
+	/** Number of queries executed by the last batch */
+	int32 GetLastBatchSize() const { return LastBatchSize; }
+
+	/** Execute every queued query and deliver the results */
+	void ExecuteBatch();
+
+private:
+	/** Register the batch tick function with the world, once */
+	void RegisterBatchTickFunction();
+
+	/** Queries waiting for the next batch */
+	TArray<FSurfaceQueryRequest> PendingRequests;
+
+	/** Tick function that runs ExecuteBatch */
+	FSurfaceQueryBatchTickFunction BatchTickFunction;
+
+	/** Number of queries executed by the last batch */
+	int32 LastBatchSize;
+};
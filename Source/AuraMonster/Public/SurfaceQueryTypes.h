@@ -0,0 +1,70 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "SurfaceQueryTypes.generated.h"
+
+class UPrimitiveComponent;
+
+/**
+ * How USurfacePathfindingComponent issues its surface traces
+ */
+UENUM(BlueprintType)
+enum class ESurfaceTraceMode : uint8
+{
+	/** Blocking traces on the game thread, results are used immediately */
+	Synchronous UMETA(DisplayName = "Synchronous"),
+
+	/** Traces are queued through the world's async trace interface and consumed on the next frame */
+	Async UMETA(DisplayName = "Async"),
+
+	/** Traces are handed to USurfaceQuerySubsystem, executed in one batch with every other monster's and consumed on the next frame */
+	Batched UMETA(DisplayName = "Batched")
+};
+
+/**
+ * Last known contact between a monster and the surface it is crawling on
+ */
+USTRUCT(BlueprintType)
+struct AURAMONSTER_API FSurfaceContact
+{
+	GENERATED_BODY()
+
+	/** Contact location, offset slightly away from the surface */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Pathfinding")
+	FVector Location;
+
+	/** Surface normal at the contact */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Pathfinding")
+	FVector Normal;
+
+	/** Whether this contact holds valid data */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Pathfinding")
+	bool bIsValid;
+
+	/** Distance from the query origin to the surface */
+	UPROPERTY(BlueprintReadOnly, Category = "Surface Pathfinding")
+	float Distance;
+
+	/** Component that was hit, if known; lets cached contacts notice when it moves or stops colliding */
+	TWeakObjectPtr<UPrimitiveComponent> HitComponent;
+
+	FSurfaceContact()
+		: Location(FVector::ZeroVector)
+		, Normal(FVector::UpVector)
+		, bIsValid(false)
+		, Distance(0.0f)
+	{
+	}
+
+	/**
+	 * Project a point onto the contact plane, i.e. extrapolate where the contact would be for that point
+	 * @param Point Point to project
+	 * @return The point moved along the normal so it lies at the contact's offset from the surface
+	 */
+	FVector ProjectOntoPlane(const FVector& Point) const
+	{
+		return Point - Normal * FVector::DotProduct(Point - Location, Normal);
+	}
+};